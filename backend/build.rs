@@ -4,6 +4,10 @@
 // Compiles sinyalist_packet.proto into Rust types at build time.
 // In development, we define types manually in main.rs for faster iteration.
 // Enable this for production builds.
+//
+// C5: SINYALIST_CORE_DIR (the directory holding libsinyalist_core.a, from
+// the NDK sources' host CMake build) links the phone's detector and enables
+// src/native.rs (cfg sinyalist_core).
 // =============================================================================
 
 fn main() {
@@ -11,4 +15,14 @@ fn main() {
     // prost_build::compile_protos(&["../proto/sinyalist_packet.proto"], &["../proto/"])
     //     .expect("Failed to compile protobuf definitions");
     println!("cargo:rerun-if-changed=../proto/sinyalist_packet.proto");
+
+    println!("cargo:rustc-check-cfg=cfg(sinyalist_core)");
+    println!("cargo:rerun-if-env-changed=SINYALIST_CORE_DIR");
+    if let Ok(dir) = std::env::var("SINYALIST_CORE_DIR") {
+        println!("cargo:rustc-link-search=native={dir}");
+        println!("cargo:rustc-link-lib=static=sinyalist_core");
+        let cxx = if std::env::var("CARGO_CFG_TARGET_VENDOR").as_deref() == Ok("apple") { "c++" } else { "stdc++" };
+        println!("cargo:rustc-link-lib={cxx}");
+        println!("cargo:rustc-cfg=sinyalist_core");
+    }
 }
@@ -6,6 +6,8 @@
 //   C2: Strict Ed25519 verification (REQUIRED, not optional)
 //   C3: Confidence scoring tested — dedup does NOT inflate
 //   C4: Structured logs + counters for all drop/accept paths
+//   C5: Native waveform re-verification with the phone's detector (native.rs,
+//       opt-in at build time via SINYALIST_CORE_DIR)
 // =============================================================================
 
 use axum::{Router, extract::State, http::{StatusCode, HeaderMap, HeaderValue}, response::IntoResponse, routing::{get, post}, Json};
@@ -21,6 +23,11 @@ use tower::ServiceBuilder;
 use tower_http::{compression::CompressionLayer, trace::TraceLayer};
 use tracing::{info, warn, error, instrument};
 
+// Not called from ingest() yet: SinyalistPacket carries no waveform field.
+#[cfg(sinyalist_core)]
+#[allow(dead_code)]
+mod native;
+
 // Proto types (matches sinyalist_packet.proto v2)
 pub mod proto {
     #[derive(Clone, Copy, Debug, PartialEq, Eq, Hash, prost::Enumeration)]
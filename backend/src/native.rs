@@ -0,0 +1,244 @@
+// =============================================================================
+// SINYALIST — Native waveform verification (libsinyalist_core.a)
+// =============================================================================
+// Safe wrapper over the verifier C ABI in sinyalist_detector.h: a reported
+// waveform is re-run through the phone's own detector, so sta_lta_ratio,
+// peak_accel_g and dominant_freq_hz no longer have to be taken on trust.
+// Coincidence wraps the C23 trigger index the mesh layer runs: reports
+// cluster only with other devices nearby whose arrival times one P-wave
+// front allows. Built only when build.rs finds SINYALIST_CORE_DIR (cfg
+// sinyalist_core).
+//
+// A Verifier or Coincidence owns all of its native state: give each worker
+// thread its own (Send, not Sync) and reuse it across packets.
+// =============================================================================
+
+use std::ptr::NonNull;
+
+/// One detector decision, `sinyalist_event` in sinyalist_detector.h.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct Record {
+    pub time_ms: i64,
+    pub peak_g: f32,
+    pub sta_lta: f32,
+    pub freq_hz: f32,
+    pub duration: u32,
+    /// AlertLevel 1..4 for an event, 0 for a rejected candidate.
+    pub level: u8,
+    /// RejectCode: 0 event, 1 axis coherence, 2 frequency, 3 periodicity,
+    /// 4 energy distribution.
+    pub reject: u8,
+    _pad: [u8; 6],
+}
+
+impl Record {
+    pub fn is_event(&self) -> bool { self.reject == 0 }
+}
+
+/// Cluster state after one report, `sinyalist_cluster` in sinyalist_detector.h.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default, PartialEq)]
+pub struct Cluster {
+    /// Consistent neighbourhood, this report included.
+    pub devices: u32,
+    /// Largest neighbourhood the report belongs to.
+    pub cluster: u32,
+    /// Of `cluster`, on the GeoCluster::confidence scale.
+    pub confidence: f32,
+    /// 1: the device had already reported and was not counted again.
+    pub repeat: u8,
+    _pad: [u8; 3],
+    /// Earliest consistent arrival.
+    pub first_ms: i64,
+}
+
+#[repr(C)]
+struct RawVerifier { _opaque: [u8; 0] }
+#[repr(C)]
+struct RawCoincidence { _opaque: [u8; 0] }
+
+extern "C" {
+    fn sinyalist_verifier_new(config: *const f32, n: i32, fixed_point: i32) -> *mut RawVerifier;
+    fn sinyalist_verifier_free(v: *mut RawVerifier);
+    fn sinyalist_verify(v: *mut RawVerifier, xyz: *const f32, n: usize, t0_ms: u64,
+                        out: *mut Record, cap: usize) -> i32;
+    fn sinyalist_verify_waveform(v: *mut RawVerifier, image: *const u8, bytes: usize, t0_ms: u64,
+                                 out: *mut Record, cap: usize) -> i32;
+    fn sinyalist_coincidence_new(radius_km: f32, capacity: u32) -> *mut RawCoincidence;
+    fn sinyalist_coincidence_free(c: *mut RawCoincidence);
+    fn sinyalist_coincidence_insert(c: *mut RawCoincidence, lat_e7: i32, lon_e7: i32, t_ms: i64,
+                                    device: u64, out: *mut Cluster) -> u32;
+    fn sinyalist_coincidence_reset(c: *mut RawCoincidence);
+}
+
+pub struct Verifier {
+    raw: NonNull<RawVerifier>,
+    out: Vec<Record>,
+}
+
+// The native verifier has no shared or thread-local state.
+unsafe impl Send for Verifier {}
+
+impl Verifier {
+    /// `config` in SeismicConfig.kt order (empty = 50 Hz defaults);
+    /// `fixed_point` selects the armeabi-v7a integer core. None if the
+    /// sample rate is not 50, 100 or 200 Hz.
+    pub fn new(config: &[f32], fixed_point: bool) -> Option<Self> {
+        let raw = unsafe { sinyalist_verifier_new(config.as_ptr(), config.len() as i32, fixed_point as i32) };
+        NonNull::new(raw).map(|raw| Self { raw, out: vec![Record::default(); 8] })
+    }
+
+    /// Interleaved xyz samples in g at the configured rate, the first at `t0_ms`.
+    pub fn verify(&mut self, xyz: &[f32], t0_ms: u64) -> Option<&[Record]> {
+        let (p, n) = (xyz.as_ptr(), xyz.len() / 3);
+        let raw = self.raw.as_ptr();
+        self.run(|out, cap| unsafe { sinyalist_verify(raw, p, n, t0_ms, out, cap) })
+    }
+
+    /// A packed waveform image (Steim-2, `sinyalist_waveform_pack`).
+    pub fn verify_waveform(&mut self, image: &[u8], t0_ms: u64) -> Option<&[Record]> {
+        let (p, n) = (image.as_ptr(), image.len());
+        let raw = self.raw.as_ptr();
+        self.run(|out, cap| unsafe { sinyalist_verify_waveform(raw, p, n, t0_ms, out, cap) })
+    }
+
+    // Re-runs once with room for every record if the first pass ran out.
+    fn run(&mut self, f: impl Fn(*mut Record, usize) -> i32) -> Option<&[Record]> {
+        let mut n = f(self.out.as_mut_ptr(), self.out.len());
+        if n < 0 { return None; }
+        if n as usize > self.out.len() {
+            self.out.resize(n as usize, Record::default());
+            n = f(self.out.as_mut_ptr(), self.out.len());
+        }
+        Some(&self.out[..n as usize])
+    }
+}
+
+impl Drop for Verifier {
+    fn drop(&mut self) { unsafe { sinyalist_verifier_free(self.raw.as_ptr()) } }
+}
+
+pub struct Coincidence { raw: NonNull<RawCoincidence> }
+
+// As Verifier: no shared or thread-local native state.
+unsafe impl Send for Coincidence {}
+
+impl Coincidence {
+    /// `radius_km` <= 0 and `capacity` 0 keep the defaults (20 km, 16384 reports).
+    pub fn new(radius_km: f32, capacity: u32) -> Option<Self> {
+        NonNull::new(unsafe { sinyalist_coincidence_new(radius_km, capacity) }).map(|raw| Self { raw })
+    }
+
+    /// None for coordinates off the globe or a timestamp before 1970.
+    pub fn insert(&mut self, lat_e7: i32, lon_e7: i32, t_ms: u64, device: u64) -> Option<Cluster> {
+        let mut c = Cluster::default();
+        let t_ms = i64::try_from(t_ms).ok()?;
+        let n = unsafe { sinyalist_coincidence_insert(self.raw.as_ptr(), lat_e7, lon_e7, t_ms, device, &mut c) };
+        (n > 0).then_some(c)
+    }
+
+    pub fn reset(&mut self) { unsafe { sinyalist_coincidence_reset(self.raw.as_ptr()) } }
+}
+
+impl Drop for Coincidence {
+    fn drop(&mut self) { unsafe { sinyalist_coincidence_free(self.raw.as_ptr()) } }
+}
+
+/// The device id the mesh layer uses: the first 8 bytes of the Ed25519
+/// public key, little-endian (TriggerCoincidence.kt).
+pub fn device_id(public_key: &[u8]) -> Option<u64> {
+    public_key.get(..8).map(|b| u64::from_le_bytes(b.try_into().unwrap()))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    // Quiet phone lying face-up: ±1 mg noise on a 1 g z axis, 50 Hz.
+    fn quiet(seconds: usize) -> Vec<f32> {
+        let mut seed = 1u32;
+        let mut noise = || { seed = seed.wrapping_mul(1664525).wrapping_add(1013904223); (seed >> 8) as f32 / 16777216.0 * 0.002 - 0.001 };
+        (0..seconds * 50).flat_map(|_| [noise(), noise(), -1.0 + noise()]).collect()
+    }
+
+    #[test]
+    fn test_record_layout_matches_c() {
+        assert_eq!(std::mem::size_of::<Record>(), 32);
+    }
+
+    #[test]
+    fn test_quiet_waveform_has_no_events() {
+        for fixed in [false, true] {
+            let mut v = Verifier::new(&[], fixed).expect("verifier");
+            assert_eq!(v.verify(&quiet(60), 1_700_000_000_000).map(|r| r.len()), Some(0));
+        }
+    }
+
+    #[test]
+    fn test_empty_and_damaged_input_rejected() {
+        let mut v = Verifier::new(&[50.0], false).expect("verifier");
+        assert!(v.verify(&[], 0).is_none());
+        assert!(v.verify_waveform(&[0u8; 24], 0).is_none());
+        assert!(v.verify_waveform(b"SWZ1", 0).is_none());
+    }
+
+    #[test]
+    fn test_unsupported_rate_rejected() {
+        for hz in [30.0, 400.0] {
+            assert!(Verifier::new(&[hz], false).is_none());
+        }
+        assert!(Verifier::new(&[200.0], true).is_some());
+    }
+
+    #[test]
+    fn test_verifiers_run_in_parallel() {
+        let xyz = std::sync::Arc::new(quiet(30));
+        let workers: Vec<_> = (0..4).map(|_| {
+            let xyz = xyz.clone();
+            std::thread::spawn(move || {
+                let mut v = Verifier::new(&[], false).expect("verifier");
+                (0..5).all(|_| v.verify(&xyz, 0).map_or(false, |r| r.is_empty()))
+            })
+        }).collect();
+        assert!(workers.into_iter().all(|w| w.join().unwrap()));
+    }
+
+    #[test]
+    fn test_cluster_layout_matches_c() {
+        assert_eq!(std::mem::size_of::<Cluster>(), 24);
+    }
+
+    // P-wave from 41.0N 29.0E at 6 km/s reaching phones on a 5..25 km ring.
+    #[test]
+    fn test_quake_front_clusters() {
+        let mut c = Coincidence::new(0.0, 0).expect("index");
+        let t0 = 1_700_000_000_000u64;
+        let mut last = Cluster::default();
+        for i in 0..20u64 {
+            let (d, a) = (5.0 + i as f64, i as f64 * 0.7);
+            let lat = 41.0 + d / 111.195 * a.sin();
+            let lon = 29.0 + d / (111.195 * 41f64.to_radians().cos()) * a.cos();
+            last = c.insert((lat * 1e7) as i32, (lon * 1e7) as i32, t0 + (d / 6.0 * 1000.0) as u64, 100 + i).unwrap();
+        }
+        assert!(last.devices > 3 && last.confidence > 0.7, "{last:?}");
+        // Relays of a device's report never add to the cluster.
+        let again = c.insert(410000000, 290000000, t0 + 2000, 100).unwrap();
+        assert_eq!(again.repeat, 1);
+        assert_eq!(c.insert(410000000, 290000000, t0 + 2100, 100).unwrap().devices, again.devices);
+    }
+
+    #[test]
+    fn test_incoherent_triggers_stay_alone() {
+        let mut c = Coincidence::new(0.0, 0).expect("index");
+        let t0 = 1_700_000_000_000u64;
+        assert_eq!(c.insert(410000000, 290000000, t0, 1).unwrap().devices, 1);
+        // Next door, but 30 s later: no P-wave front does that.
+        assert_eq!(c.insert(410010000, 290010000, t0 + 30_000, 2).unwrap().devices, 1);
+        // Same second, 500 km away.
+        assert_eq!(c.insert(399000000, 328000000, t0 + 200, 3).unwrap().devices, 1);
+        assert!(c.insert(910000000, 0, t0, 4).is_none());
+        c.reset();
+        assert_eq!(c.insert(410000000, 290000000, t0, 2).unwrap().devices, 1);
+    }
+}
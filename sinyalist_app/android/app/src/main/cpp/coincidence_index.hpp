@@ -0,0 +1,239 @@
+// =============================================================================
+// SINYALIST — CoincidenceIndex: geo-temporal clustering of device triggers
+// =============================================================================
+// C23: after a real quake thousands of phones report within seconds; one
+// dropped phone reports alone. A trigger counts towards a cluster only with
+// triggers from other devices that are both near it and consistent with one
+// P-wave front: for a common source, arrivals at a and b can differ by at
+// most |a-b| / v_p, plus clock and detector latency slack.
+//
+//   bucket   geohash-style Z-order cell (lat/lon cells about radius_km wide)
+//            × time slice (the longest consistent arrival gap), hashed into
+//            a power-of-two head table; entries chain newest first
+//   arena    fixed ring of the last `capacity` triggers; an entry is dropped
+//            by being overwritten, so insert never allocates or deletes and
+//            chains stop at the first overwritten link (sequence mismatch)
+//   query    the 3 × (3..) cells and 3 slices around a trigger cover every
+//            trigger within radius_km and the arrival gap
+//
+// insert() is O(neighbours): each consistent neighbour from another device
+// adds one to both supports at once, so cluster size is kept incrementally
+// instead of rescanning recent reports per packet. A device reporting again
+// within twice the arrival gap (a detrigger, a mesh echo) is answered from
+// its earlier trigger and never counted twice. Arrival order is free: late
+// mesh deliveries cluster the same as live ones.
+//
+// Not thread-safe; the mesh layer and each backend worker own one.
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sinyalist::seismic {
+
+struct CoincidenceConfig {
+    float radius_km = 20.f;          // neighbourhood of one trigger
+    float vp_km_s = 6.0f;            // crustal P-wave speed
+    uint32_t slack_ms = 1500;        // phone clock skew + detector latency
+    uint32_t capacity = 16384;       // triggers kept (power of two, rounded up)
+
+    // Largest arrival gap two consistent triggers can have.
+    uint32_t max_gap_ms() const { return uint32_t(radius_km / vp_km_s * 1000.f) + slack_ms; }
+};
+
+struct Coincidence {
+    uint32_t devices = 0;       // this trigger's consistent neighbourhood, itself included
+    uint32_t cluster = 0;       // largest neighbourhood it belongs to after the update
+    float confidence = 0.f;     // of cluster, on the backend GeoCluster scale
+    uint64_t first_ms = 0;      // earliest consistent arrival
+    bool repeat = false;        // device already reported; answered from that trigger
+};
+
+// Backend C3 log scale: 1 device 0.33, 3 → 0.70, 7 → 0.98, 8+ → 1.0.
+inline float coincidence_confidence(uint32_t devices) noexcept {
+    return devices ? std::min((std::log(float(devices)) + 1.f) / 3.f, 1.f) : 0.f;
+}
+
+class CoincidenceIndex {
+public:
+    explicit CoincidenceIndex(const CoincidenceConfig& c = {}) : cfg_(c) {
+        cfg_.radius_km = std::clamp(cfg_.radius_km, 0.1f, 500.f);
+        cfg_.vp_km_s = std::max(cfg_.vp_km_s, 0.1f);
+        uint32_t cap = 64;
+        while (cap < cfg_.capacity && cap < (1u << 24)) cap <<= 1;
+        cfg_.capacity = cap;
+        gap_ms_ = cfg_.max_gap_ms();
+        slice_ms_ = std::max<uint32_t>(gap_ms_, 1);
+        repeat_ms_ = 2 * uint64_t(gap_ms_);
+        // Cells as tall as the radius and, in degrees, as wide: ±1 row and
+        // ±ceil(1/cos lat) columns cover the circle.
+        cell_e7_ = std::max<int32_t>(int32_t(cfg_.radius_km / kKmPerDeg * 1e7f), 1000);
+        cols_ = uint32_t((3600000000ll + cell_e7_ - 1) / cell_e7_);
+        ring_.resize(cap);
+        heads_.resize(2 * size_t(cap));
+        dev_heads_.resize(2 * size_t(cap));
+        reset();
+    }
+
+    const CoincidenceConfig& config() const noexcept { return cfg_; }
+    uint32_t max_gap_ms() const noexcept { return gap_ms_; }
+    // Triggers inserted since reset (repeats excluded).
+    uint64_t inserted() const noexcept { return seq_ - 1; }
+
+    void reset() noexcept {
+        std::fill(heads_.begin(), heads_.end(), 0u);
+        std::fill(dev_heads_.begin(), dev_heads_.end(), 0u);
+        for (Entry& e : ring_) e.seq = 0;
+        seq_ = 1;
+    }
+
+    // device: any stable per-device id (public key hash, user id). Returns
+    // devices 0 for coordinates outside ±90 / ±180 degrees.
+    Coincidence insert(int32_t lat_e7, int32_t lon_e7, uint64_t t_ms, uint64_t device) noexcept {
+        Coincidence r;
+        if (lat_e7 < -900000000 || lat_e7 > 900000000 || lon_e7 < -1800000000 || lon_e7 > 1800000000)
+            return r;
+        if (const Entry* p = find_device(device, t_ms)) {
+            r.devices = p->support + 1;
+            r.cluster = p->best;
+            r.first_ms = p->first_ms;
+            r.confidence = coincidence_confidence(r.cluster);
+            r.repeat = true;
+            return r;
+        }
+
+        const uint32_t s = seq_++;
+        Entry& e = ring_[s & (cfg_.capacity - 1)];
+        e = Entry{};
+        e.lat = lat_e7; e.lon = lon_e7; e.t_ms = t_ms; e.first_ms = t_ms; e.device = device;
+
+        uint32_t cluster = 1;
+        visit(lat_e7, lon_e7, t_ms, [&](Entry& n) {
+            if (n.device == device) return;
+            ++n.support; ++e.support;
+            n.best = std::max(n.best, n.support + 1);
+            cluster = std::max(cluster, n.support + 1);
+            e.first_ms = std::min(e.first_ms, n.t_ms);
+            n.first_ms = std::min(n.first_ms, t_ms);
+        });
+        e.best = std::max(cluster, e.support + 1);
+
+        // Link last: visit() must not meet the new entry.
+        e.seq = s;
+        uint32_t& h = heads_[bucket(row(lat_e7), col(lon_e7), slice(t_ms))];
+        e.next = h; h = s;
+        uint32_t& d = dev_heads_[mix(device) & (dev_heads_.size() - 1)];
+        e.dnext = d; d = s;
+
+        r.devices = e.support + 1;
+        r.cluster = e.best;
+        r.first_ms = e.first_ms;
+        r.confidence = coincidence_confidence(r.cluster);
+        return r;
+    }
+
+private:
+    static constexpr float kKmPerDeg = 111.195f;      // mean Earth radius 6371 km
+    static constexpr float kRadPerDeg = 0.017453292f;
+
+    struct Entry {
+        int32_t lat = 0, lon = 0;
+        uint64_t t_ms = 0, first_ms = 0;
+        uint64_t device = 0;
+        uint32_t seq = 0, next = 0, dnext = 0;   // 0 = none (sequence numbers start at 1)
+        uint32_t support = 0;                     // consistent triggers from other devices
+        uint32_t best = 1;                        // largest neighbourhood it is part of
+    };
+
+    static uint64_t mix(uint64_t x) noexcept {   // splitmix64 finaliser
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27; x *= 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+    // Z-order interleave of the cell indices: nearby cells share key prefixes
+    // like geohash strings do.
+    static uint64_t zorder(uint32_t r, uint32_t c) noexcept {
+        auto spread = [](uint64_t v) {
+            v &= 0xffffffffull;
+            v = (v | v << 16) & 0x0000ffff0000ffffull; v = (v | v << 8) & 0x00ff00ff00ff00ffull;
+            v = (v | v << 4) & 0x0f0f0f0f0f0f0f0full;  v = (v | v << 2) & 0x3333333333333333ull;
+            return (v | v << 1) & 0x5555555555555555ull;
+        };
+        return spread(r) << 1 | spread(c);
+    }
+
+    int64_t row(int32_t lat_e7) const noexcept { return (int64_t(lat_e7) + 900000000) / cell_e7_; }
+    int64_t col(int32_t lon_e7) const noexcept {
+        return ((int64_t(lon_e7) + 1800000000) / cell_e7_) % cols_;
+    }
+    uint64_t slice(uint64_t t_ms) const noexcept { return t_ms / slice_ms_; }
+    size_t bucket(int64_t r, int64_t c, uint64_t sl) const noexcept {
+        return mix(zorder(uint32_t(r), uint32_t(c)) ^ mix(sl)) & (heads_.size() - 1);
+    }
+
+    // The live entry for a sequence number, or null once it was overwritten.
+    Entry* at(uint32_t s) noexcept {
+        if (!s) return nullptr;
+        Entry& e = ring_[s & (cfg_.capacity - 1)];
+        return e.seq == s ? &e : nullptr;
+    }
+
+    const Entry* find_device(uint64_t device, uint64_t t_ms) noexcept {
+        for (Entry* e = at(dev_heads_[mix(device) & (dev_heads_.size() - 1)]); e; e = at(e->dnext)) {
+            if (e->device != device) continue;
+            uint64_t gap = t_ms > e->t_ms ? t_ms - e->t_ms : e->t_ms - t_ms;
+            if (gap <= repeat_ms_) return e;
+        }
+        return nullptr;
+    }
+
+    // Calls f for every live trigger within radius_km whose arrival gap a
+    // P-wave front allows. Chains are filtered by cell and slice, since
+    // hashed buckets can share a head.
+    template<class F>
+    void visit(int32_t lat_e7, int32_t lon_e7, uint64_t t_ms, F&& f) noexcept {
+        const int64_t r0 = row(lat_e7), c0 = col(lon_e7);
+        const uint64_t s0 = slice(t_ms);
+        const float cos_lat = std::cos(float(lat_e7) * 1e-7f * kRadPerDeg);
+        // Columns narrow towards the pole: size the span at the row nearest it.
+        const float far = std::min(std::fabs(float(lat_e7)) + float(cell_e7_), 9e8f) * 1e-7f;
+        const float cos_far = std::max(std::cos(far * kRadPerDeg), 0.02f);
+        const int64_t dc = std::min<int64_t>(int64_t(std::ceil(1.f / cos_far)), cols_ / 2);
+        const int64_t rows = 900000000ll * 2 / cell_e7_;
+        for (uint64_t sl = s0 ? s0 - 1 : 0; sl <= s0 + 1; ++sl)
+        for (int64_t r = std::max<int64_t>(r0 - 1, 0); r <= std::min(r0 + 1, rows); ++r)
+        for (int64_t k = -dc; k <= dc; ++k) {
+            const int64_t c = ((c0 + k) % cols_ + cols_) % cols_;
+            for (Entry* n = at(heads_[bucket(r, c, sl)]); n; n = at(n->next)) {
+                if (slice(n->t_ms) != sl || row(n->lat) != r || col(n->lon) != c) continue;
+                if (consistent(*n, lat_e7, lon_e7, t_ms, cos_lat)) f(*n);
+            }
+        }
+    }
+
+    bool consistent(const Entry& n, int32_t lat_e7, int32_t lon_e7, uint64_t t_ms,
+                    float cos_lat) const noexcept {
+        float dlon = float(int64_t(n.lon) - lon_e7) * 1e-7f;
+        if (dlon > 180.f) dlon -= 360.f; else if (dlon < -180.f) dlon += 360.f;
+        const float dlat = float(int64_t(n.lat) - lat_e7) * 1e-7f;
+        const float x = dlon * cos_lat, km = std::sqrt(dlat*dlat + x*x) * kKmPerDeg;
+        if (km > cfg_.radius_km) return false;
+        const uint64_t gap = t_ms > n.t_ms ? t_ms - n.t_ms : n.t_ms - t_ms;
+        return float(gap) <= km / cfg_.vp_km_s * 1000.f + float(cfg_.slack_ms);
+    }
+
+    CoincidenceConfig cfg_;
+    uint32_t gap_ms_ = 0, slice_ms_ = 1;
+    uint64_t repeat_ms_ = 0;
+    int32_t cell_e7_ = 1;
+    int64_t cols_ = 1;
+    std::vector<Entry> ring_;
+    std::vector<uint32_t> heads_, dev_heads_;
+    uint32_t seq_ = 1;
+};
+
+} // namespace sinyalist::seismic
@@ -0,0 +1,472 @@
+// =============================================================================
+// SINYALIST — DetectorBank: N independent detector streams, SoA layout
+// =============================================================================
+// Server-side re-detection over uploaded waveforms from many phones. Each
+// stream behaves exactly like its own SeismicDetector (same Config, same
+// coefficients, same float evaluation order, same TriggerState), but state is
+// stored structure-of-arrays so the per-sample DSP runs across streams:
+//
+//   stage 1 (vectorisable)  gravity LP → band-pass → legacy HP → |a| for every
+//                           stream; streams in cooldown keep their old state
+//                           via select, matching SeismicDetector's early return
+//   stage 2 (per stream)    boxcar STA/LTA/calibration sums (or C8 recursive
+//                           STA/LTA, no window storage; C26 compact LTA and
+//                           calibration storage), C3 periodicity sums
+//                           (while confirming, as in PeriodicityTracker),
+//                           C11 spectral bins while armed, TriggerState::step()
+//
+// The periodicity state is SoA too (lag sums [stream][lag], one mirrored ring
+// per stream): once a stream's window is full its per-lag update is one
+// branch-free loop over contiguous lags, where PeriodicityTracker tests each
+// lag against the fill level.
+//
+// Config::pregate (C9) is a battery optimisation for the phone and is ignored
+// here; every stream always runs the full pipeline.
+//
+// Streams are split into shards of kShard (cache-sized ranges; every SoA
+// array is 64-byte aligned, so shards never share a cache line) that a
+// ThreadPool processes in parallel. Events are buffered per
+// shard and delivered on the calling thread in (sample, stream) order.
+// =============================================================================
+
+#pragma once
+#include "seismic_detector.hpp"
+#include "thread_pool.hpp"
+#include <new>
+#include <vector>
+
+namespace sinyalist::seismic {
+
+// 64-byte aligned storage for DetectorBank's SoA arrays.
+template<typename T>
+struct CacheLineAllocator {
+    using value_type = T;
+    CacheLineAllocator() = default;
+    template<typename U> CacheLineAllocator(const CacheLineAllocator<U>&) noexcept {}
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64))); }
+    void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t(64)); }
+    template<typename U> bool operator==(const CacheLineAllocator<U>&) const noexcept { return true; }
+    template<typename U> bool operator!=(const CacheLineAllocator<U>&) const noexcept { return false; }
+};
+template<typename T> using Lanes = std::vector<T, CacheLineAllocator<T>>;
+
+class DetectorBank {
+public:
+    using EventCB = std::function<void(uint32_t stream, const SeismicEvent&)>;
+    static constexpr uint32_t kShard = 16;   // streams per work item
+
+    // A cfg that is not valid() (C5), which SeismicDetector would refuse,
+    // gives an empty bank (size() 0) on the default config.
+    DetectorBank(uint32_t streams, const Config& cfg, EventCB on_ev, unsigned threads = 0)
+        : n_(cfg.valid() ? streams : 0), cfg_(cfg.valid() ? cfg : Config{}), on_ev_(std::move(on_ev)), pool_(threads) {
+        sta_cap_ = cfg_.sta_window; lta_cap_ = cfg_.lta_window; cal_cap_ = cfg_.calib_window;
+        if (cfg_.window_mode == WindowMode::BOXCAR) {
+            sta_st_ = pow2_ceil(sta_cap_); lta_st_ = pow2_ceil(lta_cap_); cal_st_ = pow2_ceil(cal_cap_);
+        }
+        sta_row_ = row(sta_st_, sizeof(float));
+        lta_row_ = row(lta_st_, sample_bytes()); cal_row_ = row(cal_st_, sample_bytes());
+        rec_.configure(cfg_.sta_window, cfg_.lta_window, cfg_.calib_window);
+        for (auto* v : {&gx_, &gy_, &gz_,
+                        &w_[0], &w_[1], &w_[2], &w_[3], &w_[4], &w_[5],
+                        &w_[6], &w_[7], &w_[8], &w_[9], &w_[10], &w_[11],
+                        &hr_[0], &hr_[1], &hr_[2], &hf_[0], &hf_[1], &hf_[2],
+                        &sta_s_, &sta_q_, &lta_s_, &lta_q_, &cal_s_, &cal_q_,
+                        &fx_, &fy_, &fz_, &mag_})
+            v->assign(n_, 0.0f);
+        act_.assign(n_, 0);
+        pushes_.assign(n_, 0);
+        sta_b_.assign(size_t(n_) * sta_row_, 0.0f);
+        switch (cfg_.window_storage) {
+        case WindowStorage::F16: lta_h_.resize(size_t(n_) * lta_row_); cal_h_.resize(size_t(n_) * cal_row_); break;
+        case WindowStorage::U16: lta_q_b_.resize(size_t(n_) * lta_row_); cal_q_b_.resize(size_t(n_) * cal_row_); break;
+        default: lta_b_.assign(size_t(n_) * lta_row_, 0.0f); cal_b_.assign(size_t(n_) * cal_row_, 0.0f);
+        }
+        configure_periodicity();
+        spec_.configure(cfg_.sample_rate_hz, cfg_.pwave_freq_min, cfg_.pwave_freq_max);
+        for (uint32_t k = 0; k < spec_.nb * 3; ++k) { sre_[k].assign(n_, 0.0f); sim_[k].assign(n_, 0.0f); }
+        for (auto& v : spt_) v.assign(n_, 0.0f);
+        spec_on_.assign(n_, 0);
+        trg_.assign(n_, TriggerState{});
+        hits_.resize((n_ + kShard - 1) / kShard);
+        const FilterDesign& d = filter_design_for(cfg_.sample_rate_hz);
+        hp_ = d.hp; lp_ = d.lp; kg_ = d.grav_alpha;
+        clear_state();
+    }
+
+    uint32_t size() const noexcept { return n_; }
+    const Config& config() const noexcept { return cfg_; }
+    unsigned threads() const noexcept { return pool_.size(); }
+
+    // Same as SeismicDetector::reset() on every stream.
+    void reset() noexcept {
+        clear_state();
+        for (auto& t : trg_) t.reset(cfg_);
+    }
+
+    // One sample for every stream: xyz[3i..3i+2] and ts[i] belong to stream i.
+    void step(const float* xyz, const uint64_t* ts) {
+        pool_.parallel_for(shards(), [&](uint32_t s) {
+            uint32_t b = s * kShard, e = std::min(n_, b + kShard);
+            shard_sample(b, e, xyz, ts, 0);
+        });
+        deliver();
+    }
+
+    // `samples` samples for all streams, sample-major:
+    //   xyz[(t*size()+i)*3 ..], ts[t*size()+i]
+    // Shards run through the whole block independently (no per-sample barrier).
+    void run(const float* xyz, const uint64_t* ts, size_t samples) {
+        pool_.parallel_for(shards(), [&](uint32_t s) {
+            uint32_t b = s * kShard, e = std::min(n_, b + kShard);
+            for (size_t t = 0; t < samples; ++t)
+                shard_sample(b, e, xyz + t * size_t(n_) * 3, ts + t * size_t(n_), t);
+        });
+        deliver();
+    }
+
+    // Approximate heap footprint of the per-stream state.
+    size_t bytes() const noexcept {
+        return size_t(n_) * ((31 + 3 + 6 * spec_.nb) * sizeof(float) + 2 + sizeof(uint32_t) + sizeof(TriggerState) +
+                             (2 + 3 * per_nl_) * sizeof(double) + 3 * sizeof(uint32_t) + 1 + per_row_ * sizeof(double) +
+                             sizeof(float) * sta_row_ + sample_bytes() * (lta_row_ + cal_row_));
+    }
+
+private:
+    struct Hit { size_t t; uint32_t stream; SeismicEvent ev; };
+
+    uint32_t shards() const noexcept { return (n_ + kShard - 1) / kShard; }
+    // Per-stream stride of a ring of st elements: one cache line more, so the
+    // heads of neighbouring streams' power-of-two rings do not all fall in
+    // the same cache set (0 stays 0).
+    static uint32_t row(uint32_t st, size_t elem) noexcept { return st ? st + uint32_t(64 / elem) : 0; }
+    size_t sample_bytes() const noexcept {
+        return cfg_.window_storage == WindowStorage::F32 ? sizeof(float) : sizeof(uint16_t);
+    }
+
+    void clear_state() noexcept {
+        std::fill(gx_.begin(), gx_.end(), 0.0f); std::fill(gy_.begin(), gy_.end(), 0.0f);
+        std::fill(gz_.begin(), gz_.end(), -1.0f);
+        for (auto& v : w_) std::fill(v.begin(), v.end(), 0.0f);
+        for (int a = 0; a < 3; ++a) {
+            std::fill(hr_[a].begin(), hr_[a].end(), 0.0f);
+            std::fill(hf_[a].begin(), hf_[a].end(), 0.0f);
+        }
+        for (auto* v : {&sta_s_, &sta_q_, &lta_s_, &lta_q_, &cal_s_, &cal_q_})
+            std::fill(v->begin(), v->end(), 0.0f);
+        for (uint32_t k = 0; k < spec_.nb * 3; ++k) {
+            std::fill(sre_[k].begin(), sre_[k].end(), 0.0f); std::fill(sim_[k].begin(), sim_[k].end(), 0.0f);
+        }
+        for (auto& v : spt_) std::fill(v.begin(), v.end(), 0.0f);
+        std::fill(spec_on_.begin(), spec_on_.end(), 0);
+        std::fill(pushes_.begin(), pushes_.end(), 0u);
+        for (auto* v : {&per_h_, &per_n_, &per_pushes_}) std::fill(v->begin(), v->end(), 0u);
+        for (auto* v : {&per_s_, &per_sq_, &per_p_, &per_hd_, &per_tl_}) std::fill(v->begin(), v->end(), 0.0);
+        std::fill(per_on_.begin(), per_on_.end(), 0);
+    }
+
+    // C3: the clamps of PeriodicityTracker<1024,64>::configure() with the
+    // single-detector window (FloatWindows::apply()).
+    void configure_periodicity() {
+        uint32_t cap = uint32_t(4.f * cfg_.sample_rate_hz);
+        uint32_t lo = uint32_t(cfg_.sample_rate_hz / 2.5f), hi = uint32_t(cfg_.sample_rate_hz / 1.5f);
+        per_cap_ = cap > 0 && cap <= kPerMax ? cap : kPerMax; per_mask_ = pow2_ceil(per_cap_) - 1;
+        if (lo < 1) lo = 1;
+        if (per_cap_ / 2 > 0 && hi >= per_cap_ / 2) hi = per_cap_ / 2 - 1;
+        per_nl_ = hi >= lo ? std::min(hi - lo + 1, kPerLags) : 0;
+        per_l0_ = lo;
+        per_row_ = row(4 * (per_mask_ + 1), sizeof(double));
+        per_b_.assign(size_t(n_) * per_row_, 0.0);
+        for (auto* v : {&per_h_, &per_n_, &per_pushes_}) v->assign(n_, 0u);
+        per_on_.assign(n_, 0);
+        for (auto* v : {&per_s_, &per_sq_}) v->assign(n_, 0.0);
+        for (auto* v : {&per_p_, &per_hd_, &per_tl_}) v->assign(size_t(n_) * per_nl_, 0.0);
+    }
+
+    // C3: PeriodicityTracker::push for stream i; same op order per lag. Each
+    // stream keeps its ring four times over: forwards at slot and slot + size,
+    // then backwards the same way, so the nl samples at lags l0.. from either
+    // end of the window are contiguous in ascending lag order. Samples are
+    // held widened to double, exactly as push() widens them.
+    double per_at(uint32_t i, uint32_t k) const noexcept {
+        return per_b_[size_t(i) * per_row_ + ((per_h_[i] - per_n_[i] + k) & per_mask_)];
+    }
+    void per_push(uint32_t i, float x) noexcept {
+        const uint32_t rs = per_mask_ + 1, nl = per_nl_, l0 = per_l0_;
+        double* b = &per_b_[size_t(i) * per_row_];
+        double* rb = b + 2 * rs;                                       // rb[rs-1-slot]
+        double* p = &per_p_[size_t(i) * nl]; double* hd = &per_hd_[size_t(i) * nl]; double* tl = &per_tl_[size_t(i) * nl];
+        uint32_t h = per_h_[i], n = per_n_[i];
+        if (!per_on_[i]) {                                             // not tracking: store only
+            per_store(b, h, x); per_h_[i] = h + 1; per_n_[i] = n + (n < per_cap_);
+            return;
+        }
+        double s = per_s_[i], sq = per_sq_[i];
+        if (n == per_cap_) {
+            // Full: every lag is below n on eviction and at most n-1 on insert,
+            // so both loops of push() fuse into one without the fill tests.
+            const double x0 = b[(h - n) & per_mask_];
+            const double* xl = b + ((h - n + l0) & per_mask_);              // at(l0+k)
+            const double* xo = rb + (rs - 1 - ((h - l0) & per_mask_));    // at(n-1-l0-k)
+            per_slide(nl, x0, x, xl, xo, p, hd, tl);
+            s -= x0; sq -= double(x0) * x0;
+        } else {
+            for (uint32_t k = 0; k < nl; ++k) {
+                uint32_t lag = l0 + k;
+                if (n >= lag) { double o = b[(h - lag) & per_mask_]; p[k] += double(o) * x; tl[k] += double(x) - o; }
+                else { hd[k] += x; tl[k] += x; }
+            }
+            ++n;
+        }
+        per_store(b, h++, x);
+        s += x; sq += double(x) * x;
+        per_h_[i] = h; per_n_[i] = n; per_s_[i] = s; per_sq_[i] = sq;
+        if (++per_pushes_[i] >= PeriodicityTracker<kPerMax, kPerLags>::kResync) per_rebuild(i);
+    }
+    // x into all four copies of stream ring b at head h.
+    void per_store(double* b, uint32_t h, double x) const noexcept {
+        const uint32_t rs = per_mask_ + 1, slot = h & per_mask_;
+        double* rb = b + 2 * rs;
+        b[slot] = b[slot + rs] = x; rb[rs - 1 - slot] = rb[2 * rs - 1 - slot] = x;
+    }
+    // PeriodicityTracker::track().
+    void per_track(uint32_t i, bool on) noexcept {
+        if (on && !per_on_[i]) per_rebuild(i);
+        per_on_[i] = on;
+    }
+    // Both loops of push() for a full window, lag k: x0 leaves with xl[k]
+    // and x arrives with xo[k]. Restrict parameters spare the vectorised
+    // loop its overlap checks.
+    static void per_slide(uint32_t nl, double x0, double x, const double* __restrict xl, const double* __restrict xo,
+                          double* __restrict p, double* __restrict hd, double* __restrict tl) noexcept {
+        for (uint32_t k = 0; k < nl; ++k) {
+            double l = xl[k], o = xo[k];
+            p[k] -= x0 * l; hd[k] += l - x0;
+            p[k] += o * x;  tl[k] += x - o;
+        }
+    }
+    void per_rebuild(uint32_t i) noexcept {
+        const uint32_t n = per_n_[i];
+        double* p = &per_p_[size_t(i) * per_nl_]; double* hd = &per_hd_[size_t(i) * per_nl_]; double* tl = &per_tl_[size_t(i) * per_nl_];
+        double s = 0, sq = 0;
+        per_pushes_[i] = 0;
+        for (uint32_t j = 0; j < n; ++j) { double x = per_at(i, j); s += x; sq += x*x; }
+        per_s_[i] = s; per_sq_[i] = sq;
+        for (uint32_t k = 0; k < per_nl_; ++k) {
+            uint32_t lag = per_l0_ + k; double a = 0, h = 0, t = 0;
+            for (uint32_t j = 0; j + lag < n; ++j) a += double(per_at(i, j)) * per_at(i, j + lag);
+            for (uint32_t j = 0; j < lag && j < n; ++j) { h += per_at(i, j); t += per_at(i, n - 1 - j); }
+            p[k] = a; hd[k] = h; tl[k] = t;
+        }
+    }
+    // track(true), then PeriodicityTracker::full() && score() > th.
+    bool per_periodic(uint32_t i, float th) noexcept {
+        per_track(i, true);
+        const uint32_t n = per_n_[i];
+        if (n != per_cap_) return false;
+        if (n < 60) return 0 > th;
+        const double* p = &per_p_[size_t(i) * per_nl_]; const double* hd = &per_hd_[size_t(i) * per_nl_];
+        const double* tl = &per_tl_[size_t(i) * per_nl_];
+        double s = per_s_[i], m = s / n, v = per_sq_[i] - double(n) * m * m;
+        if (v < PeriodicityTracker<kPerMax, kPerLags>::kVarFloor) return 0 > th;
+        float best = 0;
+        for (uint32_t k = 0; k < per_nl_; ++k) {
+            uint32_t lag = per_l0_ + k; if (lag >= n / 2) break;
+            double c = p[k] - m * (s - tl[k]) - m * (s - hd[k]) + double(n - lag) * m * m;
+            best = std::max(best, float(c / v));
+        }
+        return best > th;
+    }
+
+    // Biquad DF-II-T on SoA state; identical op order to Biquad/BiquadX3.
+    static inline float bq(const Biquad& q, float x, float& w1, float& w2) noexcept {
+        float y = q.b0*x + w1;
+        w1 = q.b1*x - q.a1*y + w2;
+        w2 = q.b2*x - q.a2*y;
+        return y;
+    }
+
+    // a where mask m is all ones, else b; bitwise, so a loop of them
+    // vectorises where GCC turns several `on ? a : b` into one branch.
+    static inline float pick(uint32_t m, float a, float b) noexcept {
+        uint32_t x, y; std::memcpy(&x, &a, 4); std::memcpy(&y, &b, 4);
+        x = (x & m) | (y & ~m);
+        float r; std::memcpy(&r, &x, 4); return r;
+    }
+
+    // Stage 1 for one axis over [b,e).
+    void filter_axis(uint32_t b, uint32_t e, const float* xyz, int a, float* g, float* out) noexcept {
+        filter_lanes(b, e, xyz + a, hp_, lp_, kg_, cfg_.hp_alpha, act_.data(), g,
+                     w_[a*4].data(), w_[a*4+1].data(), w_[a*4+2].data(), w_[a*4+3].data(),
+                     hr_[a].data(), hf_[a].data(), out);
+    }
+    // A plain loop the compiler vectorises: no two arrays overlap (restrict
+    // parameters — GCC ignores restrict on locals) and every store is
+    // unconditional. raw is the axis' first input, 3 floats apart.
+    static void filter_lanes(uint32_t b, uint32_t e, const float* __restrict raw, const Biquad hp, const Biquad lp,
+                             const float k, const float ha, const uint8_t* __restrict act, float* __restrict g,
+                             float* __restrict hw1, float* __restrict hw2, float* __restrict lw1, float* __restrict lw2,
+                             float* __restrict hr, float* __restrict hf, float* __restrict out) noexcept {
+        for (uint32_t i = b; i < e; ++i) {
+            const float x = raw[3*size_t(i)], g0 = g[i];
+            const float w10 = hw1[i], w20 = hw2[i], v10 = lw1[i], v20 = lw2[i], hr0 = hr[i], hf0 = hf[i];
+            float gn = g0 + k * (x - g0);
+            float w1 = w10, w2 = w20, v1 = v10, v2 = v20;
+            float y = bq(lp, bq(hp, x - gn, w1, w2), v1, v2);
+            float f = ha * (hf0 + y - hr0);
+            const uint32_t on = 0u - uint32_t(act[i] != 0);
+            g[i]   = pick(on, gn, g0);
+            hw1[i] = pick(on, w1, w10); hw2[i] = pick(on, w2, w20);
+            lw1[i] = pick(on, v1, v10); lw2[i] = pick(on, v2, v20);
+            hr[i]  = pick(on, y, hr0);  hf[i]  = pick(on, f, hf0);
+            out[i] = f;
+        }
+    }
+
+    // C11: SpectralBank::push for stream i; same op order as the f4 lanes.
+    void spectrum_push(uint32_t i) noexcept {
+        const float f[3] = {fx_[i], fy_[i], fz_[i]};
+        for (int a = 0; a < 3; ++a) {
+            float x = f[a]; spt_[a][i] = spt_[a][i] + spec_.g * (x*x - spt_[a][i]);
+            for (uint32_t k = 0; k < spec_.nb; ++k) {
+                float& re = sre_[k*3 + a][i]; float& im = sim_[k*3 + a][i];
+                float r = re + x, m = im, c = spec_.c[k], s = spec_.s[k];
+                re = c*r - s*m; im = s*r + c*m;
+            }
+        }
+    }
+    void spectrum_reset(uint32_t i) noexcept {
+        for (uint32_t k = 0; k < spec_.nb * 3; ++k) sre_[k][i] = sim_[k][i] = 0.0f;
+        for (auto& v : spt_) v[i] = 0.0f;
+    }
+
+    SpectralPeak spectrum(uint32_t i) const noexcept {
+        float p[SpectralBank::kMaxBins];
+        for (uint32_t k = 0; k < spec_.nb; ++k) {
+            float q[3];
+            for (int a = 0; a < 3; ++a) { float r = sre_[k*3 + a][i], m = sim_[k*3 + a][i]; q[a] = r*r + m*m; }
+            p[k] = q[0] + q[1] + q[2];
+        }
+        return spec_.peak_of(p, spt_[0][i] + spt_[1][i] + spt_[2][i]);
+    }
+
+    // Ring::push on per-stream storage; same op order and C26 rounding.
+    template<typename S>
+    static inline void ring_push(S* buf, uint32_t h, uint32_t cap, uint32_t mask,
+                                 float& s, float& q, float v) noexcept {
+        using Codec = StorageCodec<S, float>;
+        if (h >= cap) { float o = Codec::get(buf[(h - cap) & mask]); s -= o; q -= o*o; }
+        S e = Codec::put(v); v = Codec::get(e);
+        buf[h & mask] = e; s += v; q += v*v;
+    }
+    template<typename S>
+    void push_lta_cal(Lanes<S>& lb, Lanes<S>& cb, uint32_t i, uint32_t h, float m) noexcept {
+        ring_push(&lb[size_t(i) * lta_row_], h, lta_cap_, lta_st_ - 1, lta_s_[i], lta_q_[i], m);
+        ring_push(&cb[size_t(i) * cal_row_], h, cal_cap_, cal_st_ - 1, cal_s_[i], cal_q_[i], m);
+    }
+
+    void shard_sample(uint32_t b, uint32_t e, const float* xyz, const uint64_t* ts, size_t t) {
+        for (uint32_t i = b; i < e; ++i) act_[i] = trg_[i].cd == 0;
+        filter_axis(b, e, xyz, 0, gx_.data(), fx_.data());
+        filter_axis(b, e, xyz, 1, gy_.data(), fy_.data());
+        filter_axis(b, e, xyz, 2, gz_.data(), fz_.data());
+        for (uint32_t i = b; i < e; ++i)
+            mag_[i] = std::sqrt(fx_[i]*fx_[i] + fy_[i]*fy_[i] + fz_[i]*fz_[i]);
+
+        auto& hits = hits_[b / kShard];
+        for (uint32_t i = b; i < e; ++i) {
+            TriggerState& tr = trg_[i];
+            if (!act_[i]) { --tr.cd; continue; }
+            float m = mag_[i];
+            per_push(i, m);
+            float s, l, bv;
+            if (sta_st_) {
+                uint32_t h = pushes_[i]++;
+                ring_push(&sta_b_[size_t(i) * sta_row_], h, sta_cap_, sta_st_ - 1, sta_s_[i], sta_q_[i], m);
+                switch (cfg_.window_storage) {
+                case WindowStorage::F16: push_lta_cal(lta_h_, cal_h_, i, h, m); break;
+                case WindowStorage::U16: push_lta_cal(lta_q_b_, cal_q_b_, i, h, m); break;
+                default: push_lta_cal(lta_b_, cal_b_, i, h, m);
+                }
+                if (h + 1 < lta_cap_) continue;                   // !lta_.full()
+                uint32_t ns = std::min(h + 1, sta_cap_), nc = std::min(h + 1, cal_cap_);
+                s = sta_s_[i] / float(ns); l = lta_s_[i] / float(lta_cap_);
+                bv = 0;                                           // Ring::var()
+                if (nc >= 2) { float mc = cal_s_[i] / float(nc); float v = cal_q_[i] / float(nc) - mc*mc; bv = v > 0 ? v : 0; }
+            } else {                                              // C8: RecursiveStaLta::push()
+                uint32_t k = pushes_[i];
+                if (k < rec_.k_max) {
+                    RecursiveStaLta::update(m, RecursiveStaLta::gain(k, rec_.n_sta, rec_.g_sta),
+                        RecursiveStaLta::gain(k, rec_.n_lta, rec_.g_lta),
+                        RecursiveStaLta::gain(k, rec_.n_cal, rec_.g_cal),
+                        sta_s_[i], lta_s_[i], cal_s_[i], cal_q_[i]);
+                    pushes_[i] = ++k;
+                } else {
+                    RecursiveStaLta::update(m, rec_.g_sta, rec_.g_lta, rec_.g_cal,
+                        sta_s_[i], lta_s_[i], cal_s_[i], cal_q_[i]);
+                }
+                if (k < rec_.n_lta) continue;                     // !rec_.ready()
+                s = sta_s_[i]; l = lta_s_[i]; bv = cal_q_[i];
+            }
+            float at = adaptive_trigger(cfg_, bv);
+            if (l < cfg_.min_amplitude_g) { spec_on_[i] = 0; continue; }
+            float r = s / l;
+            bool on = tr.wants_spectrum(r, at);
+            if (on) { if (!spec_on_[i]) spectrum_reset(i); spectrum_push(i); }
+            spec_on_[i] = on;
+            tr.step(cfg_, r, at, m, fx_[i], fy_[i], fz_[i], ts[i],
+                [this, i](float th) { return per_periodic(i, th); },
+                [this, i] { return spectrum(i); },
+                [&](const SeismicEvent& ev) { hits.push_back({t, i, ev}); });
+            per_track(i, tr.st == TriggerState::S::CONFIRM);
+        }
+    }
+
+    void deliver() {
+        if (!on_ev_) { for (auto& h : hits_) h.clear(); return; }
+        merged_.clear();
+        for (auto& h : hits_) { merged_.insert(merged_.end(), h.begin(), h.end()); h.clear(); }
+        std::stable_sort(merged_.begin(), merged_.end(),
+                         [](const Hit& a, const Hit& b) { return a.t != b.t ? a.t < b.t : a.stream < b.stream; });
+        for (const Hit& h : merged_) on_ev_(h.stream, h.ev);
+    }
+
+    uint32_t n_;
+    Config cfg_;
+    EventCB on_ev_;
+    ThreadPool pool_;
+    Biquad hp_, lp_; float kg_ = 0;
+    uint32_t sta_cap_ = 0, lta_cap_ = 0, cal_cap_ = 0, sta_st_ = 0, lta_st_ = 0, cal_st_ = 0;
+    uint32_t sta_row_ = 0, lta_row_ = 0, cal_row_ = 0;
+    static constexpr uint32_t kPerMax = 1024, kPerLags = 64;   // PeriodicityTracker<1024,64>
+    uint32_t per_cap_ = 0, per_mask_ = 0, per_l0_ = 0, per_nl_ = 0, per_row_ = 0;
+    RecursiveStaLta rec_;                              // C8: gains/time constants only
+    SpectralBank spec_;                                // C11: bins/coefficients only
+
+    // SoA state, one entry per stream
+    Lanes<float> gx_, gy_, gz_;                        // B2 gravity
+    Lanes<float> w_[12];                               // per axis: hp w1,w2, lp w1,w2
+    Lanes<float> hr_[3], hf_[3];                       // legacy HP prev raw / filt
+    Lanes<float> sta_s_, sta_q_, lta_s_, lta_q_, cal_s_, cal_q_;   // boxcar sums
+                                                       // (C8: sta, -, lta, -, mean, var)
+    Lanes<uint32_t> pushes_;                           // samples pushed since reset (C8: k)
+    Lanes<float> sta_b_, lta_b_, cal_b_;               // per-stream window storage
+    Lanes<Half> lta_h_, cal_h_;                        // C26: F16 instead of lta_b_/cal_b_
+    Lanes<UQ14> lta_q_b_, cal_q_b_;                    // C26: U16
+    Lanes<double> per_b_;                               // C3 rings [stream][4 × ring size]
+    Lanes<double> per_p_, per_hd_, per_tl_;            // C3 lag sums [stream][lag]
+    Lanes<double> per_s_, per_sq_;
+    Lanes<uint32_t> per_h_, per_n_, per_pushes_;
+    Lanes<uint8_t> per_on_;                            // C3 tracking (trigger confirming)
+    Lanes<float> sre_[SpectralBank::kMaxBins * 3], sim_[SpectralBank::kMaxBins * 3];   // C11 [bin*3+axis]
+    Lanes<float> spt_[3];                              // C11 total power per axis
+    Lanes<uint8_t> spec_on_;                           // C11 armed last sample
+    Lanes<TriggerState> trg_;
+    // Stage-1 scratch
+    Lanes<float> fx_, fy_, fz_, mag_;
+    Lanes<uint8_t> act_;
+    // Per-shard event buffers
+    std::vector<std::vector<Hit>> hits_;
+    std::vector<Hit> merged_;
+};
+
+} // namespace sinyalist::seismic
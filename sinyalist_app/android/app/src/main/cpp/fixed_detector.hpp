@@ -0,0 +1,253 @@
+// =============================================================================
+// SINYALIST — FixedMath: integer-arithmetic policy of the detector core
+// =============================================================================
+// C15: armeabi-v7a builds (-mfloat-abi=softfp, SINYALIST_FIXED_POINT) run
+// BasicSeismicDetector<Sink, FixedMath> (FixedSeismicDetector) instead of
+// SeismicDetector: same control flow, pre-gate, wake, snapshot framing and
+// emission, with a per-sample path that is integer-only:
+//
+//   filter chain — gravity one-pole, band-pass biquads and legacy high-pass in
+//                  Q27 samples (1 g = 2^27, input clamped to ±8 g) with Q30
+//                  coefficients, 64-bit accumulators and saturating outputs
+//   magnitude    — rounded integer square root into Q20 (1 g = 2^20, ≤ 16 g)
+//   windows      — Ring<int32_t,N,int64_t> / PeriodicityTracker on int32
+//                  samples with exact int64 running sums
+//   screening    — LTA vs min_amplitude_g and STA/LTA vs kArm·adaptive_trig_min
+//                  are cross-multiplied sums, no division
+//
+// Only a sample that passes the screen, i.e. one where TriggerState or the
+// spectral bank could act, is converted to float and goes through the shared
+// TriggerState / SpectralBank / adaptive_trigger() code, so decisions match
+// SeismicDetector up to Q20 rounding of the inputs. sinyalist_replay --fixed
+// cross-checks them. Boxcar windows only: FixedMath::supported() turns a
+// recursive window_mode or a C26 compact window_storage into boxcar f32,
+// since the int32 rings are exact. The C9 pre-gate keeps its float energy
+// estimate (no sqrt, asleep only).
+// =============================================================================
+
+#pragma once
+#include "seismic_detector.hpp"
+#include <climits>
+
+namespace sinyalist::seismic {
+namespace fx {
+
+constexpr int kAccQ  = 27;   // filter-chain samples
+constexpr float kAccMax = 8.0f;   // |raw| clamp (g); keeps Q57 biquad sums in int64
+constexpr int kMagQ  = 20;   // window samples (magnitudes)
+constexpr int kCoefQ = 30;   // filter coefficients, |c| < 2
+constexpr int kRatioQ = 16;  // STA/LTA thresholds
+
+inline int32_t sat32(int64_t v) noexcept {
+    return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : int32_t(v);
+}
+// Rounding arithmetic shift right.
+inline int64_t rshr(int64_t v, int s) noexcept { return (v + (int64_t(1) << (s - 1))) >> s; }
+// float → Q, rounded and saturated to ±limit.
+inline int32_t to_q(float v, int q, float limit) noexcept {
+    v = std::clamp(v, -limit, limit) * float(1u << q);
+    return int32_t(v < 0 ? v - 0.5f : v + 0.5f);
+}
+inline float from_q(int64_t v, int q) noexcept { return float(double(v) / double(1ull << q)); }
+
+// floor(sqrt(v)), bit by bit from the highest set bit.
+inline uint32_t isqrt(uint64_t v) noexcept {
+    if (!v) return 0;
+    uint64_t r = 0, b = uint64_t(1) << ((63 - __builtin_clzll(v)) & ~1);
+    while (b) {
+        if (v >= r + b) { v -= r + b; r = (r >> 1) + b; } else r >>= 1;
+        b >>= 2;
+    }
+    return uint32_t(r);
+}
+
+// DF-II-T biquad on three lanes; states carry the full Q57 product. The
+// rounding remainder of y is fed back too, so near-unit poles (1 Hz at
+// 200 Hz) do not amplify the output quantisation.
+struct BiquadQ {
+    int32_t b0 = 1 << kCoefQ, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    int64_t w1[3] = {}, w2[3] = {};
+    explicit BiquadQ(const Biquad& q = {}) noexcept
+        : b0(to_q(q.b0, kCoefQ, 1.999f)), b1(to_q(q.b1, kCoefQ, 1.999f)), b2(to_q(q.b2, kCoefQ, 1.999f)),
+          a1(to_q(q.a1, kCoefQ, 1.999f)), a2(to_q(q.a2, kCoefQ, 1.999f)) {}
+    int32_t process(int i, int32_t x) noexcept {
+        int64_t acc = int64_t(b0) * x + w1[i];
+        int32_t y = sat32(rshr(acc, kCoefQ));
+        int64_t e = acc - (int64_t(y) << kCoefQ);
+        if (e > (int64_t(1) << kCoefQ) || e < -(int64_t(1) << kCoefQ)) e = 0;   // saturated
+        w1[i] = int64_t(b1) * x - int64_t(a1) * y - rshr(int64_t(a1) * e, kCoefQ) + w2[i];
+        w2[i] = int64_t(b2) * x - int64_t(a2) * y - rshr(int64_t(a2) * e, kCoefQ);
+        return y;
+    }
+    void reset() noexcept { for (int i = 0; i < 3; ++i) w1[i] = w2[i] = 0; }
+};
+
+// Same stages and order as AxisFilterChain, lane by lane.
+struct AxisFilterChainQ {
+    int64_t g[3];                        // gravity, Q57
+    int32_t k_grav;
+    BiquadQ hp, lp;
+    int32_t hp_raw[3] = {}, hp_filt[3] = {}, hp_a = to_q(0.98f, kCoefQ, 1.999f);
+    explicit AxisFilterChainQ(const FilterDesign& d = kDesign50) noexcept
+        : k_grav(to_q(d.grav_alpha, kCoefQ, 1.999f)), hp(d.hp), lp(d.lp) { reset_gravity(); }
+
+    void set_hp_alpha(float a) noexcept { hp_a = to_q(a, kCoefQ, 1.999f); }
+
+    // Raw g in, filtered Q27 body acceleration out.
+    void process(float ax, float ay, float az, int32_t out[3]) noexcept {
+        const float raw[3] = {ax, ay, az};
+        for (int i = 0; i < 3; ++i) {
+            int32_t r = to_q(raw[i], kAccQ, kAccMax);
+            g[i] += int64_t(k_grav) * (r - int32_t(rshr(g[i], kCoefQ)));
+            int32_t x = lp.process(i, hp.process(i, r - int32_t(rshr(g[i], kCoefQ))));
+            hp_filt[i] = sat32(rshr(int64_t(hp_a) * (int64_t(hp_filt[i]) + x - hp_raw[i]), kCoefQ));
+            hp_raw[i] = x;
+            out[i] = hp_filt[i];
+        }
+    }
+    void seed_gravity(float x, float y, float z) noexcept {
+        const float v[3] = {x, y, z};
+        for (int i = 0; i < 3; ++i) g[i] = int64_t(to_q(v[i], kAccQ, kAccMax)) << kCoefQ;
+    }
+    void reset_gravity() noexcept { seed_gravity(0, 0, -1.0f); }
+    void reset() noexcept {
+        reset_gravity(); hp.reset(); lp.reset();
+        for (int i = 0; i < 3; ++i) hp_raw[i] = hp_filt[i] = 0;
+    }
+};
+
+// |f| in Q20 from Q27 axes, rounded to nearest and saturated at 16 g.
+inline int32_t magnitude(const int32_t f[3]) noexcept {
+    uint64_t ss = 0;
+    for (int i = 0; i < 3; ++i) ss += uint64_t(int64_t(f[i]) * f[i]);
+    ss >>= 2 * (kAccQ - kMagQ);
+    uint32_t r = isqrt(ss);
+    if (ss - uint64_t(r) * r > r) ++r;   // (r + ½)² < ss
+    return int32_t(std::min<uint32_t>(r, 16u << kMagQ));
+}
+
+// Filtered axes in Q27.
+struct Axes { int32_t v[3]; };
+
+} // namespace fx
+
+// C15: FixedMath's windows — boxcar only, int32 Q20 samples with exact int64
+// sums, so the screen and a snapshot refill are exact too.
+class FixedWindows {
+public:
+    PeriodicityTracker<1024,64,int32_t,int64_t,fx::kMagQ> per;
+
+    void apply(const Config& cfg, bool rate, bool, bool) noexcept {
+        if(rate){
+            sta_.set_cap(cfg.sta_window); lta_.set_cap(cfg.lta_window); cal_.set_cap(cfg.calib_window);
+            per.configure(uint32_t(4.f*cfg.sample_rate_hz),
+                          uint32_t(cfg.sample_rate_hz/2.5f), uint32_t(cfg.sample_rate_hz/1.5f));
+        } else {
+            sta_.resize(cfg.sta_window); lta_.resize(cfg.lta_window); cal_.resize(cfg.calib_window);
+        }
+        min_q_=int64_t(double(cfg.min_amplitude_g)*double(1<<fx::kMagQ)+0.5);
+        // Rounded down so the screen never rejects a sample the float path would take.
+        arm_q_=int64_t(double(TriggerState::kArm)*double(cfg.adaptive_trig_min)*double(1<<fx::kRatioQ));
+    }
+
+    void reset() noexcept { sta_.reset(); lta_.reset(); cal_.reset(); per.reset(); }
+
+    bool push(int32_t mag) noexcept {
+        per.push(mag);
+        sta_.push(mag); lta_.push(mag); cal_.push(mag);
+        return lta_.full();
+    }
+
+    // r = (ss/ns)/(sl/nl): both screens cross-multiply, no division.
+    bool low(const Config&) const noexcept { return lta_.sum()<min_q_*int64_t(lta_.size()); }
+    bool unarmed() const noexcept {
+        int64_t ss=sta_.sum(), sl=lta_.sum(), ns=sta_.size(), nl=lta_.size();
+        return (ss*nl<<fx::kRatioQ)<arm_q_*sl*ns;
+    }
+    WindowLevels levels() const noexcept {
+        float s=fx::from_q(sta_.sum(),fx::kMagQ)/float(sta_.size());
+        float l=fx::from_q(lta_.sum(),fx::kMagQ)/float(lta_.size());
+        return {s, l, baseline_var()};
+    }
+    void advance(uint64_t) noexcept {}
+
+    // C14: sizes and Q20 history after low; nothing ahead of the pre-gate.
+    uint32_t history() const noexcept { return std::max({sta_.size(),lta_.size(),cal_.size(),per.size()}); }
+    void save_head(SnapshotOut&) const noexcept {}
+    void load_head(SnapshotIn&) noexcept {}
+    void save_tail(SnapshotOut& o) const noexcept {
+        uint32_t ns=sta_.size(), nl=lta_.size(), nc=cal_.size(), np=per.size(), nh=history();
+        o.put(nh); o.put(ns); o.put(nl); o.put(nc); o.put(np);
+        for(uint32_t i=0;i<nh;++i){
+            int32_t v = nh==np ? per.sample(i) : nh==nc ? cal_.at(i) : nh==nl ? lta_.at(i) : sta_.at(i);
+            o.put(v);
+        }
+    }
+    void load_tail(SnapshotIn& in, bool) noexcept {
+        uint32_t nh,ns,nl,nc,np;
+        in.get(nh); in.get(ns); in.get(nl); in.get(nc); in.get(np);
+        auto fill=[&](uint32_t k, auto&& push){
+            for(uint32_t i=nh-std::min(k,nh);i<nh;++i){ int32_t v; std::memcpy(&v,in.p+size_t(i)*4,4); push(v); }
+        };
+        fill(ns,[this](int32_t v){ sta_.push(v); });
+        fill(nl,[this](int32_t v){ lta_.push(v); });
+        fill(nc,[this](int32_t v){ cal_.push(v); });
+        fill(np,[this](int32_t v){ per.push(v); });
+    }
+
+private:
+    Ring<int32_t,Config::kMaxSta,int64_t> sta_; Ring<int32_t,Config::kMaxLta,int64_t> lta_;
+    Ring<int32_t,Config::kMaxCalib,int64_t> cal_;
+    int64_t min_q_=0, arm_q_=0;        // min_amplitude_g in Q20, kArm·adaptive_trig_min in Q16
+
+    float baseline_var() const noexcept {
+        double n=double(cal_.size()), k=double(1ull<<fx::kMagQ);
+        if(n<2) return 0;
+        double m=double(cal_.sum())/n, v=(double(cal_.sum_sq())/n-m*m)/(k*k);
+        return v>0?float(v):0.f;
+    }
+};
+
+// C15: the integer policy. Snapshots share SeismicDetector's header with
+// arith = 1. Payload: filter chain 15×i64 (gravity, biquad states) + 6×i32
+// (HP) | pre-gate 4×f32, quiet u32 | cooldown u32 | samples u64 | low u8 |
+// n u32 | window sizes 4×u32 | n×i32 Q20 magnitudes, oldest first. Integer
+// sums are exact, so refilling the windows restores them.
+struct FixedMath {
+    using Chain = fx::AxisFilterChainQ;
+    using Filtered = fx::Axes;
+    using Mag = int32_t;               // Q20
+    using Windows = FixedWindows;
+    static constexpr uint8_t kArith = 1;
+    static constexpr size_t kSnapshotState = 15*8 + 6*4;
+
+    // Boxcar f32 windows only: the int32 rings stay exact.
+    static Config supported(const Config& c) noexcept {
+        Config r=c; r.window_mode=WindowMode::BOXCAR; r.window_storage=WindowStorage::F32;
+        return r;
+    }
+    static Filtered filter(Chain& c, float x, float y, float z) noexcept {
+        Filtered f; c.process(x, y, z, f.v); return f;
+    }
+    static Mag magnitude(const Filtered& f) noexcept { return fx::magnitude(f.v); }
+    static float g(Mag m) noexcept { return fx::from_q(m, fx::kMagQ); }
+    static simd::f4 axes(const Filtered& f) noexcept {
+        return simd::set3(fx::from_q(f.v[0],fx::kAccQ), fx::from_q(f.v[1],fx::kAccQ), fx::from_q(f.v[2],fx::kAccQ));
+    }
+
+    static void save(const Chain& c, SnapshotOut& o) noexcept {
+        for(int i=0;i<3;++i){ o.put(c.g[i]); o.put(c.hp.w1[i]); o.put(c.hp.w2[i]); o.put(c.lp.w1[i]); o.put(c.lp.w2[i]); }
+        for(int i=0;i<3;++i){ o.put(c.hp_raw[i]); o.put(c.hp_filt[i]); }
+    }
+    static void load(Chain& c, SnapshotIn& in) noexcept {
+        for(int i=0;i<3;++i){ in.get(c.g[i]); in.get(c.hp.w1[i]); in.get(c.hp.w2[i]); in.get(c.lp.w1[i]); in.get(c.lp.w2[i]); }
+        for(int i=0;i<3;++i){ in.get(c.hp_raw[i]); in.get(c.hp_filt[i]); }
+    }
+};
+
+// C19: Sink as for BasicSeismicDetector.
+template<class Sink = FunctionSink>
+using BasicFixedSeismicDetector = BasicSeismicDetector<Sink, FixedMath>;
+using FixedSeismicDetector = BasicFixedSeismicDetector<>;
+
+} // namespace sinyalist::seismic
@@ -0,0 +1,167 @@
+// =============================================================================
+// SINYALIST — LatencyTrace: per-event latency from sensor HAL to Flutter
+// =============================================================================
+// C24: every detector event is followed through the pipeline on one clock,
+// CLOCK_BOOTTIME ns (SensorEvent.timestamp, SystemClock.elapsedRealtimeNanos):
+//
+//   SENSOR     resampled grid time of the sample that fired (C10; at most one
+//              raw sensor period before the HAL sample that completed it)
+//   INGEST     the JNI batch holding it entered native code
+//   DECISION   the detector fired (sensor thread)
+//   DISPATCH   the dispatcher thread took the event off its queue (C6)
+//   CALLBACK   SeismicCallback.onSeismicEvent returned
+//   UI         Kotlin handed the event to the Flutter EventChannel, or with
+//              dart:ffi bound, Dart added it to its stream (C18)
+//
+// An event's marks live in a ring record keyed by its trace id; each later
+// mark checks the id before and after writing, so a record overwritten 64
+// events later is skipped instead of corrupted. Hop k (mark k → k+1) goes
+// into a log2 histogram whose only writer is the thread of mark k+1: the
+// sensor thread for the first two, the dispatcher for the next two, the
+// main thread (or the Dart isolate on the dart:ffi path) for the last.
+// Cost: one clock read per batch and a few per event; nothing per sample.
+//
+// With SINYALIST_ATRACE=1 (CMake -DSINYALIST_ATRACE=ON, Android only) the
+// hops from DECISION on are also async trace sections and every hop a
+// counter, visible in Perfetto / systrace under the "sinyalist." names.
+//
+// export_words() layout (u64, appended to nativeGetStats after C20):
+//   hops H | buckets B | H × (count | sum_ns | max_ns | B × bucket)
+// =============================================================================
+
+#pragma once
+#include "stage_profile.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <time.h>
+
+#ifndef SINYALIST_ATRACE
+#define SINYALIST_ATRACE 0
+#endif
+#if SINYALIST_ATRACE
+#include <dlfcn.h>
+#endif
+
+namespace sinyalist::seismic {
+
+enum class Mark : uint8_t { SENSOR, INGEST, DECISION, DISPATCH, CALLBACK, UI, COUNT };
+constexpr size_t kMarks = size_t(Mark::COUNT);
+constexpr size_t kHops = kMarks - 1;
+constexpr const char* kHopNames[kHops] = {
+    "sinyalist.sensor_ingest", "sinyalist.ingest_decision", "sinyalist.decision_dispatch",
+    "sinyalist.dispatch_callback", "sinyalist.callback_ui",
+};
+
+constexpr uint32_t kLatencyBuckets = 32;     // last bucket: ≥ 2.1 s
+constexpr size_t kLatencyWords = 2 + kHops * (3 + kLatencyBuckets);
+
+inline uint64_t boottime_ns() noexcept {
+    timespec t;
+    clock_gettime(CLOCK_BOOTTIME, &t);
+    return uint64_t(t.tv_sec) * 1000000000u + uint64_t(t.tv_nsec);
+}
+
+#if SINYALIST_ATRACE
+// NDK ATrace_* async sections and counters are API 29; resolved at run time
+// so the library still loads on API 24.
+struct Atrace {
+    bool (*enabled)() = nullptr;
+    void (*begin)(const char*, int32_t) = nullptr;
+    void (*end)(const char*, int32_t) = nullptr;
+    void (*counter)(const char*, int64_t) = nullptr;
+
+    static const Atrace& get() noexcept {
+        static const Atrace a = [] {
+            Atrace t;
+            t.enabled = reinterpret_cast<bool (*)()>(dlsym(RTLD_DEFAULT, "ATrace_isEnabled"));
+            t.begin = reinterpret_cast<void (*)(const char*, int32_t)>(dlsym(RTLD_DEFAULT, "ATrace_beginAsyncSection"));
+            t.end = reinterpret_cast<void (*)(const char*, int32_t)>(dlsym(RTLD_DEFAULT, "ATrace_endAsyncSection"));
+            t.counter = reinterpret_cast<void (*)(const char*, int64_t)>(dlsym(RTLD_DEFAULT, "ATrace_setCounter"));
+            if (!t.begin || !t.end || !t.counter) t.enabled = nullptr;
+            return t;
+        }();
+        return a;
+    }
+    bool on() const noexcept { return enabled && enabled(); }
+};
+#endif
+
+class LatencyTrace {
+public:
+    static constexpr uint32_t kCapacity = 64;    // events in flight (power of two)
+    using Histogram = Log2Histogram<kLatencyBuckets>;
+
+    // Sensor thread, when the detector fires. sensor_ns 0 = unknown (the
+    // batch carried wall-clock ms only). Returns the event's trace id.
+    uint64_t begin(uint64_t sensor_ns, uint64_t ingest_ns, uint64_t decision_ns) noexcept {
+        const uint64_t id = next_.load(std::memory_order_relaxed) + 1;
+        next_.store(id, std::memory_order_relaxed);
+        Record& r = rec_[id & (kCapacity - 1)];
+        r.id.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (auto& n : r.ns) n.store(0, std::memory_order_relaxed);
+        r.ns[size_t(Mark::SENSOR)].store(sensor_ns, std::memory_order_relaxed);
+        r.ns[size_t(Mark::INGEST)].store(ingest_ns, std::memory_order_relaxed);
+        r.ns[size_t(Mark::DECISION)].store(decision_ns, std::memory_order_relaxed);
+        r.id.store(id, std::memory_order_release);
+        if (sensor_ns && ingest_ns >= sensor_ns) hop(Mark::SENSOR, id, ingest_ns - sensor_ns);
+        if (decision_ns >= ingest_ns) hop(Mark::INGEST, id, decision_ns - ingest_ns);
+        return id;
+    }
+
+    // DISPATCH, CALLBACK or UI for a begin() id, each from its own thread.
+    void mark(uint64_t id, Mark m, uint64_t ns) noexcept {
+        if (!id || m <= Mark::DECISION || m >= Mark::COUNT) return;
+        Record& r = rec_[id & (kCapacity - 1)];
+        if (r.id.load(std::memory_order_acquire) != id) return;
+        // The latest earlier mark: over dart:ffi the UI mark can land before
+        // the JNI callback has returned.
+        uint64_t prev = 0;
+        for (size_t k = size_t(m); k-- > 0 && !prev;) prev = r.ns[k].load(std::memory_order_acquire);
+        r.ns[size_t(m)].store(ns, std::memory_order_release);
+        if (r.id.load(std::memory_order_acquire) != id) return;
+        if (prev && ns >= prev) hop(Mark(uint8_t(m) - 1), id, ns - prev);
+    }
+
+    // Events traced since construction.
+    uint64_t events() const noexcept { return next_.load(std::memory_order_relaxed); }
+    const Histogram& operator[](size_t hop) const noexcept { return h_[hop]; }
+
+    // See the layout above; out holds kLatencyWords. Returns the words written.
+    size_t export_words(uint64_t* out) const noexcept {
+        uint64_t* p = out;
+        *p++ = kHops; *p++ = kLatencyBuckets;
+        for (const auto& h : h_) p += h.export_words(p);
+        return size_t(p - out);
+    }
+
+private:
+    struct Record {
+        std::atomic<uint64_t> id{0};
+        std::atomic<uint64_t> ns[kMarks]{};
+    };
+
+    // Hop from mark `from` to the next one took ns.
+    void hop(Mark from, uint64_t id, uint64_t ns) noexcept {
+        h_[size_t(from)].add(ns);
+#if SINYALIST_ATRACE
+        const Atrace& a = Atrace::get();
+        if (!a.on()) return;
+        const size_t k = size_t(from);
+        a.counter(kHopNames[k], int64_t(ns));
+        // Sections are opened and closed live, so only from the decision on:
+        // hop k ends here and hop k+1 starts.
+        if (k >= size_t(Mark::DECISION)) a.end(kHopNames[k], int32_t(id));
+        if (k + 1 >= size_t(Mark::DECISION) && k + 1 < kHops) a.begin(kHopNames[k + 1], int32_t(id));
+#else
+        (void)id;
+#endif
+    }
+
+    Record rec_[kCapacity];
+    Histogram h_[kHops];
+    std::atomic<uint64_t> next_{0};
+};
+
+} // namespace sinyalist::seismic
@@ -0,0 +1,208 @@
+// =============================================================================
+// SINYALIST — NativeSensor: detector-owned sensor thread (NDK sensor API)
+// =============================================================================
+// C25: instead of a Java SensorEventListener on a default-priority
+// HandlerThread, the native library can own the sample path end to end: a
+// thread of its own with its own ALooper reads an ASensorEventQueue and
+// hands each HAL burst (in ns, m/s² converted to g) to the detector.
+//
+//   priority   setpriority() nice for this thread only (default -16,
+//              THREAD_PRIORITY_AUDIO; SCHED_FIFO is not open to apps)
+//   affinity   optional pinning to one CPU cluster, clusters being the cores
+//              sharing a cpuinfo_max_freq, ordered slowest to fastest
+//   wake_up    the wake-up variant of the sensor, so a HAL FIFO reaching
+//              its batch latency wakes the AP instead of waiting for it
+//
+// Batches go out at most kBatch samples at a time once the queue is empty,
+// like SeismicEngine.kt's flush. Priority and pinning are best effort and
+// reported, not fatal. ASensorEventQueue_registerSensor (batch latency) and
+// ASensorManager_getInstanceForPackage are API 26; on 24/25 they fall back
+// to enableSensor + setEventRate and the legacy getInstance().
+// =============================================================================
+
+#pragma once
+#include <android/looper.h>
+#include <android/sensor.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <dlfcn.h>
+#include <functional>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/resource.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace sinyalist::seismic {
+
+struct NativeSensorConfig {
+    static constexpr int32_t kClusterAny = -1;
+
+    int32_t type = ASENSOR_TYPE_ACCELEROMETER;    // Sensor.TYPE_* values
+    int32_t sampling_us = 10000;
+    int32_t max_latency_us = 100000;               // HAL FIFO batching
+    int32_t nice = -16;
+    int32_t cluster = kClusterAny;                 // index, slowest first; past the end = fastest
+    bool wake_up = false;
+};
+
+// Cores whose cpuinfo_max_freq is the cluster-th lowest distinct one (the
+// fastest for any index past the last); empty if the kernel hides cpufreq.
+inline cpu_set_t cluster_cpus(int32_t cluster) noexcept {
+    constexpr int kMaxCpus = 32;
+    long khz[kMaxCpus] = {}, uniq[kMaxCpus];
+    int ncpu = 0, nu = 0;
+    for (int c = 0; c < kMaxCpus; ++c) {
+        char path[96];
+        std::snprintf(path, sizeof path, "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", c);
+        FILE* f = std::fopen(path, "r");
+        if (!f) continue;
+        if (std::fscanf(f, "%ld", &khz[c]) != 1) khz[c] = 0;
+        std::fclose(f);
+        if (!khz[c]) continue;
+        ncpu = c + 1;
+        bool seen = false;
+        for (int i = 0; i < nu; ++i) seen |= uniq[i] == khz[c];
+        if (!seen) uniq[nu++] = khz[c];
+    }
+    for (int i = 1; i < nu; ++i)                              // insertion sort, nu ≤ 4 in practice
+        for (int j = i; j > 0 && uniq[j - 1] > uniq[j]; --j) std::swap(uniq[j - 1], uniq[j]);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (!nu || cluster < 0) return set;
+    const long want = uniq[cluster < nu ? cluster : nu - 1];
+    for (int c = 0; c < ncpu; ++c) if (khz[c] == want) CPU_SET(c, &set);
+    return set;
+}
+
+class NativeSensor {
+public:
+    static constexpr size_t kBatch = 128;
+    // xyz in g (3 per sample), ts in CLOCK_BOOTTIME ns; on the sensor thread.
+    using BatchFn = std::function<void(const float* xyz, const int64_t* ts, size_t n)>;
+
+    NativeSensor(const NativeSensorConfig& c, BatchFn fn) : cfg_(c), fn_(std::move(fn)) {}
+    NativeSensor(const NativeSensor&) = delete;
+    NativeSensor& operator=(const NativeSensor&) = delete;
+    ~NativeSensor() { stop(); }
+
+    // Starts the thread and waits until the sensor is registered; false (see
+    // error()) if there is no such sensor or the queue could not be set up.
+    bool start() {
+        if (th_.joinable()) return ok_;
+        sem_init(&ready_, 0, 0);
+        stop_.store(false, std::memory_order_relaxed);
+        th_ = std::thread([this] { run(); });
+        sem_wait(&ready_);
+        sem_destroy(&ready_);
+        if (!ok_) th_.join();
+        return ok_;
+    }
+    // Unregisters the sensor; no batch is delivered after it returns.
+    void stop() {
+        if (!th_.joinable()) return;
+        stop_.store(true, std::memory_order_release);
+        ALooper_wake(looper_);
+        th_.join();
+        ok_ = false;
+    }
+
+    bool running() const noexcept { return ok_; }
+    const char* error() const noexcept { return err_; }
+    bool prioritised() const noexcept { return prio_ok_; }
+    bool pinned() const noexcept { return pin_ok_; }
+    bool wake_up() const noexcept { return wake_; }
+    // Samples handed to the callback since start().
+    uint64_t samples() const noexcept { return samples_.load(std::memory_order_relaxed); }
+
+private:
+    using RegisterFn = int (*)(ASensorEventQueue*, const ASensor*, int32_t, int64_t);
+    using ForPackageFn = ASensorManager* (*)(const char*);
+
+    void ready(bool ok, const char* err) { ok_ = ok; err_ = err; sem_post(&ready_); }
+
+    void run() {
+        pthread_setname_np(pthread_self(), "SinyalistSensor");
+        prio_ok_ = setpriority(PRIO_PROCESS, gettid(), cfg_.nice) == 0;
+        if (cfg_.cluster != NativeSensorConfig::kClusterAny) {
+            cpu_set_t set = cluster_cpus(cfg_.cluster);
+            pin_ok_ = CPU_COUNT(&set) > 0 && sched_setaffinity(0, sizeof set, &set) == 0;
+        }
+
+        ASensorManager* mgr = nullptr;
+        if (auto fp = reinterpret_cast<ForPackageFn>(dlsym(RTLD_DEFAULT, "ASensorManager_getInstanceForPackage")))
+            mgr = fp("com.sinyalist");
+        if (!mgr) mgr = ASensorManager_getInstance();
+        const ASensor* s = mgr && cfg_.wake_up ? ASensorManager_getDefaultSensorEx(mgr, cfg_.type, true) : nullptr;
+        wake_ = s != nullptr;
+        if (!s && mgr) s = ASensorManager_getDefaultSensor(mgr, cfg_.type);
+        if (!s) { ready(false, "no such sensor"); return; }
+
+        looper_ = ALooper_prepare(0);
+        ASensorEventQueue* q = ASensorManager_createEventQueue(mgr, looper_, kIdent, nullptr, nullptr);
+        if (!q) { ready(false, "event queue unavailable"); return; }
+        int rc;
+        if (auto reg = reinterpret_cast<RegisterFn>(dlsym(RTLD_DEFAULT, "ASensorEventQueue_registerSensor")))
+            rc = reg(q, s, cfg_.sampling_us, cfg_.max_latency_us);
+        else if ((rc = ASensorEventQueue_enableSensor(q, s)) >= 0)
+            rc = ASensorEventQueue_setEventRate(q, s, std::max(cfg_.sampling_us, ASensor_getMinDelay(s)));
+        if (rc < 0) {
+            ASensorManager_destroyEventQueue(mgr, q);
+            ready(false, "sensor registration failed");
+            return;
+        }
+        ready(true, nullptr);
+
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (ALooper_pollOnce(-1, nullptr, nullptr, nullptr) != kIdent) continue;
+            drain(q);
+        }
+        ASensorEventQueue_disableSensor(q, s);
+        ASensorManager_destroyEventQueue(mgr, q);
+    }
+
+    // Everything queued, in batches of at most kBatch.
+    void drain(ASensorEventQueue* q) {
+        ASensorEvent ev[32];
+        ssize_t got;
+        while ((got = ASensorEventQueue_getEvents(q, ev, 32)) > 0) {
+            for (ssize_t i = 0; i < got; ++i) {
+                if (ev[i].type != cfg_.type) continue;
+                xyz_[3*n_] = ev[i].data[0] / kGravity;
+                xyz_[3*n_ + 1] = ev[i].data[1] / kGravity;
+                xyz_[3*n_ + 2] = ev[i].data[2] / kGravity;
+                ts_[n_] = ev[i].timestamp;
+                if (++n_ == kBatch) flush();
+            }
+        }
+        if (n_) flush();
+    }
+    void flush() {
+        fn_(xyz_, ts_, n_);
+        samples_.fetch_add(n_, std::memory_order_relaxed);
+        n_ = 0;
+    }
+
+    static constexpr int kIdent = 1;
+    static constexpr float kGravity = 9.81f;     // as SeismicEngine.kt
+
+    NativeSensorConfig cfg_;
+    BatchFn fn_;
+    std::thread th_;
+    sem_t ready_;
+    ALooper* looper_ = nullptr;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> samples_{0};
+    bool ok_ = false, prio_ok_ = false, pin_ok_ = false, wake_ = false;
+    const char* err_ = nullptr;
+    float xyz_[3*kBatch];
+    int64_t ts_[kBatch];
+    size_t n_ = 0;
+};
+
+} // namespace sinyalist::seismic
@@ -0,0 +1,689 @@
+// =============================================================================
+// SINYALIST — Host Replay Engine for recorded accelerometer traces
+// =============================================================================
+// Streams a recorded (or synthetic) trace through SeismicDetector exactly as
+// the device does — process_block() in sensor-FIFO-sized blocks — and times
+// the whole pipeline plus its main components in isolation.
+//
+// Trace formats (auto-detected by magic):
+//   CSV    — one sample per line: ts_ms,ax,ay,az (g). Lines starting with '#'
+//            or a non-numeric header line are skipped. Sample rate is
+//            estimated from the median timestamp step.
+//   Binary — "SRT1", little-endian:
+//            magic u32 | version u16 | reserved u16 | sample_rate f32 | n u32 |
+//            t0_ms u64 | xyz f32[3n] (interleaved) | dt_ms u32[n] (from t0)
+//
+// Traces at another rate than the detector's go through the C10 Resampler
+// first, as on the device.
+//
+// run_restart() simulates a service restart through a C14 state snapshot in
+// a SnapshotFile, and checks that a second writer on the same path is refused
+// while the first holds it.
+//
+// run_capture() attaches a C16 WaveformCapture as on the device and checks
+// each capture's C17 packed image against the trace it came from.
+//
+// TraceImage is an SRT1 trace used in place: the file mmap'd read-only (or
+// an in-memory image of a converted trace), so many threads replay it
+// without copies (sinyalist_sweep).
+//
+// Host-only; not part of the Android .so.
+// =============================================================================
+
+#pragma once
+#include "seismic_detector.hpp"
+#include "fixed_detector.hpp"
+#include "detector_bank.hpp"
+#include "resampler.hpp"
+#include "snapshot_file.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sinyalist::replay {
+
+struct Trace {
+    float sample_rate_hz = 50.0f;
+    std::vector<float> xyz;        // 3 floats per sample, interleaved
+    std::vector<uint64_t> ts;      // ms
+    size_t size() const noexcept { return ts.size(); }
+};
+
+constexpr uint32_t kTraceMagic = 0x31545253;   // "SRT1"
+constexpr uint16_t kTraceVersion = 1;
+
+inline float estimate_rate(const std::vector<uint64_t>& ts) {
+    if (ts.size() < 3) return 50.0f;
+    std::vector<uint64_t> d;
+    d.reserve(ts.size() - 1);
+    for (size_t i = 1; i < ts.size(); ++i) if (ts[i] > ts[i-1]) d.push_back(ts[i] - ts[i-1]);
+    if (d.empty()) return 50.0f;
+    std::nth_element(d.begin(), d.begin() + d.size() / 2, d.end());
+    return 1000.0f / float(d[d.size() / 2]);
+}
+
+inline bool load_csv(const char* path, Trace& out, std::string& err) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) { err = std::string("cannot open ") + path; return false; }
+    out = Trace{};
+    char line[256];
+    while (std::fgets(line, sizeof line, f)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        unsigned long long t; float x, y, z;
+        if (std::sscanf(line, "%llu,%f,%f,%f", &t, &x, &y, &z) != 4) continue;
+        out.ts.push_back(t);
+        out.xyz.push_back(x); out.xyz.push_back(y); out.xyz.push_back(z);
+    }
+    std::fclose(f);
+    if (out.ts.empty()) { err = std::string("no samples in ") + path; return false; }
+    out.sample_rate_hz = estimate_rate(out.ts);
+    return true;
+}
+
+inline bool load_binary(const char* path, Trace& out, std::string& err) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) { err = std::string("cannot open ") + path; return false; }
+    uint32_t magic = 0, n = 0; uint16_t ver = 0, rsv = 0; float fs = 0; uint64_t t0 = 0;
+    bool ok = std::fread(&magic, 4, 1, f) == 1 && std::fread(&ver, 2, 1, f) == 1 &&
+              std::fread(&rsv, 2, 1, f) == 1 && std::fread(&fs, 4, 1, f) == 1 &&
+              std::fread(&n, 4, 1, f) == 1 && std::fread(&t0, 8, 1, f) == 1;
+    if (!ok || magic != kTraceMagic || ver != kTraceVersion) {
+        std::fclose(f); err = std::string("not an SRT1 trace: ") + path; return false;
+    }
+    out = Trace{};
+    out.sample_rate_hz = fs;
+    out.xyz.resize(size_t(n) * 3);
+    std::vector<uint32_t> dt(n);
+    ok = std::fread(out.xyz.data(), sizeof(float), out.xyz.size(), f) == out.xyz.size() &&
+         std::fread(dt.data(), sizeof(uint32_t), n, f) == n;
+    std::fclose(f);
+    if (!ok) { err = std::string("truncated trace: ") + path; return false; }
+    out.ts.resize(n);
+    for (uint32_t i = 0; i < n; ++i) out.ts[i] = t0 + dt[i];
+    return true;
+}
+
+constexpr size_t kTraceHeader = 24;
+
+// The SRT1 file contents for t.
+inline std::vector<uint8_t> encode_binary(const Trace& t) {
+    uint32_t n = uint32_t(t.size()); uint16_t rsv = 0;
+    uint64_t t0 = n ? t.ts[0] : 0;
+    std::vector<uint8_t> b(kTraceHeader + size_t(n) * 16);
+    uint8_t* p = b.data();
+    auto put = [&p](const void* v, size_t k) { std::memcpy(p, v, k); p += k; };
+    put(&kTraceMagic, 4); put(&kTraceVersion, 2); put(&rsv, 2);
+    put(&t.sample_rate_hz, 4); put(&n, 4); put(&t0, 8);
+    put(t.xyz.data(), t.xyz.size() * sizeof(float));
+    for (uint32_t i = 0; i < n; ++i) { uint32_t dt = uint32_t(t.ts[i] - t0); put(&dt, 4); }
+    return b;
+}
+
+inline bool save_binary(const char* path, const Trace& t, std::string& err) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) { err = std::string("cannot create ") + path; return false; }
+    std::vector<uint8_t> b = encode_binary(t);
+    bool ok = std::fwrite(b.data(), 1, b.size(), f) == b.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) err = std::string("write failed: ") + path;
+    return ok;
+}
+
+// An SRT1 trace read in place. Samples are xyz()[3i..3i+2] at t0() + dt()[i].
+class TraceImage {
+public:
+    TraceImage() = default;
+    TraceImage(TraceImage&& o) noexcept { *this = std::move(o); }
+    TraceImage& operator=(TraceImage&& o) noexcept {
+        if (this != &o) {
+            unmap();
+            map_ = o.map_; len_ = o.len_; mem_ = std::move(o.mem_); hdr_ = o.hdr_;
+            o.map_ = nullptr; o.len_ = 0; o.hdr_ = {};
+        }
+        return *this;
+    }
+    TraceImage(const TraceImage&) = delete;
+    TraceImage& operator=(const TraceImage&) = delete;
+    ~TraceImage() { unmap(); }
+
+    // Maps an SRT1 file read-only; pages are shared with every other mapping.
+    bool map(const char* path, std::string& err) {
+        unmap();
+        int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { err = std::string("cannot open ") + path; return false; }
+        struct stat st;
+        size_t len = fstat(fd, &st) == 0 ? size_t(st.st_size) : 0;
+        void* m = len >= kTraceHeader ? mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (m == MAP_FAILED) { err = std::string("cannot map ") + path; return false; }
+        map_ = static_cast<const uint8_t*>(m); len_ = len;
+        if (!parse(map_, len_)) { unmap(); err = std::string("not an SRT1 trace: ") + path; return false; }
+        return true;
+    }
+    // Takes a trace decoded some other way (CSV, resampled) as its image.
+    void adopt(const Trace& t) {
+        unmap();
+        mem_ = encode_binary(t);
+        parse(mem_.data(), mem_.size());
+    }
+
+    bool mapped() const noexcept { return map_ != nullptr; }
+    float sample_rate_hz() const noexcept { return hdr_.fs; }
+    size_t size() const noexcept { return hdr_.n; }
+    uint64_t t0() const noexcept { return hdr_.t0; }
+    const float* xyz() const noexcept { return hdr_.xyz; }
+    const uint32_t* dt() const noexcept { return hdr_.dt; }
+    double seconds() const noexcept { return hdr_.fs > 0 ? double(hdr_.n) / double(hdr_.fs) : 0; }
+
+private:
+    struct Header { float fs = 0; uint32_t n = 0; uint64_t t0 = 0; const float* xyz = nullptr; const uint32_t* dt = nullptr; };
+
+    bool parse(const uint8_t* p, size_t len) noexcept {
+        uint32_t magic, n; uint16_t ver; Header h;
+        std::memcpy(&magic, p, 4); std::memcpy(&ver, p + 4, 2);
+        std::memcpy(&h.fs, p + 8, 4); std::memcpy(&n, p + 12, 4); std::memcpy(&h.t0, p + 16, 8);
+        if (magic != kTraceMagic || ver != kTraceVersion || len < kTraceHeader + uint64_t(n) * 16) return false;
+        h.n = n;
+        h.xyz = reinterpret_cast<const float*>(p + kTraceHeader);   // offsets 24 and 24+12n: 4-aligned
+        h.dt = reinterpret_cast<const uint32_t*>(p + kTraceHeader + size_t(n) * 12);
+        hdr_ = h;
+        return true;
+    }
+    void unmap() noexcept {
+        if (map_) munmap(const_cast<uint8_t*>(map_), len_);
+        map_ = nullptr; len_ = 0; mem_.clear(); hdr_ = {};
+    }
+
+    const uint8_t* map_ = nullptr;
+    size_t len_ = 0;
+    std::vector<uint8_t> mem_;
+    Header hdr_;
+};
+
+inline bool load_trace(const char* path, Trace& out, std::string& err) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) { err = std::string("cannot open ") + path; return false; }
+    uint32_t magic = 0;
+    bool bin = std::fread(&magic, 4, 1, f) == 1 && magic == kTraceMagic;
+    std::fclose(f);
+    return bin ? load_binary(path, out, err) : load_csv(path, out, err);
+}
+
+// Deterministic test trace: face-up phone on a desk with sensor noise, a
+// walking segment (2 Hz, should be rejected), a drop-like single-axis spike
+// and a 3-axis broadband P-wave-like burst.
+inline Trace synthesize(float fs, uint32_t seconds, uint32_t seed = 1) {
+    Trace t; t.sample_rate_hz = fs;
+    size_t n = size_t(fs * float(seconds));
+    t.xyz.resize(n * 3); t.ts.resize(n);
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0.0f, 0.002f);
+    const float pi2 = 6.2831853f;
+    for (size_t i = 0; i < n; ++i) {
+        float s = float(i) / fs;
+        float x = noise(rng), y = noise(rng), z = -1.0f + noise(rng);
+        float u = std::fmod(s, 300.0f);
+        if (u >= 60.0f && u < 90.0f) z += 0.12f * std::sin(pi2 * 2.0f * s);        // walking
+        if (u >= 150.0f && u < 150.1f) x += 0.8f;                                    // knock/drop
+        if (u >= 220.0f && u < 232.0f) {                                             // P-wave burst
+            float e = 0.15f * std::exp(-(u - 220.0f) / 4.0f);
+            x += e * std::sin(pi2 * 4.0f * s);
+            y += e * std::sin(pi2 * 5.3f * s + 1.0f);
+            z += e * std::sin(pi2 * 6.1f * s + 2.0f);
+        }
+        t.xyz[3*i] = x; t.xyz[3*i+1] = y; t.xyz[3*i+2] = z;
+        t.ts[i] = uint64_t(1000.0 * double(i) / double(fs));
+    }
+    return t;
+}
+
+// C10: trace resampled to `hz` through Resampler (ms timestamps → ns, so the
+// ms quantisation acts as timestamp jitter). ns receives the wall time.
+inline Trace resample(const Trace& t, float hz, double* ns = nullptr) {
+    Trace r; r.sample_rate_hz = hz;
+    r.xyz.reserve(size_t(double(t.xyz.size()) * hz / t.sample_rate_hz) + 3);
+    r.ts.reserve(size_t(double(t.size()) * hz / t.sample_rate_hz) + 1);
+    seismic::Resampler rs(hz);
+    auto a = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < t.size(); ++i)
+        rs.push(t.xyz[3*i], t.xyz[3*i+1], t.xyz[3*i+2], int64_t(t.ts[i]) * 1000000,
+                [&](float x, float y, float z, int64_t tn) {
+                    r.xyz.push_back(x); r.xyz.push_back(y); r.xyz.push_back(z);
+                    r.ts.push_back(uint64_t(tn / 1000000));
+                });
+    if (ns) *ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - a).count());
+    return r;
+}
+
+struct RunResult {
+    std::vector<seismic::SeismicEvent> events;
+    uint64_t samples = 0;
+    double ns = 0;                                  // wall time, all repeats
+    uint64_t gated = 0, wakes = 0;                  // C9 pre-gate, first repeat
+    uint64_t profile[seismic::kProfileWords] = {};  // C20 export_words(), all repeats
+    double ns_per_sample() const noexcept { return samples ? ns / double(samples) : 0; }
+    double samples_per_s() const noexcept { return ns > 0 ? double(samples) * 1e9 / ns : 0; }
+};
+
+using Clock = std::chrono::steady_clock;
+inline double elapsed_ns(Clock::time_point a, Clock::time_point b) {
+    return double(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count());
+}
+
+// Full pipeline. Events are collected from the first repeat only. Math is
+// seismic::FloatMath or the C15 FixedMath; C19: with a RecordingSink the
+// event path inlines and telemetry compiles out.
+template<class Math = seismic::FloatMath>
+inline RunResult run(const Trace& t, const seismic::Config& cfg,
+                     size_t block = 64, uint32_t repeat = 1) {
+    RunResult r;
+    bool record = true;
+    seismic::BasicSeismicDetector<seismic::RecordingSink, Math> det(seismic::RecordingSink{&r.events});
+    det.update_config(cfg);
+    auto t0 = Clock::now();
+    for (uint32_t k = 0; k < repeat; ++k) {
+        det.reset();
+        for (size_t i = 0; i < t.size(); i += block) {
+            size_t m = std::min(block, t.size() - i);
+            det.process_block(t.xyz.data() + 3 * i, t.ts.data() + i, m);
+        }
+        if (record) { r.gated = det.gated_samples(); r.wakes = det.wakes(); }
+        record = false; det.sink().out = nullptr;
+    }
+    r.ns = elapsed_ns(t0, Clock::now());
+    r.samples = uint64_t(t.size()) * repeat;
+    det.profile().export_words(r.profile);
+    return r;
+}
+
+// Per-component cost measured by running each stage alone over the trace.
+struct ComponentTimes {
+    double filter_ns = 0;       // C2 gravity + band-pass + HP chain, per sample
+    double windows_ns = 0;      // STA/LTA/calibration rings (or C8 recursive) + mean/var
+    double periodicity_ns = 0;  // C3 tracker push while idle (the lag sums only run while confirming)
+    double full_ns = 0;         // complete process_sample()
+};
+
+inline ComponentTimes time_components(const Trace& t, const seismic::Config& cfg,
+                                      uint32_t repeat = 1) {
+    using namespace seismic;
+    ComponentTimes c;
+    const size_t n = t.size();
+    if (n == 0) return c;
+    const double total = double(n) * repeat;
+    std::vector<float> mag(n);
+    volatile float sink = 0;
+
+    AxisFilterChain fc(filter_design_for(cfg.sample_rate_hz));
+    fc.set_hp_alpha(cfg.hp_alpha);
+    auto a = Clock::now();
+    for (uint32_t k = 0; k < repeat; ++k) {
+        fc.reset();
+        for (size_t i = 0; i < n; ++i) {
+            simd::f4 f = fc.process(t.xyz[3*i], t.xyz[3*i+1], t.xyz[3*i+2]);
+            float x = simd::lane(f, 0), y = simd::lane(f, 1), z = simd::lane(f, 2);
+            mag[i] = std::sqrt(x*x + y*y + z*z);
+        }
+    }
+    c.filter_ns = elapsed_ns(a, Clock::now()) / total;
+
+    if (cfg.window_mode == WindowMode::RECURSIVE) {
+        RecursiveStaLta rec;
+        a = Clock::now();
+        for (uint32_t k = 0; k < repeat; ++k) {
+            rec.configure(cfg.sta_window, cfg.lta_window, cfg.calib_window);
+            float acc = 0;
+            for (size_t i = 0; i < n; ++i) {
+                rec.push(mag[i]);
+                acc += rec.sta / (rec.lta + 1e-9f) + rec.var;
+            }
+            sink = acc;
+        }
+    } else {
+        Ring<float,128> sta; Ring<float,2048> lta; Ring<float,8192> cal;
+        a = Clock::now();
+        for (uint32_t k = 0; k < repeat; ++k) {
+            sta.set_cap(cfg.sta_window); lta.set_cap(cfg.lta_window); cal.set_cap(cfg.calib_window);
+            float acc = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sta.push(mag[i]); lta.push(mag[i]); cal.push(mag[i]);
+                acc += sta.avg() / (lta.avg() + 1e-9f) + cal.var();
+            }
+            sink = acc;
+        }
+    }
+    c.windows_ns = elapsed_ns(a, Clock::now()) / total;
+
+    PeriodicityTracker<1024,64> per;
+    a = Clock::now();
+    for (uint32_t k = 0; k < repeat; ++k) {
+        per.configure(uint32_t(4.f*cfg.sample_rate_hz),
+                      uint32_t(cfg.sample_rate_hz/2.5f), uint32_t(cfg.sample_rate_hz/1.5f));
+        for (size_t i = 0; i < n; ++i) per.push(mag[i]);
+        per.track(true);
+        sink = per.score();
+    }
+    c.periodicity_ns = elapsed_ns(a, Clock::now()) / total;
+    (void)sink;
+
+    c.full_ns = run(t, cfg, 64, repeat).ns_per_sample();
+    return c;
+}
+
+// C2: the lane-parallel AxisFilterChain (NEON on ARM, three scalar lanes
+// elsewhere) against the per-axis chain it replaced, on the same input.
+// Bit-for-bit unless a*b+c is contracted (not in the host build, see
+// CMakeLists.txt) or ARMv7 NEON flushes denormals; then < kTolG.
+struct FilterCheck {
+    static constexpr double kTolG = 1e-6;
+    double max_err_g = 0;
+    uint64_t samples = 0, exact = 0;           // exact: all three axes identical
+    bool ok() const noexcept { return max_err_g < kTolG; }
+};
+
+inline FilterCheck compare_filter_chain(const Trace& t, const seismic::Config& cfg) {
+    using namespace seismic;
+    FilterCheck r;
+    const FilterDesign& d = filter_design_for(cfg.sample_rate_hz);
+    AxisFilterChain fc(d);
+    fc.set_hp_alpha(cfg.hp_alpha);
+    GravityEstimator g; g.alpha = d.grav_alpha;
+    BandPassFilter bp[3] = {BandPassFilter(d), BandPassFilter(d), BandPassFilter(d)};
+    HighPassState hp[3];
+    for (size_t i = 0; i < t.size(); ++i) {
+        const float* p = &t.xyz[3*i];
+        simd::f4 v = fc.process(p[0], p[1], p[2]);
+        g.update(p[0], p[1], p[2]);
+        const float s[3] = {hp[0].process(bp[0].process(g.linX(p[0])), cfg.hp_alpha),
+                            hp[1].process(bp[1].process(g.linY(p[1])), cfg.hp_alpha),
+                            hp[2].process(bp[2].process(g.linZ(p[2])), cfg.hp_alpha)};
+        bool same = true;
+        for (int k = 0; k < 3; ++k) {
+            float l = simd::lane(v, k);
+            same = same && l == s[k];
+            r.max_err_g = std::max(r.max_err_g, std::abs(double(l) - double(s[k])));
+        }
+        r.exact += same; ++r.samples;
+    }
+    return r;
+}
+
+// DetectorBank throughput: `streams` copies of the trace, stream i rotated by
+// i*97 samples so streams are out of phase. Fed in sample-major chunks. The
+// first `verify` streams are cross-checked against a standalone detector.
+struct BankResult {
+    uint64_t stream_samples = 0;
+    double ns = 0;
+    size_t events = 0;
+    uint32_t verified = 0, mismatches = 0;
+    size_t bytes = 0;
+    unsigned threads = 0;
+    double ns_per_stream_sample() const noexcept { return stream_samples ? ns / double(stream_samples) : 0; }
+};
+
+inline bool same_event(const seismic::SeismicEvent& a, const seismic::SeismicEvent& b) {
+    return a.level == b.level && a.peak_g == b.peak_g && a.sta_lta == b.sta_lta &&
+           a.freq_hz == b.freq_hz && a.time_ms == b.time_ms && a.duration == b.duration;
+}
+
+// C15: same trigger decisions — every event at the same level, its onset
+// within one sample and its duration within 2%. A crossing on a slow STA/LTA
+// slope moves with the last bits of the ratio (float ring sums also drift
+// after a large event, the int64 ones do not), so exact times are not required.
+inline bool same_decisions(const std::vector<seismic::SeismicEvent>& a,
+                           const std::vector<seismic::SeismicEvent>& b, float fs) {
+    if (a.size() != b.size()) return false;
+    const double dt_ms = 1000.0 / double(fs);
+    for (size_t k = 0; k < a.size(); ++k) {
+        double dt = std::abs(double(a[k].time_ms) - double(b[k].time_ms));
+        double dd = std::abs(double(a[k].duration) - double(b[k].duration));
+        if (a[k].level != b[k].level || dt > dt_ms + 0.5 || dd > std::max(1.0, 0.02 * a[k].duration))
+            return false;
+    }
+    return true;
+}
+
+inline BankResult run_bank(const Trace& t, const seismic::Config& cfg, uint32_t streams,
+                           unsigned threads = 0, uint32_t verify = 4) {
+    BankResult r;
+    const size_t n = t.size();
+    if (n == 0 || streams == 0) return r;
+    seismic::Config full = cfg;
+    full.pregate = false;                           // DetectorBank has no pre-gate
+    std::vector<std::vector<seismic::SeismicEvent>> got(std::min(verify, streams));
+    seismic::DetectorBank bank(streams, full, [&](uint32_t s, const seismic::SeismicEvent& e) {
+        ++r.events;
+        if (s < got.size()) got[s].push_back(e);
+    }, threads);
+    r.bytes = bank.bytes(); r.threads = bank.threads();
+
+    constexpr size_t kChunk = 256;
+    std::vector<float> xyz(kChunk * streams * 3);
+    std::vector<uint64_t> ts(kChunk * streams);
+    for (size_t c = 0; c < n; c += kChunk) {
+        size_t m = std::min(kChunk, n - c);
+        for (size_t k = 0; k < m; ++k)
+            for (uint32_t s = 0; s < streams; ++s) {
+                size_t src = (c + k + size_t(s) * 97) % n, dst = k * streams + s;
+                std::memcpy(&xyz[dst * 3], &t.xyz[src * 3], 3 * sizeof(float));
+                ts[dst] = t.ts[c + k];
+            }
+        auto a = Clock::now();
+        bank.run(xyz.data(), ts.data(), m);
+        r.ns += elapsed_ns(a, Clock::now());
+    }
+    r.stream_samples = uint64_t(n) * streams;
+
+    for (uint32_t s = 0; s < got.size(); ++s) {
+        std::vector<seismic::SeismicEvent> ref;
+        seismic::BasicSeismicDetector<seismic::RecordingSink> det(seismic::RecordingSink{&ref});
+        det.update_config(full);
+        for (size_t i = 0; i < n; ++i) {
+            size_t src = (i + size_t(s) * 97) % n;
+            det.process_sample(t.xyz[3*src], t.xyz[3*src+1], t.xyz[3*src+2], t.ts[i]);
+        }
+        bool ok = ref.size() == got[s].size();
+        for (size_t k = 0; ok && k < ref.size(); ++k) ok = same_event(ref[k], got[s][k]);
+        ++r.verified; if (!ok) ++r.mismatches;
+    }
+    return r;
+}
+
+// C14: the detector is snapshotted at at_s, the next gap_s of samples are
+// lost (the service is down), then a new detector resumes from the snapshot
+// (warm) or from scratch (cold). Events from the resume point on are compared
+// with an uninterrupted run over the same samples.
+struct RestartResult {
+    size_t bytes = 0;
+    bool restored = false, match = false;
+    bool exclusive = false;                // a second open() of the file failed
+    size_t full = 0, warm = 0, cold = 0;   // events after the resume point
+};
+
+inline RestartResult run_restart(const Trace& t, const seismic::Config& cfg, float at_s, float gap_s) {
+    RestartResult r;
+    size_t cut = std::min(t.size(), size_t(at_s * t.sample_rate_hz));
+    size_t resume = std::min(t.size(), cut + size_t(gap_s * t.sample_rate_hz));
+    if (cut == 0 || resume >= t.size()) return r;
+    auto feed = [&](seismic::SeismicDetector& d, size_t a, size_t b) {
+        for (size_t i = a; i < b; i += 64)
+            d.process_block(t.xyz.data() + 3 * i, t.ts.data() + i, std::min<size_t>(64, b - i));
+    };
+    std::vector<seismic::SeismicEvent> full, warm;
+    seismic::SeismicDetector ref([&](const seismic::SeismicEvent& e) {
+        if (e.time_ms >= t.ts[resume]) full.push_back(e);
+    });
+    ref.update_config(cfg);
+    feed(ref, 0, cut);
+    const char* tmp = std::getenv("TMPDIR");
+    std::string path = std::string(tmp && *tmp ? tmp : "/tmp") + "/sinyalist_snapshot_XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd < 0) return r;
+    ::close(fd);
+    {
+        // The old service and a second engine on the same sensor.
+        seismic::SnapshotFile a, b;
+        if (a.open(path.c_str(), seismic::SeismicDetector::snapshot_capacity())) {
+            r.exclusive = !b.open(path.c_str(), seismic::SeismicDetector::snapshot_capacity());
+            a.write([&](void* dst, size_t cap) { return r.bytes = ref.snapshot(dst, cap, t.ts[cut - 1]); });
+        }
+    }
+    feed(ref, cut, t.size());
+
+    seismic::SeismicDetector w([&](const seismic::SeismicEvent& e) { warm.push_back(e); });
+    w.update_config(cfg);
+    {
+        // The restarted service, once the old one has let go of the file.
+        seismic::SnapshotFile f;
+        size_t n = 0; const void* img = nullptr;
+        if (f.open(path.c_str(), seismic::SeismicDetector::snapshot_capacity())) img = f.latest(n);
+        r.restored = img && w.restore(img, n, t.ts[resume], uint64_t(gap_s * 1000.f) + 1000);
+    }
+    ::unlink(path.c_str());
+    feed(w, resume, t.size());
+    seismic::SeismicDetector c([&](const seismic::SeismicEvent&) { ++r.cold; });
+    c.update_config(cfg);
+    feed(c, resume, t.size());
+
+    r.full = full.size(); r.warm = warm.size();
+    r.match = full.size() == warm.size();
+    for (size_t k = 0; r.match && k < full.size(); ++k) r.match = same_event(full[k], warm[k]);
+    return r;
+}
+
+// C26: LTA mean and calibration variance of compact and float rings over
+// the same filtered magnitudes, both against double-precision windows (the
+// float running sums drift too after a large event), then the full detector
+// with Config::window_storage set; the caller compares run.events with float.
+// Against double rings: the LTA mean within 1% (u16 steps are 6e-5 g), the
+// calibration variance within 10% or twice the float rings' own error,
+// which grows with the window at 200 Hz.
+struct StorageResult {
+    static constexpr double kLtaTol = 1e-2, kVarTol = 0.1;
+    double lta_err = 0, var_err = 0;           // compact: max relative error once the LTA is full
+    double lta_err_f32 = 0, var_err_f32 = 0;   // float rings, same measure
+    double windows_ns = 0;             // as ComponentTimes::windows_ns
+    size_t bytes = 0, float_bytes = 0; // LTA + calibration sample storage
+    RunResult run;
+    bool quality_ok() const noexcept {
+        return lta_err < kLtaTol && var_err < std::max(kVarTol, 2 * var_err_f32);
+    }
+};
+
+template<typename S>
+inline void compare_windows(const std::vector<float>& mag, const seismic::Config& cfg,
+                            uint32_t repeat, StorageResult& r) {
+    using namespace seismic;
+    Ring<double,2048> lta; Ring<double,8192> cal;
+    Ring<float,2048> flta; Ring<float,8192> fcal;
+    Ring<float,2048,float,S> clta; Ring<float,8192,float,S> ccal;
+    lta.set_cap(cfg.lta_window); cal.set_cap(cfg.calib_window);
+    flta.set_cap(cfg.lta_window); fcal.set_cap(cfg.calib_window);
+    clta.set_cap(cfg.lta_window); ccal.set_cap(cfg.calib_window);
+    auto err = [](double& e, double v, double ref) { if (ref > 0) e = std::max(e, std::abs(v / ref - 1.0)); };
+    for (float m : mag) {
+        lta.push(m); cal.push(m); flta.push(m); fcal.push(m); clta.push(m); ccal.push(m);
+        if (!lta.full()) continue;
+        err(r.lta_err, clta.avg(), lta.avg()); err(r.var_err, ccal.var(), cal.var());
+        err(r.lta_err_f32, flta.avg(), lta.avg()); err(r.var_err_f32, fcal.var(), cal.var());
+    }
+    r.bytes = sizeof(S) * (2048 + 8192); r.float_bytes = sizeof(float) * (2048 + 8192);
+
+    Ring<float,128> sta;
+    volatile float sink = 0;
+    auto a = Clock::now();
+    for (uint32_t k = 0; k < repeat; ++k) {
+        sta.set_cap(cfg.sta_window); clta.set_cap(cfg.lta_window); ccal.set_cap(cfg.calib_window);
+        float acc = 0;
+        for (float m : mag) {
+            sta.push(m); clta.push(m); ccal.push(m);
+            acc += sta.avg() / (clta.avg() + 1e-9f) + ccal.var();
+        }
+        sink = acc;
+    }
+    (void)sink;
+    r.windows_ns = elapsed_ns(a, Clock::now()) / (double(mag.size()) * repeat);
+}
+
+inline StorageResult compare_storage(const Trace& t, const seismic::Config& cfg,
+                                     size_t block = 64, uint32_t repeat = 1) {
+    using namespace seismic;
+    StorageResult r;
+    const size_t n = t.size();
+    if (n == 0) return r;
+    std::vector<float> mag(n);
+    AxisFilterChain fc(filter_design_for(cfg.sample_rate_hz));
+    fc.set_hp_alpha(cfg.hp_alpha);
+    for (size_t i = 0; i < n; ++i) {
+        simd::f4 f = fc.process(t.xyz[3*i], t.xyz[3*i+1], t.xyz[3*i+2]);
+        float x = simd::lane(f, 0), y = simd::lane(f, 1), z = simd::lane(f, 2);
+        mag[i] = std::sqrt(x*x + y*y + z*z);
+    }
+    if (cfg.window_storage == WindowStorage::F16) compare_windows<Half>(mag, cfg, repeat, r);
+    else if (cfg.window_storage == WindowStorage::U16) compare_windows<UQ14>(mag, cfg, repeat, r);
+    else compare_windows<float>(mag, cfg, repeat, r);
+    r.run = run(t, cfg, block, repeat);
+    return r;
+}
+
+// C16/C17: captures as the dispatcher delivers them (WaveformCapture::pack()).
+// A capture verifies if each axis decodes to exactly the counts its source
+// floats quantise to and unpack_waveform() comes back within half a count.
+struct CaptureResult {
+    uint32_t captures = 0, verified = 0;
+    size_t float_bytes = 0, packed_bytes = 0;
+    double max_err_g = 0;                      // unpacked vs source, unsaturated samples
+};
+
+inline CaptureResult run_capture(const Trace& t, const seismic::Config& cfg,
+                                 float pre_s = 10.0f, float post_s = 60.0f) {
+    using namespace seismic;
+    CaptureResult r;
+    WaveformCapture cap;
+    cap.configure(cfg.sample_rate_hz, 4, uint32_t(pre_s * cfg.sample_rate_hz), uint32_t(post_s * cfg.sample_rate_hz));
+    BasicSeismicDetector<RecordingSink> det(RecordingSink{});
+    det.update_config(cfg);
+    det.set_capture(&cap);
+    std::vector<uint8_t> img(cap.packed_bytes());
+    std::vector<float> xyz; std::vector<int32_t> counts;
+    auto check = [&](const WaveformCapture::View& v) {
+        ++r.captures; r.float_bytes += v.bytes;
+        size_t b = WaveformCapture::pack(v, img.data(), img.size());
+        if (!b) return;
+        r.packed_bytes += b;
+        const uint8_t* p = img.data() + sizeof(WaveformCapture::Header);
+        PackedWaveformHeader h;
+        std::memcpy(&h, p, sizeof(h));
+        const size_t n = v.header().samples;
+        counts.resize(n); xyz.resize(3 * n);
+        size_t at = sizeof(h);
+        for (int a = 0; a < 3; ++a) {
+            if (steim2_decode(p + at, h.bytes[a], counts.data(), n) != n) return;
+            for (size_t i = 0; i < n; ++i)
+                if (counts[i] != to_counts(v.xyz()[3*i + a], h.counts_per_g)) return;
+            at += h.bytes[a];
+        }
+        if (unpack_waveform(p, b - sizeof(WaveformCapture::Header), xyz.data(), n, counts.data()) != n) return;
+        for (size_t i = 0; i < 3 * n; ++i)
+            if (std::abs(v.xyz()[i]) * h.counts_per_g < 32767.0f)
+                r.max_err_g = std::max(r.max_err_g, double(std::abs(xyz[i] - v.xyz()[i])));
+        ++r.verified;
+    };
+    WaveformCapture::View v;
+    for (size_t i = 0; i < t.size(); i += 64) {
+        det.process_block(t.xyz.data() + 3 * i, t.ts.data() + i, std::min<size_t>(64, t.size() - i));
+        while (cap.acquire(v)) { check(v); cap.release(v); }
+    }
+    return r;
+}
+
+} // namespace sinyalist::replay
@@ -0,0 +1,153 @@
+// =============================================================================
+// SINYALIST — Resampler: native-rate sensor stream → detector nominal rate
+// =============================================================================
+// C10: Android delivers accelerometer samples at a device-dependent rate with
+// jittery timestamps, while the detector assumes a fixed Config::dt() for
+// windows, cooldown and frequency estimates. Resampler sits in front of it:
+//
+//   1. input clock   — a 2nd-order tracking loop (phase + period) smooths the
+//                      sensor timestamps so delivery jitter does not turn into
+//                      amplitude noise; a gap restarts the stream
+//   2. anti-alias    — windowed-sinc FIR, cutoff 0.45·min(Fs_in, Fs_out),
+//                      designed once the input rate is known (and again if it
+//                      drifts by more than 10%) into storage sized for the
+//                      longest filter, so a redesign on the sensor thread
+//                      does not allocate
+//   3. polyphase     — kPhases precomputed fractional-delay rows; each output
+//                      on the exact 1/Fs_out grid costs 2·half_taps() MACs/axis
+//
+// Output lags input by half the FIR length (~4 output periods).
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace sinyalist::seismic {
+
+class Resampler {
+public:
+    static constexpr uint32_t kPhases  = 32;    // fractional delay step: 1/32 input sample
+    static constexpr uint32_t kMaxHalf = 96;    // taps per side; Fs_in/Fs_out up to ~19
+    static constexpr uint32_t kHist    = 256;   // pow2 history, ≥ 2·kMaxHalf + slack
+    static constexpr uint32_t kStartup = 32;    // samples for the initial rate estimate
+    static constexpr double   kLobes   = 4.0;   // sinc zero crossings per side
+    static constexpr double   kGap     = 3.0;   // off by this many periods → restart
+
+    explicit Resampler(float out_hz = 50.0f) { configure(out_hz); }
+
+    void configure(float out_hz) {
+        out_dt_ = 1e9 / double(out_hz); design_dt_ = 0; reset();
+    }
+
+    // Forgets the stream (history, clock); the last FIR design is kept.
+    void reset() noexcept { n_ = 0; j_ = 0; th_n_ = 0; next_ = -1; }
+
+    // Smoothed input rate once known, else 0.
+    float input_rate_hz() const noexcept { return n_ >= kStartup ? float(1e9 / dt_) : 0.0f; }
+    uint32_t half_taps() const noexcept { return half_; }
+    uint64_t restarts() const noexcept { return restarts_; }
+
+    // One sensor sample; out(x, y, z, t_ns) for every output it completes.
+    // Timestamps may jitter (even go backwards) by up to kGap periods; a
+    // larger jump either way restarts the stream.
+    template<class Sink>
+    void push(float x, float y, float z, int64_t t_ns, Sink&& out) {
+        const double t = double(t_ns);
+        if (n_ >= kStartup && std::abs(t - (th_n_ + dt_)) > kGap * dt_) { ++restarts_; reset(); }
+
+        uint32_t a = n_++, s = a & (kHist - 1);
+        bx_[s] = bx_[s + kHist] = x; by_[s] = by_[s + kHist] = y; bz_[s] = bz_[s + kHist] = z;
+
+        if (n_ < kStartup) { th_[s] = t; return; }        // raw until the rate is known
+        if (n_ == kStartup) { th_[s] = t; start(); }
+        else {
+            double pred = th_n_ + dt_, e = t - pred;      // z² - 1.871z + 0.875: damped
+            th_n_ = pred + e * (1.0 / 8);
+            dt_ += e * (1.0 / 256);
+            th_[s] = th_n_;
+            if (std::abs(dt_ / design_dt_ - 1.0) > 0.1) design();
+        }
+        emit(out);
+    }
+
+    // C1-style block entry: xyz interleaved, n samples.
+    template<class Sink>
+    void push_block(const float* xyz, const int64_t* t_ns, size_t n, Sink&& out) {
+        for (size_t i = 0; i < n; ++i, xyz += 3) push(xyz[0], xyz[1], xyz[2], t_ns[i], out);
+    }
+
+private:
+    double out_dt_ = 2e7, dt_ = 0, design_dt_ = 0;   // ns
+    double th_[kHist] = {};                        // smoothed input times
+    float bx_[2 * kHist] = {}, by_[2 * kHist] = {}, bz_[2 * kHist] = {};   // mirrored
+    std::array<float, size_t(kPhases) * 2 * kMaxHalf> h_{};   // kPhases rows × 2·half_ taps (~24 KB)
+    uint32_t half_ = 0, n_ = 0, j_ = 0;            // j_: input sample left of next_
+    double th_n_ = 0, next_ = -1;                  // newest smoothed time, next output
+    uint64_t restarts_ = 0;
+
+    double at(uint32_t a) const noexcept { return th_[a & (kHist - 1)]; }
+
+    // Least-squares line through the startup timestamps seeds the loop.
+    void start() noexcept {
+        double mk = 0.5 * (kStartup - 1), sk = 0, st = 0, skt = 0, skk = 0;
+        for (uint32_t k = 0; k < kStartup; ++k) { double t = at(k); st += t; skt += k * t; skk += k * double(k); sk += k; }
+        dt_ = (skt - sk * st / kStartup) / (skk - sk * sk / kStartup);
+        double t0 = st / kStartup - mk * dt_;
+        for (uint32_t k = 0; k < kStartup; ++k) th_[k & (kHist - 1)] = t0 + k * dt_;
+        th_n_ = at(kStartup - 1);
+        if (design_dt_ <= 0 || std::abs(dt_ / design_dt_ - 1.0) > 0.1) design();
+        j_ = half_ - 1;
+        next_ = t0 + j_ * dt_;                         // first output has a full left half
+    }
+
+    void design() noexcept {
+        const double kPi = 3.14159265358979323846;
+        design_dt_ = dt_;
+        double fc = 0.45 * std::min(1.0, dt_ / out_dt_);       // cycles per input sample
+        half_ = std::clamp(uint32_t(std::ceil(kLobes / (2 * fc))), 2u, kMaxHalf);
+        uint32_t taps = 2 * half_;
+        for (uint32_t p = 0; p < kPhases; ++p) {
+            float* row = &h_[size_t(p) * taps];
+            double sum = 0;
+            for (uint32_t m = 0; m < taps; ++m) {
+                double u = double(m) - double(half_ - 1) - double(p) / kPhases;   // offset, samples
+                double x = 2 * fc * u;
+                double sinc = x == 0 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+                double w = std::abs(u) >= half_ ? 0.0
+                         : 0.42 + 0.5 * std::cos(kPi * u / half_) + 0.08 * std::cos(2 * kPi * u / half_);
+                row[m] = float(sinc * w); sum += sinc * w;
+            }
+            for (uint32_t m = 0; m < taps; ++m) row[m] = float(row[m] / sum);   // unity DC gain
+        }
+    }
+
+    template<class Sink>
+    void emit(Sink&& out) {
+        const uint32_t taps = 2 * half_, last = n_ - 1;
+        while (true) {
+            while (j_ + 1 <= last && at(j_ + 1) <= next_) ++j_;
+            if (j_ + half_ > last) return;                 // right half not here yet
+            if (j_ + 1 >= half_) {                         // left half available
+                double t0 = at(j_), d = std::clamp((next_ - t0) / (at(j_ + 1) - t0), 0.0, 1.0);
+                uint32_t p = uint32_t(d * kPhases + 0.5), j = j_;
+                if (p >= kPhases) { p = 0; ++j; }
+                if (j + half_ <= last) {
+                    const float* row = &h_[size_t(p) * taps];
+                    uint32_t s = (j - half_ + 1) & (kHist - 1);
+                    float ax = 0, ay = 0, az = 0;
+                    for (uint32_t m = 0; m < taps; ++m) {
+                        ax += row[m] * bx_[s + m]; ay += row[m] * by_[s + m]; az += row[m] * bz_[s + m];
+                    }
+                    out(ax, ay, az, int64_t(std::llround(next_)));
+                } else return;
+            }
+            next_ += out_dt_;
+        }
+    }
+};
+
+} // namespace sinyalist::seismic
@@ -13,18 +13,109 @@
 //   B2) Device orientation normalization — subtracts low-pass gravity vector
 //       so the detector responds to body acceleration only, regardless of
 //       whether the phone is flat, vertical, or tilted.
+// v2.2 UPGRADES:
+//   C1) Block processing API — process_block() consumes a whole sensor FIFO
+//       batch per call so the JNI transition is paid once per batch.
+//   C2) Lane-parallel filter chain — gravity LP, band-pass and legacy HP run
+//       on x/y/z packed into one 4-lane vector (NEON, scalar fallback).
+//   C3) Streaming periodicity — lag-product sums are maintained as samples
+//       enter/leave the window while a trigger candidate is open (seeded from
+//       the stored window on IDLE → CONFIRM); the autocorr score is O(lags).
+//   C4) Power-of-two Ring storage — index by mask instead of modulo, expose the
+//       live window as ≤2 contiguous spans, O(1) reset.
+//   C5) Compile-time filter design — band-pass and gravity coefficients are
+//       derived constexpr from (Fs, Fc) for 50/100/200 Hz and selected by
+//       Config::sample_rate_hz, which must be one of those (Config::valid());
+//       Config::at_rate() rescales the windows.
+//   C6) Async dispatch — events/telemetry go through lock-free SPSC queues to
+//       a native dispatcher thread attached to the JVM once; the sensor thread
+//       never calls into Java.
+//   C7) Shared-memory telemetry — DebugTelemetry records go into a fixed
+//       native ring that Kotlin maps once as a direct ByteBuffer and polls.
+//   C8) Recursive STA/LTA — opt-in exponential STA, LTA and noise variance
+//       (Config::window_mode); boxcar rings are then not allocated at all.
+//   C9) Energy pre-gate — opt-in first stage (Config::pregate) that runs
+//       alone while the device is quiet and, when it trips, warms the filter
+//       chain from its gravity estimate and pre-roll before handing over.
+//   C10) Resampling front-end (resampler.hpp) — the HAL runs at its native
+//       rate; jittery timestamps are smoothed and samples are anti-aliased
+//       and polyphase-resampled to Config::sample_rate_hz before detection.
+//   C11) Spectral bank — dominant frequency and in-band energy come from
+//       exponentially weighted sliding-DFT bins on the filtered axes instead
+//       of X-axis zero-crossings; both are O(bins) to read at any time.
+//   C12) Handle-based JNI — nativeCreate() returns an independent detector
+//       instance (own callback, dispatcher, resampler, telemetry ring), so
+//       several detectors can run side by side on their own threads.
+//   C13) Incremental reconfiguration — update_config() only rebuilds what a
+//       change touches: thresholds apply on the next sample and window
+//       resizes keep the newest samples, so a config push is not a blind spot.
+//   C14) State snapshot — snapshot()/restore() serialise the warm state
+//       (filters, gravity, windows, baseline) into a versioned image so a
+//       restarted service resumes detection at once instead of re-learning.
+//   C15) Fixed-point core (fixed_detector.hpp) — integer filter chain,
+//       magnitude and windows for armeabi-v7a softfp builds, as the
+//       FixedMath policy of the same detector; only samples near a trigger
+//       reach the shared float decision logic.
+//   C16) Waveform capture (waveform_capture.hpp) — raw xyz from a few
+//       seconds before the onset to the detrigger is frozen into a
+//       preallocated arena slot per event, without sensor-thread allocation.
+//   C17) Steim-2 waveform codec (steim2.hpp, C ABI in sinyalist_codec.h) —
+//       the dispatcher packs each capture before handing it to Kotlin.
+//   C18) dart:ffi C ABI (sinyalist_ffi.h) — Dart reads events, telemetry and
+//       stats and posts config straight from the .so; a NativeCallable
+//       listener is notified per event ahead of the JNI upcall.
+//   C19) Compile-time event sinks — the detector is templated on where events
+//       and telemetry go; SeismicDetector keeps the std::function callbacks.
+//   C20) Stage profile (stage_profile.hpp) — opt-in per-stage timing
+//       histograms of process_sample(), compiled out unless SINYALIST_PROFILE.
+//   C21) Core C ABI (sinyalist_detector.h) — the detector without JNI as a
+//       static library, so iOS runs this code instead of a Swift port.
+//   C22) Verification C ABI (sinyalist_verifier_* in sinyalist_detector.h) —
+//       the backend re-runs a reported waveform through a fresh detector
+//       and gets its events and rejections; no shared state between workers.
+//   C23) Trigger coincidence (coincidence_index.hpp) — reports from many
+//       devices are clustered by distance and P-wave-consistent arrival
+//       times in a bucketed sliding index, for the mesh layer and backend.
+//   C24) Latency trace (latency_trace.hpp) — each event is followed from its
+//       sensor timestamp through decision, dispatch and the Kotlin callback
+//       to Flutter delivery; per-hop histograms, optional atrace markers.
+//   C25) Native sensor thread (native_sensor.hpp) — optionally the library
+//       reads an ASensorEventQueue on its own prioritised, cluster-pinned
+//       thread, with no Java listener on the sample path.
+//   C26) Compact window storage — the LTA and calibration rings can hold
+//       fp16 or 16-bit fixed-point magnitudes (Config::window_storage) with
+//       float running sums, halving the boxcar windows' footprint.
 // =============================================================================
 
 #pragma once
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <array>
 #include <atomic>
 #include <functional>
 #include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "stage_profile.hpp"
+#include "waveform_capture.hpp"
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SINYALIST_NEON 1
+#endif
 
 namespace sinyalist::seismic {
 
+// C8: BOXCAR = exact moving averages over rings (default);
+// RECURSIVE = exponential averages with time constants of the same windows.
+enum class WindowMode : uint8_t { BOXCAR=0, RECURSIVE=1 };
+// C26: sample storage of the boxcar LTA and calibration rings (the STA ring
+// is small and stays float). F16 = IEEE half, ~3 significant digits at any
+// level; U16 = unsigned 2.14 fixed point, 6e-5 g steps saturating at 4 g.
+enum class WindowStorage : uint8_t { F32=0, F16=1, U16=2 };
+
 struct Config {
     float    sample_rate_hz       = 50.0f;
     float    hp_alpha             = 0.98f;
@@ -43,7 +134,51 @@ struct Config {
     float    adaptive_trig_min    = 3.5f;
     float    adaptive_trig_max    = 8.0f;
     float    periodicity_thresh   = 0.6f;     // autocorr threshold
+    WindowMode window_mode        = WindowMode::BOXCAR;   // C8
+    WindowStorage window_storage  = WindowStorage::F32;   // C26
+    // C9: energy pre-gate
+    bool     pregate              = false;
+    float    pregate_g            = 0.006f;   // RMS |a - gravity| that wakes the pipeline
+    uint32_t pregate_hold         = 1500;     // 30s quiet before sleeping again
+    uint32_t pregate_warmup       = 100;      // 2s pre-roll replayed on wake
     float dt() const noexcept { return 1.0f / sample_rate_hz; }
+
+    // C5: the rates with a filter design. Other sensor rates reach the
+    // detector through the C10 resampler at one of these.
+    static constexpr float kRates[] = {50.0f, 100.0f, 200.0f};
+    static bool rate_supported(float hz) noexcept {
+        return hz == kRates[0] || hz == kRates[1] || hz == kRates[2];
+    }
+    // The supported rate closest to hz (50 Hz for anything not above 0).
+    static float nearest_rate(float hz) noexcept {
+        return hz >= 150.0f ? kRates[2] : hz >= 75.0f ? kRates[1] : kRates[0];
+    }
+    // C4: boxcar ring capacities in samples. A window beyond them is refused,
+    // not truncated.
+    static constexpr uint32_t kMaxSta = 128, kMaxLta = 2048, kMaxCalib = 8192;
+    // A supported rate and windows of 1..capacity samples; detectors refuse
+    // anything else.
+    bool valid() const noexcept {
+        return rate_supported(sample_rate_hz) &&
+               sta_window >= 1 && sta_window <= kMaxSta && lta_window >= 1 && lta_window <= kMaxLta &&
+               calib_window >= 1 && calib_window <= kMaxCalib;
+    }
+
+    // C5: defaults rescaled for a supported rate — windows keep their
+    // duration in seconds and hp_alpha keeps its ~0.16 Hz cutoff. The
+    // calibration window is capped at the ring's 8192 samples, so at 200 Hz
+    // it covers ~41 s.
+    static Config at_rate(float hz) noexcept {
+        Config c; float k = hz / c.sample_rate_hz;
+        auto n = [k](uint32_t v) { return uint32_t(float(v) * k + 0.5f); };
+        c.sample_rate_hz = hz;
+        c.hp_alpha = std::pow(c.hp_alpha, 1.0f / k);
+        c.sta_window = n(c.sta_window); c.lta_window = n(c.lta_window);
+        c.min_sustained = n(c.min_sustained); c.cooldown = n(c.cooldown);
+        c.calib_window = std::min(n(c.calib_window), kMaxCalib);
+        c.pregate_hold = n(c.pregate_hold); c.pregate_warmup = n(c.pregate_warmup);
+        return c;
+    }
 };
 
 enum class AlertLevel : uint8_t { NONE=0, TREMOR=1, MODERATE=2, SEVERE=3, CRITICAL=4 };
@@ -71,7 +206,7 @@ struct HighPassState {
 // ---------------------------------------------------------------------------
 // B1: Biquad IIR section — one second-order section of a cascaded filter.
 // Implements the Direct Form II Transposed structure (numerically stable).
-// Coefficients (b0,b1,b2,a1,a2) are pre-computed for 50 Hz sample rate.
+// Coefficients (b0,b1,b2,a1,a2) come from the constexpr designs below (C5).
 // ---------------------------------------------------------------------------
 struct Biquad {
     float b0=1, b1=0, b2=0, a1=0, a2=0;
@@ -85,27 +220,85 @@ struct Biquad {
     void reset() noexcept { w1 = w2 = 0; }
 };
 
-// B1: Cascaded 2-pole Butterworth band-pass filter: 1–15 Hz @ 50 Hz Fs.
+// ---------------------------------------------------------------------------
+// C5: constexpr filter design. std::tan/std::exp are not constexpr in C++17,
+// so small Taylor-series versions are used (|x| ≤ π/2 after reduction; error
+// well below float precision). Evaluated entirely at compile time.
+// ---------------------------------------------------------------------------
+namespace design {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kSqrt2 = 1.41421356237309504880;
+
+constexpr double sin_cx(double x) noexcept {
+    double t = x, s = x;
+    for (int k = 1; k < 12; ++k) { t *= -x * x / double((2*k) * (2*k + 1)); s += t; }
+    return s;
+}
+constexpr double cos_cx(double x) noexcept {
+    double t = 1, s = 1;
+    for (int k = 1; k < 12; ++k) { t *= -x * x / double((2*k - 1) * (2*k)); s += t; }
+    return s;
+}
+constexpr double tan_cx(double x) noexcept { return sin_cx(x) / cos_cx(x); }
+constexpr double exp_cx(double x) noexcept {
+    double t = 1, s = 1;
+    for (int k = 1; k < 30; ++k) { t *= x / double(k); s += t; }
+    return s;
+}
+
+// 2-pole Butterworth via bilinear transform with pre-warping:
+//   K = tan(pi*fc/fs), norm = 1/(1 + sqrt(2)*K + K^2)
+constexpr Biquad butter_lp(double fs, double fc) noexcept {
+    double K = tan_cx(kPi * fc / fs), n = 1.0 / (1.0 + kSqrt2 * K + K * K);
+    return { float(K * K * n), float(2 * K * K * n), float(K * K * n),
+             float(2 * (K * K - 1) * n), float((1 - kSqrt2 * K + K * K) * n) };
+}
+constexpr Biquad butter_hp(double fs, double fc) noexcept {
+    double K = tan_cx(kPi * fc / fs), n = 1.0 / (1.0 + kSqrt2 * K + K * K);
+    return { float(n), float(-2 * n), float(n),
+             float(2 * (K * K - 1) * n), float((1 - kSqrt2 * K + K * K) * n) };
+}
+// One-pole low-pass: alpha = 1 - exp(-2*pi*fc/fs)
+constexpr float one_pole_alpha(double fs, double fc) noexcept {
+    return float(1.0 - exp_cx(-2.0 * kPi * fc / fs));
+}
+} // namespace design
+
+// C5: Coefficient set for one sample rate: B1 band-pass edges 1 Hz / 15 Hz,
+// B2 gravity low-pass at 0.1 Hz.
+struct FilterDesign {
+    float fs; Biquad hp, lp; float grav_alpha;
+};
+template<uint32_t FS>
+struct FilterDesignFor {
+    static_assert(FS > 30, "15 Hz band edge must stay below Nyquist");
+    static constexpr FilterDesign value {
+        float(FS), design::butter_hp(FS, 1.0), design::butter_lp(FS, 15.0),
+        design::one_pole_alpha(FS, 0.1)
+    };
+};
+// Pre-instantiated rates (Config::kRates). filter_design_for() takes a
+// supported rate; detectors refuse a config with any other (Config::valid()).
+inline constexpr const FilterDesign& kDesign50  = FilterDesignFor<50>::value;
+inline constexpr const FilterDesign& kDesign100 = FilterDesignFor<100>::value;
+inline constexpr const FilterDesign& kDesign200 = FilterDesignFor<200>::value;
+inline const FilterDesign& filter_design_for(float fs) noexcept {
+    if (fs == Config::kRates[2]) return kDesign200;
+    if (fs == Config::kRates[1]) return kDesign100;
+    return kDesign50;
+}
+
+// B1: Cascaded 2-pole Butterworth band-pass filter: 1–15 Hz.
 // Implemented as two biquad sections (4th order total):
 //   Section 1 = high-pass at 1 Hz
 //   Section 2 = low-pass at 15 Hz
-// Coefficients computed analytically for Fs=50, Fc=1 Hz (HP) and Fc=15 Hz (LP).
-// HP 1 Hz @50 Hz: alpha = 2*pi*1/50 = 0.1257
-//   a = (1-sin)/(1+sin) style bilinear, simplified 2-pole HP.
-// LP 15 Hz @50 Hz: bilinear transform 2-pole Butterworth.
+// Defaults to the 50 Hz design (kDesign50 = {hp b0≈0.9150, a1≈-1.8227,
+// a2≈0.8372; lp b0≈0.3913, a1≈0.3695, a2≈0.1958}).
 struct BandPassFilter {
-    // High-pass section: 1 Hz cutoff, 50 Hz Fs (2-pole Butterworth)
-    // Pre-warped: wc = 2*tan(pi*1/50) = 0.12664
-    // b = [1, -2, 1] * k^2/(1+sqrt(2)*k+k^2) where k = wc/2
-    // Computed offline: b0=0.9429f, b1=-1.8858f, b2=0.9429f
-    //                   a1=-1.8805f, a2=0.8853f
-    Biquad hp { 0.9429f, -1.8858f, 0.9429f, -1.8805f, 0.8853f };
-
-    // Low-pass section: 15 Hz cutoff, 50 Hz Fs (2-pole Butterworth)
-    // Pre-warped: wc = 2*tan(pi*15/50) = 2.0f
-    // Computed offline: b0=0.2929f, b1=0.5858f, b2=0.2929f
-    //                   a1=0.0f,    a2=0.1716f
-    Biquad lp { 0.2929f, 0.5858f, 0.2929f, 0.0f, 0.1716f };
+    Biquad hp = kDesign50.hp;
+    Biquad lp = kDesign50.lp;
+    BandPassFilter() = default;
+    explicit BandPassFilter(const FilterDesign& d) noexcept : hp(d.hp), lp(d.lp) {}
 
     float process(float x) noexcept { return lp.process(hp.process(x)); }
     void reset() noexcept { hp.reset(); lp.reset(); }
@@ -115,15 +308,16 @@ struct BandPassFilter {
 // B2: Gravity vector estimator — slow low-pass (0.1 Hz) tracks the static
 // gravity component for each axis.  Subtracting this from the raw reading
 // gives body acceleration regardless of device orientation / tilt.
-// alpha = 1 - exp(-2*pi*0.1/50) ≈ 0.01245
+// alpha = 1 - exp(-2*pi*0.1/Fs) (≈ 0.01249 @ 50 Hz)
 // ---------------------------------------------------------------------------
 struct GravityEstimator {
-    static constexpr float kAlpha = 0.01245f;   // ~0.1 Hz low-pass @ 50 Hz
+    static constexpr float kAlpha = kDesign50.grav_alpha;   // ~0.1 Hz low-pass @ 50 Hz
+    float alpha = kAlpha;
     float gx = 0, gy = 0, gz = -1.0f;           // initial guess: phone face-up
     void update(float ax, float ay, float az) noexcept {
-        gx += kAlpha * (ax - gx);
-        gy += kAlpha * (ay - gy);
-        gz += kAlpha * (az - gz);
+        gx += alpha * (ax - gx);
+        gy += alpha * (ay - gy);
+        gz += alpha * (az - gz);
     }
     // Linear acceleration = raw - gravity
     float linX(float ax) const noexcept { return ax - gx; }
@@ -132,169 +326,702 @@ struct GravityEstimator {
     void reset() noexcept { gx = gy = 0; gz = -1.0f; }
 };
 
-template<typename T, uint32_t MAX_N>
+// ---------------------------------------------------------------------------
+// C2: 4-lane float vector — x/y/z in lanes 0..2, lane 3 spare (always 0).
+// NEON when available, otherwise a plain array the compiler may auto-vectorise.
+// Operations are issued in exactly the order of the scalar filters above and
+// never fused, so both paths match the scalar reference bit-for-bit when the
+// scalar build does not contract a*b+c into FMA; with contraction (or ARMv7
+// NEON flush-to-zero) the filtered output differs by < 1e-6 g.
+// ---------------------------------------------------------------------------
+namespace simd {
+#ifdef SINYALIST_NEON
+using f4 = float32x4_t;
+inline f4 dup(float a) noexcept { return vdupq_n_f32(a); }
+inline f4 set3(float x, float y, float z) noexcept {
+    const float t[4] = {x, y, z, 0.0f}; return vld1q_f32(t);
+}
+inline f4 add(f4 a, f4 b) noexcept { return vaddq_f32(a, b); }
+inline f4 sub(f4 a, f4 b) noexcept { return vsubq_f32(a, b); }
+inline f4 mul(f4 a, f4 b) noexcept { return vmulq_f32(a, b); }
+inline float lane(f4 a, int i) noexcept {
+    float t[4]; vst1q_f32(t, a); return t[i];
+}
+#else
+struct f4 { float v[4]; };
+inline f4 dup(float a) noexcept { return {{a, a, a, a}}; }
+inline f4 set3(float x, float y, float z) noexcept { return {{x, y, z, 0.0f}}; }
+inline f4 add(f4 a, f4 b) noexcept { f4 r; for(int i=0;i<4;++i) r.v[i]=a.v[i]+b.v[i]; return r; }
+inline f4 sub(f4 a, f4 b) noexcept { f4 r; for(int i=0;i<4;++i) r.v[i]=a.v[i]-b.v[i]; return r; }
+inline f4 mul(f4 a, f4 b) noexcept { f4 r; for(int i=0;i<4;++i) r.v[i]=a.v[i]*b.v[i]; return r; }
+inline float lane(f4 a, int i) noexcept { return a.v[i]; }
+#endif
+} // namespace simd
+
+// C2: Biquad with the three axes in parallel lanes (same DF-II-T as Biquad).
+struct BiquadX3 {
+    simd::f4 b0, b1, b2, a1, a2, w1, w2;
+    explicit BiquadX3(const Biquad& q = {}) noexcept
+        : b0(simd::dup(q.b0)), b1(simd::dup(q.b1)), b2(simd::dup(q.b2)),
+          a1(simd::dup(q.a1)), a2(simd::dup(q.a2)),
+          w1(simd::dup(0)), w2(simd::dup(0)) {}
+    simd::f4 process(simd::f4 x) noexcept {
+        using namespace simd;
+        f4 y = add(mul(b0, x), w1);
+        w1 = add(sub(mul(b1, x), mul(a1, y)), w2);
+        w2 = sub(mul(b2, x), mul(a2, y));
+        return y;
+    }
+    void reset() noexcept { w1 = w2 = simd::dup(0); }
+};
+
+// C2: Full per-sample filter chain for all three axes:
+//   gravity LP (B2) → band-pass 1–15 Hz (B1) → legacy high-pass.
+// Replaces grav/bpx/bpy/bpz/hx/hy/hz — one vector op per arithmetic step
+// instead of three scalar ones.
+struct AxisFilterChain {
+    simd::f4 g, k_grav;                  // gravity estimate, LP coefficient
+    BiquadX3 hp, lp;                     // band-pass sections
+    simd::f4 hp_raw, hp_filt, hp_a;      // legacy HighPassState × 3
+    explicit AxisFilterChain(const FilterDesign& d = kDesign50) noexcept
+        : g(simd::set3(0, 0, -1.0f)), k_grav(simd::dup(d.grav_alpha)),
+          hp(d.hp), lp(d.lp),
+          hp_raw(simd::dup(0)), hp_filt(simd::dup(0)), hp_a(simd::dup(0.98f)) {}
+
+    void set_hp_alpha(float a) noexcept { hp_a = simd::dup(a); }
+
+    // Returns the filtered body acceleration; lane 3 is 0.
+#ifdef SINYALIST_NEON
+    simd::f4 process(float ax, float ay, float az) noexcept {
+        using namespace simd;
+        f4 raw = set3(ax, ay, az);
+        g = add(g, mul(k_grav, sub(raw, g)));
+        f4 x = lp.process(hp.process(sub(raw, g)));
+        hp_filt = mul(hp_a, sub(add(hp_filt, x), hp_raw));
+        hp_raw = x;
+        return hp_filt;
+    }
+#else
+    // Without NEON the 4-lane struct costs ~2.4x the plain per-axis chain
+    // (host replay, sweep, backend verifier), so run three scalar lanes on
+    // the same state, in the same operation order.
+    simd::f4 process(float ax, float ay, float az) noexcept {
+        axis(0, ax); axis(1, ay); axis(2, az);
+        return hp_filt;
+    }
+#endif
+    // C9: start from a known gravity vector instead of the face-up guess.
+    void seed_gravity(float x, float y, float z) noexcept { g = simd::set3(x, y, z); }
+    float gx() const noexcept { return simd::lane(g, 0); }
+    float gy() const noexcept { return simd::lane(g, 1); }
+    float gz() const noexcept { return simd::lane(g, 2); }
+    void reset() noexcept {
+        g = simd::set3(0, 0, -1.0f); hp.reset(); lp.reset();
+        hp_raw = hp_filt = simd::dup(0);
+    }
+
+private:
+#ifndef SINYALIST_NEON
+    static float section(BiquadX3& q, int i, float x) noexcept {
+        float y = q.b0.v[i]*x + q.w1.v[i];
+        q.w1.v[i] = q.b1.v[i]*x - q.a1.v[i]*y + q.w2.v[i];
+        q.w2.v[i] = q.b2.v[i]*x - q.a2.v[i]*y;
+        return y;
+    }
+    void axis(int i, float raw) noexcept {
+        float gi = g.v[i] + k_grav.v[i]*(raw - g.v[i]);
+        g.v[i] = gi;
+        float x = section(lp, i, section(hp, i, raw - gi));
+        hp_filt.v[i] = hp_a.v[i]*((hp_filt.v[i] + x) - hp_raw.v[i]);
+        hp_raw.v[i] = x;
+    }
+#endif
+};
+
+// C4: Contiguous read-only range; window views are split into at most two.
+template<typename T>
+struct Span {
+    const T* p = nullptr; uint32_t n = 0;
+    const T* begin() const noexcept { return p; }
+    const T* end() const noexcept { return p + n; }
+    uint32_t size() const noexcept { return n; }
+};
+template<typename T>
+struct WindowView {
+    Span<T> first, second;   // oldest..newest = first ++ second
+    uint32_t size() const noexcept { return first.n + second.n; }
+};
+
+constexpr uint32_t pow2_ceil(uint32_t v) noexcept {
+    uint32_t p = 1; while (p < v) p <<= 1; return p;
+}
+
+// ---------------------------------------------------------------------------
+// C26: storage codecs. A Ring keeps samples as S and hands out T; put()
+// rounds once on the way in and the running sums add and evict get(put(v)),
+// so they stay exact for what is stored. Re-encoding a decoded value is the
+// identity, so a snapshot taken from compact rings restores bit-identically.
+// ---------------------------------------------------------------------------
+struct Half { uint16_t bits; };      // IEEE 754 binary16
+struct UQ14 { uint16_t q; };         // unsigned 2.14 fixed point, [0, 4)
+
+template<typename S, typename T>
+struct StorageCodec {
+    static S put(T v) noexcept { return v; }
+    static T get(S s) noexcept { return s; }
+};
+
+// Hardware conversion where there is one (AArch64, x86-64 with F16C);
+// otherwise the same round-to-nearest-even in integer arithmetic, which
+// beats the compiler's libgcc/compiler-rt _Float16 emulation.
+#if defined(__FLT16_MAX__) && (defined(__aarch64__) || defined(__F16C__))
+#define SINYALIST_HW_FP16 1
+#else
+#define SINYALIST_HW_FP16 0
+#endif
+template<>
+struct StorageCodec<Half, float> {
+    static Half put(float v) noexcept {
+#if SINYALIST_HW_FP16
+        _Float16 h = _Float16(v); Half o; std::memcpy(&o.bits, &h, 2); return o;
+#else
+        return {soft_put(v)};
+#endif
+    }
+    static float get(Half s) noexcept {
+#if SINYALIST_HW_FP16
+        _Float16 h; std::memcpy(&h, &s.bits, 2); return float(h);
+#else
+        return soft_get(s.bits);
+#endif
+    }
+    static uint16_t soft_put(float v) noexcept {
+        uint32_t f; std::memcpy(&f, &v, 4);
+        const uint32_t sign = f & 0x80000000u; f ^= sign;
+        uint16_t o;
+        if (f >= 0x47800000u) {                       // ≥ 65520 after rounding: inf, or NaN
+            o = f > 0x7f800000u ? 0x7e00 : 0x7c00;
+        } else if (f < 0x38800000u) {                 // half subnormal: let the FPU round
+            float a; std::memcpy(&a, &f, 4);
+            a += 0.5f;                                // 2^-1: ulp becomes 2^-24
+            std::memcpy(&f, &a, 4);
+            o = uint16_t(f - 0x3f000000u);
+        } else {
+            const uint32_t odd = (f >> 13) & 1;
+            f += 0xc8000fffu + odd;                   // rebias exponent (-112), round half to even
+            o = uint16_t(f >> 13);
+        }
+        return uint16_t(o | (sign >> 16));
+    }
+    static float soft_get(uint16_t h) noexcept {
+        const uint32_t sign = uint32_t(h & 0x8000) << 16, e = (h >> 10) & 0x1f, m = h & 0x3ff;
+        uint32_t f;
+        if (e == 0x1f)  f = sign | 0x7f800000u | (m << 13);
+        else if (e)     f = sign | ((e + 112) << 23) | (m << 13);
+        else            { float v = float(m) * 0x1p-24f; return sign ? -v : v; }
+        float v; std::memcpy(&v, &f, 4); return v;
+    }
+};
+
+template<>
+struct StorageCodec<UQ14, float> {
+    static constexpr float kScale = 16384.0f;
+    static UQ14 put(float v) noexcept {
+        float q = v * kScale + 0.5f;                  // magnitudes: never negative
+        return {uint16_t(q <= 0.0f ? 0 : q >= 65535.0f ? 65535 : uint32_t(q))};
+    }
+    static float get(UQ14 s) noexcept { return float(s.q) * (1.0f / kScale); }
+};
+
+// C4: MAX_N must be a power of two. The head index runs free and is masked
+// with the smallest power of two ≥ cap, so the touched region stays within 2×
+// the window and no integer division is needed. Only the live window is ever
+// read, so reset() does not clear the storage. C15: Acc is the type of the
+// running sums — int64_t over int32_t fixed-point samples keeps them exact.
+// C26: S is the stored type (see StorageCodec); window() needs S == T.
+// A capacity outside 1..MAX_N is refused (false, ring unchanged).
+template<typename T, uint32_t MAX_N, typename Acc = T, typename S = T>
 class Ring {
-    std::array<T, MAX_N> b_{}; uint32_t h_=0, n_=0, cap_=MAX_N;
-    T s_=0, sq_=0;
+    static_assert(MAX_N > 0 && (MAX_N & (MAX_N - 1)) == 0, "Ring MAX_N must be a power of two");
+    using Codec = StorageCodec<S, T>;
+    std::array<S, MAX_N> b_; uint32_t h_=0, n_=0, cap_=MAX_N, mask_=MAX_N-1;
+    Acc s_=0, sq_=0;
 public:
-    void set_cap(uint32_t c) noexcept { cap_=c>0&&c<=MAX_N?c:MAX_N; reset(); }
+    bool set_cap(uint32_t c) noexcept {
+        if(c==0||c>MAX_N) return false;
+        cap_=c; mask_=pow2_ceil(cap_)-1; reset();
+        return true;
+    }
+    // C13: like set_cap() but keeps the newest min(size, c) samples. They are
+    // rotated to the front of the storage so they stay addressable under the
+    // new mask; the sums are rebuilt exactly from what is kept.
+    bool resize(uint32_t c) noexcept {
+        if(c==0||c>MAX_N) return false;
+        uint32_t k=std::min(n_,c);
+        std::rotate(b_.begin(), b_.begin()+((h_-k)&mask_), b_.begin()+mask_+1);
+        cap_=c; mask_=pow2_ceil(cap_)-1; h_=n_=k; s_=sq_=0;
+        for(uint32_t i=0;i<k;++i){ T v=Codec::get(b_[i]); s_+=v; sq_+=Acc(v)*v; }
+        return true;
+    }
     void push(T v) noexcept {
-        if(n_==cap_){s_-=b_[h_];sq_-=b_[h_]*b_[h_];}else{++n_;}
-        b_[h_]=v; s_+=v; sq_+=v*v; h_=(h_+1)%cap_;
+        if(n_==cap_){T o=Codec::get(b_[(h_-cap_)&mask_]);s_-=o;sq_-=Acc(o)*o;}else{++n_;}
+        S e=Codec::put(v); v=Codec::get(e);
+        b_[h_&mask_]=e; s_+=v; sq_+=Acc(v)*v; ++h_;
     }
-    T avg() const noexcept { return n_>0?s_/T(n_):0; }
-    T var() const noexcept { if(n_<2)return 0; T m=avg(); T v=sq_/T(n_)-m*m; return v>0?v:0; }
+    Acc avg() const noexcept { return n_>0?s_/Acc(n_):0; }
+    Acc var() const noexcept { if(n_<2)return 0; Acc m=avg(); Acc v=sq_/Acc(n_)-m*m; return v>0?v:0; }
     bool full() const noexcept { return n_==cap_; }
     uint32_t size() const noexcept { return n_; }
-    T at(uint32_t i) const noexcept { return i<n_?b_[(h_+cap_-n_+i)%cap_]:0; }
-    void reset() noexcept { h_=n_=0; s_=sq_=0; b_.fill(0); }
+    uint32_t capacity() const noexcept { return cap_; }
+    T at(uint32_t i) const noexcept { return i<n_?Codec::get(b_[(h_-n_+i)&mask_]):T(0); }
+    WindowView<T> window() const noexcept {
+        static_assert(std::is_same<S, T>::value, "window() exposes raw storage");
+        uint32_t st=(h_-n_)&mask_, run=std::min(n_, mask_+1-st);
+        return {{b_.data()+st, run}, {b_.data(), n_-run}};
+    }
+    void reset() noexcept { h_=n_=0; s_=sq_=0; }
+    // C14: running sums, so a restored ring continues bit-identically.
+    Acc sum() const noexcept { return s_; }
+    Acc sum_sq() const noexcept { return sq_; }
+    void set_sums(Acc s, Acc sq) noexcept { s_=s; sq_=sq; }
 };
 
-class SeismicDetector {
-public:
-    using EventCB = std::function<void(const SeismicEvent&)>;
-    using DebugCB = std::function<void(const DebugTelemetry&)>;
+// ---------------------------------------------------------------------------
+// C8: Recursive (exponential) STA/LTA — the classic seismological form
+//   sta += (x − sta)/N_sta,   lta += (x − lta)/N_lta
+// plus an exponentially weighted mean/variance over N_cal replacing the
+// calibration ring's var(). During warm-up the gain is 1/k (k = samples seen)
+// rather than 1/N, i.e. an exact running mean / Welford population variance,
+// so the estimates are unbiased before they reach their time constant. Ready
+// (≙ lta_.full()) once N_lta samples have been seen. O(1) state per window.
+// ---------------------------------------------------------------------------
+struct RecursiveStaLta {
+    uint32_t n_sta=25, n_lta=500, n_cal=2500, k_max=2500;
+    float g_sta=1.f/25, g_lta=1.f/500, g_cal=1.f/2500;   // steady-state gains 1/N
+    float sta=0, lta=0, mean=0, var=0; uint32_t k=0;
 
-    SeismicDetector(EventCB on_ev, DebugCB on_dbg = nullptr)
-        : on_ev_(std::move(on_ev)), on_dbg_(std::move(on_dbg)) { apply(); }
+    // Gain for the (k+1)-th sample of a window of n — shared with DetectorBank.
+    static float gain(uint32_t k, uint32_t n, float g) noexcept {
+        return k+1<n ? 1.0f/float(k+1) : g;
+    }
+    static void update(float x, float cs, float cl, float cc,
+                       float& sta, float& lta, float& mean, float& var) noexcept {
+        sta+=cs*(x-sta); lta+=cl*(x-lta);
+        float d=x-mean; mean+=cc*d; var=(1.0f-cc)*(var+cc*d*d);
+    }
+    void configure(uint32_t s, uint32_t l, uint32_t c) noexcept { resize(s,l,c); reset(); }
+    // C13: new window lengths, estimates kept; they move to the new time
+    // constants from the next push on.
+    void resize(uint32_t s, uint32_t l, uint32_t c) noexcept {
+        n_sta=std::max(s,1u); n_lta=std::max(l,1u); n_cal=std::max(c,1u);
+        k_max=std::max({n_sta,n_lta,n_cal}); k=std::min(k,k_max);
+        g_sta=1.0f/float(n_sta); g_lta=1.0f/float(n_lta); g_cal=1.0f/float(n_cal);
+    }
+    void push(float x) noexcept {
+        if(k<k_max){
+            update(x,gain(k,n_sta,g_sta),gain(k,n_lta,g_lta),gain(k,n_cal,g_cal),sta,lta,mean,var);
+            ++k;
+        } else {
+            update(x,g_sta,g_lta,g_cal,sta,lta,mean,var);
+        }
+    }
+    // C9: n pushes of the constant x at steady-state gains, in O(1) (the
+    // closed form of update(); var_n = r^n·(var + d²·(1 - r^n)), r = 1 - g).
+    void advance(float x, uint64_t n) noexcept {
+        if(!n) return;
+        double ns=double(n);
+        float rs=float(std::pow(1.0-double(g_sta),ns)), rl=float(std::pow(1.0-double(g_lta),ns));
+        float rc=float(std::pow(1.0-double(g_cal),ns));
+        float d=x-mean;
+        sta=x+(sta-x)*rs; lta=x+(lta-x)*rl; mean=x-d*rc;
+        var=rc*(var+d*d*(1.0f-rc));
+        k=uint32_t(std::min<uint64_t>(k_max,k+n));
+    }
+    bool ready() const noexcept { return k>=n_lta; }
+    void reset() noexcept { sta=lta=mean=var=0; k=0; }
+};
 
-    void update_config(const Config& c) noexcept { cfg_=c; apply(); }
-    const Config& config() const noexcept { return cfg_; }
+// ---------------------------------------------------------------------------
+// C6: Bounded lock-free single-producer/single-consumer queue. push() is
+// wait-free and allocation-free (returns false when full), safe to call from
+// the sensor thread while one other thread pops. N must be a power of two.
+// ---------------------------------------------------------------------------
+template<typename T, uint32_t N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue N must be a power of two");
+    std::array<T, N> b_;
+    alignas(64) std::atomic<uint32_t> head_{0};   // producer-owned
+    alignas(64) std::atomic<uint32_t> tail_{0};   // consumer-owned
+public:
+    bool push(const T& v) noexcept {
+        uint32_t h=head_.load(std::memory_order_relaxed);
+        if(h-tail_.load(std::memory_order_acquire)==N) return false;
+        b_[h&(N-1)]=v; head_.store(h+1,std::memory_order_release); return true;
+    }
+    bool pop(T& out) noexcept {
+        uint32_t t=tail_.load(std::memory_order_relaxed);
+        if(t==head_.load(std::memory_order_acquire)) return false;
+        out=b_[t&(N-1)]; tail_.store(t+1,std::memory_order_release); return true;
+    }
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire)==tail_.load(std::memory_order_acquire);
+    }
+};
 
-    void process_sample(float ax_r, float ay_r, float az_r, uint64_t ts) noexcept {
-        ++total_;
-        if(cd_>0){--cd_;return;}
+// ---------------------------------------------------------------------------
+// C7: Shared-memory telemetry ring. Fixed little-endian layout so the Java
+// side can read it straight out of a direct ByteBuffer:
+//   header (64 B): magic u32 | version u32 | capacity u32 | record_size u32 |
+//                  enabled u32 | pad u32 | write_seq u64 | pad[32]
+//   records[kCapacity] (48 B each): seq u64 | ts u64 | 7×f32 | state u8 |
+//                  reject u8 | pad[2]
+// Record q (0-based) lives in slot q % kCapacity and carries seq = q+1 once
+// complete (0 while being written). A reader remembers the next q it wants,
+// reads write_seq, and accepts a slot only if its seq matches before and after
+// copying — anything else was overwritten and counts as lost.
+// Writes cost one 48-byte store when enabled, a relaxed load when not.
+// ---------------------------------------------------------------------------
+struct TelemetryRing {
+    static constexpr uint32_t kMagic = 0x31544453;   // "SDT1"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kCapacity = 256;       // ~51 s at 5 Hz
+    struct Record {
+        std::atomic<uint64_t> seq; uint64_t ts;
+        float raw_mag, filt_mag, sta, lta, ratio, baseline_var, adaptive_trigger;
+        uint8_t state, reject, pad[2];
+    };
+    struct Header {
+        uint32_t magic = kMagic, version = kVersion;
+        uint32_t capacity = kCapacity, record_size = sizeof(Record);
+        std::atomic<uint32_t> enabled{0}; uint32_t pad0 = 0;
+        std::atomic<uint64_t> write_seq{0};
+        uint8_t pad1[32] = {};
+    };
+    static_assert(sizeof(Record) == 48, "telemetry record layout is shared with Kotlin");
+    static_assert(sizeof(Header) == 64, "telemetry header layout is shared with Kotlin");
+
+    Header hdr;
+    Record rec[kCapacity] = {};
 
-        // B2: subtract gravity to get linear (body) acceleration
-        grav_.update(ax_r, ay_r, az_r);
-        float lx = grav_.linX(ax_r);
-        float ly = grav_.linY(ay_r);
-        float lz = grav_.linZ(az_r);
+    bool enabled() const noexcept { return hdr.enabled.load(std::memory_order_relaxed)!=0; }
+    void set_enabled(bool on) noexcept { hdr.enabled.store(on?1:0, std::memory_order_relaxed); }
 
-        // B1: band-pass 1–15 Hz per axis (removes DC drift and HF noise)
-        float ax = bpx_.process(lx);
-        float ay = bpy_.process(ly);
-        float az = bpz_.process(lz);
+    // Single writer (sensor thread).
+    void write(const DebugTelemetry& t) noexcept {
+        uint64_t q=hdr.write_seq.load(std::memory_order_relaxed);
+        Record& r=rec[q%kCapacity];
+        r.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.ts=t.ts; r.raw_mag=t.raw_mag; r.filt_mag=t.filt_mag; r.sta=t.sta; r.lta=t.lta;
+        r.ratio=t.ratio; r.baseline_var=t.baseline_var; r.adaptive_trigger=t.adaptive_trigger;
+        r.state=t.state; r.reject=uint8_t(t.reject);
+        r.seq.store(q+1, std::memory_order_release);
+        hdr.write_seq.store(q+1, std::memory_order_release);
+    }
+};
 
-        // Legacy high-pass still applied as a second stage for extra DC rejection
-        // (hp_alpha=0.98 → ~0.16 Hz cutoff, well below band-pass lower edge)
-        ax = hx_.process(ax, cfg_.hp_alpha);
-        ay = hy_.process(ay, cfg_.hp_alpha);
-        az = hz_.process(az, cfg_.hp_alpha);
+// ---------------------------------------------------------------------------
+// C3: Sliding-window autocorrelation for periodicity rejection (A2).
+// For every lag in [lag_lo, lag_hi] it keeps P = Σ x_i·x_{i+lag}, the head sum
+// H (first `lag` samples) and tail sum T (last `lag` samples), plus Σx, Σx².
+// Then  Σ(x_i-m)(x_{i+lag}-m) = P - m(S-T) - m(S-H) + (n-lag)m²
+// so score() is O(lags) regardless of window length, and push() is O(lags).
+// The sums are only kept while tracking — the detector turns that on for an
+// open trigger candidate (CONFIRM) — and seeded from the stored window in one
+// O(n·lags) pass when it starts; otherwise push() just stores the sample, so
+// the always-on path pays a ring write instead of the lag loops.
+// Sums are double to keep add/remove drift far below the 1e-10 variance floor;
+// an exact rebuild every kResync pushes bounds it anyway. C15: T/Acc = int32_t/
+// int64_t holds fixed-point samples with FRAC fractional bits; the sums are
+// then exact and only score() goes through double.
+// ---------------------------------------------------------------------------
+template<uint32_t MAX_N, uint32_t MAX_LAGS, typename T = float, typename Acc = double, int FRAC = 0>
+class PeriodicityTracker {
+    static_assert((MAX_N & (MAX_N - 1)) == 0, "PeriodicityTracker MAX_N must be a power of two");
+public:
+    static constexpr uint32_t kResync = 1u << 16;
+    static constexpr double kVarFloor = 1e-10 * double(1ull << FRAC) * double(1ull << FRAC);
+private:
+    // C8: storage sized by configure() (pow2 ≥ cap, nl lags) — ~1.3 KB at
+    // 50 Hz instead of the 200 Hz worst case. configure() before first use.
+    std::vector<T> b_; uint32_t h_=0, n_=0, cap_=MAX_N, mask_=0;
+    uint32_t l0_=0, nl_=0, pushes_=0;
+    bool on_=false;                         // tracking: lag sums are current
+    Acc s_=0, sq_=0;
+    std::vector<Acc> p_, hd_, tl_;
+    T at(uint32_t i) const noexcept { return b_[(h_-n_+i)&mask_]; }
+public:
+    // Lags are clamped so lag < cap/2, matching the original scan bound.
+    void configure(uint32_t cap, uint32_t lag_lo, uint32_t lag_hi) noexcept {
+        cap_=cap>0&&cap<=MAX_N?cap:MAX_N; mask_=pow2_ceil(cap_)-1;
+        if(lag_lo<1) lag_lo=1;
+        if(cap_/2>0&&lag_hi>=cap_/2) lag_hi=cap_/2-1;
+        nl_=lag_hi>=lag_lo?std::min(lag_hi-lag_lo+1,MAX_LAGS):0;
+        l0_=lag_lo;
+        b_.resize(mask_+1); p_.resize(nl_); hd_.resize(nl_); tl_.resize(nl_);
+        reset();
+    }
+    // Starts (seeding the sums from the window) or stops tracking.
+    void track(bool on) noexcept { if(on&&!on_) rebuild(); on_=on; }
+    bool tracking() const noexcept { return on_; }
+    void push(T x) noexcept {
+        if(!on_){ b_[h_&mask_]=x; ++h_; n_+=n_<cap_; return; }
+        if(n_==cap_){                       // evict x_0
+            T x0=at(0);
+            for(uint32_t k=0;k<nl_;++k){
+                uint32_t lag=l0_+k;
+                if(lag<n_){ T xl=at(lag); p_[k]-=Acc(x0)*xl; hd_[k]+=Acc(xl)-x0; }
+                else { hd_[k]-=x0; tl_[k]-=x0; }
+            }
+            s_-=x0; sq_-=Acc(x0)*x0; --n_;
+        }
+        for(uint32_t k=0;k<nl_;++k){        // x becomes x_n
+            uint32_t lag=l0_+k;
+            if(n_>=lag){ T xo=at(n_-lag); p_[k]+=Acc(xo)*x; tl_[k]+=Acc(x)-xo; }
+            else { hd_[k]+=x; tl_[k]+=x; }
+        }
+        b_[h_&mask_]=x; ++h_; ++n_;
+        s_+=x; sq_+=Acc(x)*x;
+        if(++pushes_>=kResync) rebuild();
+    }
+    // Max normalised autocorrelation over the lag range (0 if < 60 samples);
+    // while tracking only.
+    float score() const noexcept {
+        if(n_<60) return 0;
+        double s=double(s_), m=s/n_, v=double(sq_)-double(n_)*m*m;
+        if(v<kVarFloor) return 0;
+        float best=0;
+        for(uint32_t k=0;k<nl_;++k){
+            uint32_t lag=l0_+k; if(lag>=n_/2) break;
+            double c=double(p_[k])-m*(s-double(tl_[k]))-m*(s-double(hd_[k]))+double(n_-lag)*m*m;
+            best=std::max(best,float(c/v));
+        }
+        return best;
+    }
+    bool full() const noexcept { return n_==cap_; }
+    uint32_t size() const noexcept { return n_; }
+    // i-th oldest sample in the window, i < size() (C14 snapshots).
+    T sample(uint32_t i) const noexcept { return at(i); }
+    size_t bytes() const noexcept {
+        return sizeof(*this)+b_.capacity()*sizeof(T)
+             +(p_.capacity()+hd_.capacity()+tl_.capacity())*sizeof(Acc);
+    }
+    void reset() noexcept {
+        h_=n_=pushes_=0; s_=sq_=0; on_=false;
+        std::fill(p_.begin(),p_.end(),Acc(0)); std::fill(hd_.begin(),hd_.end(),Acc(0));
+        std::fill(tl_.begin(),tl_.end(),Acc(0));
+    }
+private:
+    void rebuild() noexcept {
+        pushes_=0; s_=sq_=0;
+        for(uint32_t i=0;i<n_;++i){ Acc x=at(i); s_+=x; sq_+=x*x; }
+        for(uint32_t k=0;k<nl_;++k){
+            uint32_t lag=l0_+k; Acc p=0,hd=0,tl=0;
+            for(uint32_t i=0;i+lag<n_;++i) p+=Acc(at(i))*at(i+lag);
+            for(uint32_t i=0;i<lag&&i<n_;++i){ hd+=at(i); tl+=at(n_-1-i); }
+            p_[k]=p; hd_[k]=hd; tl_[k]=tl;
+        }
+    }
+};
 
-        float mag=std::sqrt(ax*ax+ay*ay+az*az);
+// ---------------------------------------------------------------------------
+// C9: Energy pre-gate — the only per-sample work while the device is quiet.
+// Gravity is tracked with the same one-pole as B2; the squared deviation
+// |a - g|² is smoothed over the STA window (no sqrt, no filters) and compared
+// against pregate_g². The last `warmup` raw samples are kept so the full
+// chain can be replayed before it takes over.
+// ---------------------------------------------------------------------------
+struct EnergyGate {
+    GravityEstimator grav;
+    float e=0, ke=1.f/25;            // smoothed |a - g|², smoothing gain
+    uint32_t quiet=0;                // consecutive samples below threshold
+    // C13: state and pre-roll are kept unless the pre-roll length changes.
+    void configure(uint32_t warmup, uint32_t sta, float grav_alpha) {
+        grav.alpha=grav_alpha; ke=1.0f/float(std::max(sta,1u));
+        if(warmup==cap_) return;
+        cap_=warmup; uint32_t slots=pow2_ceil(std::max(warmup,1u));
+        pre_.assign(warmup?size_t(slots)*3:0,0.0f); mask_=slots-1;
+        reset();
+    }
+    // Updates the energy estimate and the quiet count; true above threshold.
+    bool hot(float x, float y, float z, float th2) noexcept {
+        float dx=x-grav.gx, dy=y-grav.gy, dz=z-grav.gz;
+        grav.update(x,y,z);
+        e+=ke*(dx*dx+dy*dy+dz*dz-e);
+        bool h=e>=th2; quiet=h?0:quiet+1;
+        return h;
+    }
+    void record(float x, float y, float z) noexcept {
+        if(!cap_) return;
+        float* p=&pre_[size_t(h_&mask_)*3]; p[0]=x; p[1]=y; p[2]=z;
+        ++h_; if(n_<cap_) ++n_;
+    }
+    uint32_t size() const noexcept { return n_; }
+    // The newest min(last, size()) recorded samples, oldest first.
+    template<class F> void replay(uint32_t last, F&& f) const noexcept {
+        for(uint32_t i=h_-std::min(last,n_);i!=h_;++i){ const float* p=&pre_[size_t(i&mask_)*3]; f(p[0],p[1],p[2]); }
+    }
+    size_t bytes() const noexcept { return pre_.capacity()*sizeof(float); }
+    void reset() noexcept { grav.reset(); e=0; quiet=0; h_=n_=0; }
+private:
+    std::vector<float> pre_;         // x,y,z per slot, pow2 slots
+    uint32_t cap_=0, mask_=0, h_=0, n_=0;
+};
 
-        sta_.push(mag); lta_.push(mag); cal_.push(mag); per_.push(mag);
-        if(!lta_.full()) return;
+// ---------------------------------------------------------------------------
+// C11: Spectral bank — exponentially weighted sliding DFT on the filtered
+// x/y/z lanes. Each bin is a complex resonator S ← λ·e^{jω}·(S + x), one per
+// step from pwave_freq_min to pwave_freq_max (≤16, ~1 Hz apart) plus a guard
+// bin on either side so out-of-band peaks are recognisable. 1-λ = π·df/Fs
+// gives each bin a half-power half-width of df/2 (τ ≈ 0.3 s at 1 Hz steps
+// and 50 Hz), so the estimate follows the CONFIRM window. No sample history;
+// TriggerState::wants_spectrum() decides when it runs.
+// ---------------------------------------------------------------------------
+struct SpectralPeak { float freq_hz, band; };    // band: in-band share of total power
 
-        float s=sta_.avg(), l=lta_.avg();
-        float bv=cal_.var();
-        float at=std::clamp(cfg_.sta_lta_trigger+std::sqrt(bv)*100.f,
-                            cfg_.adaptive_trig_min, cfg_.adaptive_trig_max);
+struct SpectralBank {
+    static constexpr uint32_t kMaxBins = 18;     // 16 in band + 2 guards
+    uint32_t nb = 0;                             // bins incl. guards
+    float f0 = 0, df = 1, g = 0, norm = 0;       // bin 0 freq, spacing, 1-λ, 2(1-λ)²
+    float c[kMaxBins] = {}, s[kMaxBins] = {};    // λ·cos ω, λ·sin ω
+    simd::f4 re[kMaxBins], im[kMaxBins], pt;     // bin state, total power per lane
 
-        if(l<cfg_.min_amplitude_g){
-            if(total_%10==0) emit_dbg(mag,mag,s,l,0,bv,at,ts);
-            return;
+    void configure(float fs, float fmin, float fmax) noexcept {
+        uint32_t in = std::clamp(uint32_t(std::max(fmax - fmin, 0.f)) + 1, 2u, kMaxBins - 2);
+        nb = in + 2; df = std::max(fmax - fmin, 0.1f) / float(in - 1); f0 = fmin - df;
+        g = std::min(0.5f, 3.14159265f * df / fs); norm = 2.f * g * g;
+        for (uint32_t k = 0; k < nb; ++k) {
+            double w = 6.283185307179586 * std::clamp(double(f0 + k * df), 0.0, 0.5 * fs) / fs;
+            c[k] = float((1.0 - g) * std::cos(w)); s[k] = float((1.0 - g) * std::sin(w));
+        }
+        reset();
+    }
+    void push(simd::f4 x) noexcept {
+        using namespace simd;
+        pt = add(pt, mul(dup(g), sub(mul(x, x), pt)));
+        for (uint32_t k = 0; k < nb; ++k) {
+            f4 r = add(re[k], x), ck = dup(c[k]), sk = dup(s[k]), m = im[k];
+            re[k] = sub(mul(ck, r), mul(sk, m));
+            im[k] = add(mul(sk, r), mul(ck, m));
+        }
+    }
+    SpectralPeak peak() const noexcept {
+        using namespace simd;
+        float p[kMaxBins];
+        for (uint32_t k = 0; k < nb; ++k) {
+            f4 q = add(mul(re[k], re[k]), mul(im[k], im[k]));
+            p[k] = lane(q, 0) + lane(q, 1) + lane(q, 2);
+        }
+        return peak_of(p, lane(pt, 0) + lane(pt, 1) + lane(pt, 2));
+    }
+    // p[k] = Σ_axes |S_k|²; shared with DetectorBank's SoA copy. A parabola
+    // through the log powers of the neighbouring bins refines the peak.
+    SpectralPeak peak_of(const float* p, float total) const noexcept {
+        uint32_t m = 0; float band = 0;
+        for (uint32_t k = 0; k < nb; ++k) {
+            if (p[k] > p[m]) m = k;
+            if (k > 0 && k + 1 < nb) band += p[k];
+        }
+        float d = 0;                             // guard-bin peaks stay out of band
+        if (m > 0 && m + 1 < nb && p[m-1] > 0 && p[m+1] > 0) {
+            float a = std::log(p[m-1]), b = std::log(p[m]), e = std::log(p[m+1]), den = a - 2.f*b + e;
+            if (den < 0) d = std::clamp(0.5f * (a - e) / den, -0.5f, 0.5f);
+            if (m == 1) d = std::max(d, 0.f);
+            if (m + 2 == nb) d = std::min(d, 0.f);
         }
-        float r=s/l;
-        if(total_%10==0) emit_dbg(mag,mag,s,l,r,bv,at,ts);
+        return {f0 + (float(m) + d) * df, total > 0 ? std::min(1.f, norm * band / total) : 0.f};
+    }
+    void reset() noexcept {
+        for (uint32_t k = 0; k < kMaxBins; ++k) re[k] = im[k] = simd::dup(0);
+        pt = simd::dup(0);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// IDLE → CONFIRM → TRIGGERED state machine with the A2/A4 rejection stages.
+// Shared by SeismicDetector and DetectorBank so both make identical decisions.
+// step() is called once per sample with full windows and LTA ≥ min amplitude.
+// ---------------------------------------------------------------------------
+struct TriggerState {
+    enum class S:uint8_t{IDLE,CONFIRM,TRIGGERED};
+    S st=S::IDLE; uint32_t sc=0,dur=0,cd=0;
+    float pk=0, fq=0; uint64_t t0=0;          // fq: C11 dominant freq at the decision
+    float ap[3]={}, ae[3]={};
+    RejectCode lr=RejectCode::NONE;
+    uint32_t rejects=0;                       // C22: since construction, not reset()
 
-        switch(st_){
+    // periodic(thresh) → true if the periodicity window is full and its
+    // score exceeds thresh; spectrum() → current SpectralPeak (C11);
+    // fire(const SeismicEvent&) delivers an event.
+    template<class Periodic, class Spectrum, class Fire>
+    void step(const Config& cfg, float r, float at, float mag,
+              float ax, float ay, float az, uint64_t ts,
+              Periodic&& periodic, Spectrum&& spectrum, Fire&& fire) noexcept {
+        switch(st){
         case S::IDLE:
             if(r>=at){
-                st_=S::CONFIRM; sc_=1; pk_=mag; t0_=ts; zc_=0; ps_=(ax>=0);
-                ap_[0]=std::abs(ax); ap_[1]=std::abs(ay); ap_[2]=std::abs(az);
-                ae_[0]=ax*ax; ae_[1]=ay*ay; ae_[2]=az*az;
+                st=S::CONFIRM; sc=1; pk=mag; t0=ts;
+                ap[0]=std::abs(ax); ap[1]=std::abs(ay); ap[2]=std::abs(az);
+                ae[0]=ax*ax; ae[1]=ay*ay; ae[2]=az*az;
             } break;
         case S::CONFIRM:
             if(r>=at){
-                ++sc_; pk_=std::max(pk_,mag);
-                ap_[0]=std::max(ap_[0],std::abs(ax));
-                ap_[1]=std::max(ap_[1],std::abs(ay));
-                ap_[2]=std::max(ap_[2],std::abs(az));
-                ae_[0]+=ax*ax; ae_[1]+=ay*ay; ae_[2]+=az*az;
-                bool sg=(ax>=0); if(sg!=ps_)++zc_; ps_=sg;
-                if(sc_>=cfg_.min_sustained){
-                    RejectCode rc=check_reject();
-                    if(rc!=RejectCode::NONE){lr_=rc;st_=S::IDLE;cd_=cfg_.cooldown;break;}
-                    st_=S::TRIGGERED; dur_=sc_; fire(ts,r);
+                ++sc; pk=std::max(pk,mag);
+                ap[0]=std::max(ap[0],std::abs(ax));
+                ap[1]=std::max(ap[1],std::abs(ay));
+                ap[2]=std::max(ap[2],std::abs(az));
+                ae[0]+=ax*ax; ae[1]+=ay*ay; ae[2]+=az*az;
+                if(sc>=cfg.min_sustained){
+                    RejectCode rc=check_reject(cfg,periodic,spectrum());
+                    if(rc!=RejectCode::NONE){lr=rc;++rejects;st=S::IDLE;cd=cfg.cooldown;break;}
+                    st=S::TRIGGERED; dur=sc; fire(event(cfg,r));
                 }
-            } else st_=S::IDLE;
+            } else st=S::IDLE;
             break;
         case S::TRIGGERED:
-            ++dur_; pk_=std::max(pk_,mag);
-            if(r<cfg_.sta_lta_detrigger){fire(ts,r);reset_st();}
+            ++dur; pk=std::max(pk,mag);
+            if(r<cfg.sta_lta_detrigger){fire(event(cfg,r));reset(cfg);}
             break;
         }
     }
 
-    void reset() noexcept {
-        hx_.reset();hy_.reset();hz_.reset();
-        bpx_.reset();bpy_.reset();bpz_.reset();
-        grav_.reset();
-        sta_.reset();lta_.reset();cal_.reset();per_.reset();
-        reset_st(); total_=0;
+    // True if step(r, at) would run check_reject() (C20 attribution).
+    bool confirms(const Config& cfg, float r, float at) const noexcept {
+        return st==S::CONFIRM&&r>=at&&sc+1>=cfg.min_sustained;
     }
 
-private:
-    enum class S:uint8_t{IDLE,CONFIRM,TRIGGERED};
-    Config cfg_;
-    HighPassState hx_,hy_,hz_;
-    BandPassFilter bpx_,bpy_,bpz_;   // B1: 1–15 Hz band-pass per axis
-    GravityEstimator grav_;            // B2: orientation-independent linear accel
-    Ring<float,100> sta_; Ring<float,1000> lta_;
-    Ring<float,5000> cal_; Ring<float,200> per_;
-    S st_=S::IDLE; uint32_t sc_=0,dur_=0,cd_=0,zc_=0;
-    float pk_=0; uint64_t t0_=0; bool ps_=false;
-    float ap_[3]={}, ae_[3]={};
-    uint64_t total_=0; RejectCode lr_=RejectCode::NONE;
-    EventCB on_ev_; DebugCB on_dbg_;
-
-    void apply() noexcept {
-        sta_.set_cap(cfg_.sta_window); lta_.set_cap(cfg_.lta_window);
-        cal_.set_cap(cfg_.calib_window);
-        per_.set_cap(uint32_t(4.f*cfg_.sample_rate_hz));
+    // C11: the spectral bank only runs while it can matter — confirming, or
+    // idle with r ≥ kArm·trigger — and restarts from zero when re-armed, so
+    // it costs nothing while the ratio is quiet.
+    static constexpr float kArm=0.5f;
+    bool wants_spectrum(float r, float at) const noexcept {
+        return st==S::CONFIRM||(st==S::IDLE&&r>=kArm*at);
     }
 
-    RejectCode check_reject() const noexcept {
-        float mx=std::max({ap_[0],ap_[1],ap_[2]});
-        float mn=std::min({ap_[0],ap_[1],ap_[2]});
-        if(mx>0&&(mn/mx)<cfg_.axis_coherence_min) return RejectCode::AXIS_COHERENCE;
+    // C11: FREQUENCY rejects a dominant peak outside [pwave_freq_min, max]
+    // (i.e. in a guard bin) or less than kMinBand of the power in band.
+    static constexpr float kMinBand=0.25f;
 
-        float ds=float(sc_)*cfg_.dt();
-        if(ds>0){
-            float f=float(zc_)/(2.f*ds);
-            if(f<cfg_.pwave_freq_min||f>cfg_.pwave_freq_max) return RejectCode::FREQUENCY;
-        }
+    template<class Periodic>
+    RejectCode check_reject(const Config& cfg, Periodic&& periodic, SpectralPeak sp) noexcept {
+        float mx=std::max({ap[0],ap[1],ap[2]});
+        float mn=std::min({ap[0],ap[1],ap[2]});
+        if(mx>0&&(mn/mx)<cfg.axis_coherence_min) return RejectCode::AXIS_COHERENCE;
 
-        if(per_.full()){
-            float mc=autocorr(); if(mc>cfg_.periodicity_thresh) return RejectCode::PERIODICITY;
-        }
+        fq=sp.freq_hz;
+        if(fq<cfg.pwave_freq_min||fq>cfg.pwave_freq_max||sp.band<kMinBand)
+            return RejectCode::FREQUENCY;
+
+        if(periodic(cfg.periodicity_thresh)) return RejectCode::PERIODICITY;
 
-        float te=ae_[0]+ae_[1]+ae_[2];
+        float te=ae[0]+ae[1]+ae[2];
         if(te>0){
-            float me=std::max({ae_[0],ae_[1],ae_[2]});
+            float me=std::max({ae[0],ae[1],ae[2]});
             if((me/te)>0.85f) return RejectCode::ENERGY_DIST;
         }
         return RejectCode::NONE;
     }
 
-    float autocorr() const noexcept {
-        uint32_t n=per_.size(); if(n<60)return 0;
-        float m=0; for(uint32_t i=0;i<n;++i)m+=per_.at(i); m/=float(n);
-        float v=0; for(uint32_t i=0;i<n;++i){float d=per_.at(i)-m;v+=d*d;}
-        if(v<1e-10f)return 0;
-        uint32_t l0=uint32_t(cfg_.sample_rate_hz/2.5f);
-        uint32_t l1=uint32_t(cfg_.sample_rate_hz/1.5f);
-        float best=0;
-        for(uint32_t lag=l0;lag<=l1&&lag<n/2;++lag){
-            float c=0;
-            for(uint32_t i=0;i<n-lag;++i)c+=(per_.at(i)-m)*(per_.at(i+lag)-m);
-            c/=v; best=std::max(best,c);
-        }
-        return best;
-    }
-
     static AlertLevel severity(float g) noexcept {
         if(g>=0.40f)return AlertLevel::CRITICAL;
         if(g>=0.15f)return AlertLevel::SEVERE;
@@ -303,80 +1030,1328 @@ private:
         return AlertLevel::NONE;
     }
 
-    void fire(uint64_t ts,float r) noexcept {
-        float ds=float(sc_)*cfg_.dt();
-        float f=ds>0?float(zc_)/(2.f*ds):0;
-        if(on_ev_) on_ev_({severity(pk_),pk_,r,f,t0_,dur_});
+    SeismicEvent event(const Config&, float r) const noexcept {
+        return {severity(pk),pk,r,fq,t0,dur};
     }
 
-    void emit_dbg(float rm,float fm,float s,float l,float r,float bv,float at,uint64_t ts) noexcept {
-        if(on_dbg_) on_dbg_({rm,fm,s,l,r,bv,at,uint8_t(st_),lr_,ts});
+    void reset(const Config& cfg) noexcept {
+        st=S::IDLE;sc=dur=0;pk=0;fq=0;t0=0;cd=cfg.cooldown;
+        ap[0]=ap[1]=ap[2]=0;ae[0]=ae[1]=ae[2]=0;
+        lr=RejectCode::NONE;
     }
+};
 
-    void reset_st() noexcept {
-        st_=S::IDLE;sc_=dur_=0;pk_=0;t0_=0;cd_=cfg_.cooldown;
-        zc_=0;ps_=false;ap_[0]=ap_[1]=ap_[2]=0;ae_[0]=ae_[1]=ae_[2]=0;
-        lr_=RejectCode::NONE;
+// ---------------------------------------------------------------------------
+// C14: Detector state snapshot. Versioned little-endian image of what a cold
+// start would otherwise have to re-learn:
+//   header (32 B): magic u32 | version u32 | bytes u32 | checksum u32 |
+//                  saved_ms u64 | sample_rate f32 | window_mode u8 |
+//                  arith u8 (0 float, 1 fixed point — C15) |
+//                  storage u8 (C26 WindowStorage) | pad u8
+//   payload: filter chain 21×f32 (gravity, 2 biquads, HP; x/y/z each) |
+//            recursive windows 4×f32, k u32 | pre-gate gravity + energy
+//            4×f32, quiet u32 | cooldown u32 | samples u64 | low u8 |
+//            quiet_sta f32 | ring sums 6×f32 (Σ, Σ² of sta, lta, cal) |
+//            n u32 | window sizes 4×u32 (sta, lta, cal, periodicity) |
+//            n×f32 filtered magnitudes, oldest first
+// checksum is FNV-1a over the payload. Every window holds a suffix of the
+// same magnitude stream, so one history restores all of them: ~10 KB at
+// 50 Hz with boxcar windows, <1 KB recursive. The trigger restarts IDLE
+// (cooldown kept), the spectral bank cold and the pre-gate awake.
+// ---------------------------------------------------------------------------
+struct SnapshotHeader {
+    static constexpr uint32_t kMagic = 0x31534453;   // "SDS1"
+    static constexpr uint32_t kVersion = 1;
+    uint32_t magic, version, bytes, checksum;
+    uint64_t saved_ms; float sample_rate_hz; uint8_t window_mode, arith, storage, pad;
+};
+static_assert(sizeof(SnapshotHeader) == 32, "snapshot header layout is versioned");
+
+inline uint32_t fnv1a(const uint8_t* p, size_t n) noexcept {
+    uint32_t h=2166136261u;
+    for(size_t i=0;i<n;++i){ h^=p[i]; h*=16777619u; }
+    return h;
+}
+
+// Adaptive trigger (A1): base + sqrt(baseline variance)*100, clamped.
+inline float adaptive_trigger(const Config& cfg, float bv) noexcept {
+    return std::clamp(cfg.sta_lta_trigger+std::sqrt(bv)*100.f,
+                      cfg.adaptive_trig_min, cfg.adaptive_trig_max);
+}
+
+// ---------------------------------------------------------------------------
+// C19: Event sinks. A detector template argument receiving
+//   event(e)       every SeismicEvent, inline on the sensor thread
+//   debug(t)       a DebugTelemetry record, if wants_debug()
+// kTelemetry = false compiles the whole telemetry path out, shared ring
+// included, so replay and bank builds pay nothing for it.
+// ---------------------------------------------------------------------------
+struct NullSink {
+    static constexpr bool kTelemetry = false;
+    void event(const SeismicEvent&) noexcept {}
+    void debug(const DebugTelemetry&) noexcept {}
+    bool wants_debug() const noexcept { return false; }
+};
+
+// Appends events to a caller-owned vector (replay, verification); null
+// out stops recording.
+struct RecordingSink {
+    static constexpr bool kTelemetry = false;
+    std::vector<SeismicEvent>* out = nullptr;
+    void event(const SeismicEvent& e) { if(out) out->push_back(e); }
+    void debug(const DebugTelemetry&) noexcept {}
+    bool wants_debug() const noexcept { return false; }
+};
+
+// The pre-C19 std::function callbacks; SeismicDetector's default.
+struct FunctionSink {
+    static constexpr bool kTelemetry = true;
+    using EventCB = std::function<void(const SeismicEvent&)>;
+    using DebugCB = std::function<void(const DebugTelemetry&)>;
+    FunctionSink(EventCB on_ev = nullptr, DebugCB on_dbg = nullptr)
+        : on_ev_(std::move(on_ev)), on_dbg_(std::move(on_dbg)) {}
+    void event(const SeismicEvent& e) { if(on_ev_) on_ev_(e); }
+    void debug(const DebugTelemetry& t) { on_dbg_(t); }
+    bool wants_debug() const noexcept { return bool(on_dbg_); }
+    EventCB on_ev_; DebugCB on_dbg_;
+};
+
+// C14: sequential access to a snapshot payload.
+struct SnapshotOut {
+    uint8_t* p;
+    template<typename T> void put(const T& v) noexcept { std::memcpy(p,&v,sizeof(v)); p+=sizeof(v); }
+};
+struct SnapshotIn {
+    const uint8_t* p;
+    template<typename T> void get(T& v) noexcept { std::memcpy(&v,p,sizeof(v)); p+=sizeof(v); }
+};
+
+// STA, LTA and calibration variance in g once the windows are ready.
+struct WindowLevels { float sta, lta, var; };
+
+// C15: arithmetic policy of BasicSeismicDetector. A policy supplies the
+// filter chain, the magnitude, the windows behind STA/LTA, baseline and
+// periodicity, and its part of the C14 payload; control flow, pre-gate,
+// wake, snapshot framing and emission exist once, in the detector.
+// FloatMath is the float/NEON path, FixedMath (fixed_detector.hpp) the
+// integer one. Windows::low() and unarmed() screen a ready sample before
+// levels() is needed; a sample they pass goes through the shared float
+// TriggerState / SpectralBank logic with levels() and axes().
+//
+// FloatWindows: C4 boxcar rings in the C26 storage (C8: only in BOXCAR
+// mode) or the C8 recursive STA/LTA, plus the C3 periodicity tracker.
+class FloatWindows {
+public:
+    PeriodicityTracker<1024,64> per;                            // C3: 4 s up to 200 Hz
+
+    // C13: window lengths resize in place keeping their newest samples; a
+    // new rate or window mode starts the affected windows cold, a new
+    // storage (C26) re-rounds the current samples.
+    void apply(const Config& cfg, bool rate, bool mode, bool store) noexcept {
+        if(cfg.window_mode==WindowMode::BOXCAR){
+            bool boxed=boxes([](auto&){});
+            if(!boxed||store){
+                if(cfg.window_storage==WindowStorage::F16) rebox(box_h_,cfg,boxed&&!rate);
+                else if(cfg.window_storage==WindowStorage::U16) rebox(box_q_,cfg,boxed&&!rate);
+                else rebox(box_,cfg,boxed&&!rate);
+            } else if(rate){
+                boxes([&cfg](auto& b){
+                    b.sta.set_cap(cfg.sta_window); b.lta.set_cap(cfg.lta_window);
+                    b.cal.set_cap(cfg.calib_window);
+                });
+            } else {
+                boxes([&cfg](auto& b){
+                    b.sta.resize(cfg.sta_window); b.lta.resize(cfg.lta_window);
+                    b.cal.resize(cfg.calib_window);
+                });
+            }
+        } else {
+            box_.reset(); box_h_.reset(); box_q_.reset();
+        }
+        if(rate||mode) rec_.configure(cfg.sta_window, cfg.lta_window, cfg.calib_window);
+        else rec_.resize(cfg.sta_window, cfg.lta_window, cfg.calib_window);
+        if(rate) per.configure(uint32_t(4.f*cfg.sample_rate_hz),
+                               uint32_t(cfg.sample_rate_hz/2.5f), uint32_t(cfg.sample_rate_hz/1.5f));
+    }
+
+    void reset() noexcept {
+        boxes([](auto& b){ b.sta.reset(); b.lta.reset(); b.cal.reset(); });
+        rec_.reset(); per.reset(); quiet_sta_=0;
+    }
+
+    // Filtered magnitude into every window; false until the LTA is ready.
+    bool push(float mag) noexcept {
+        per.push(mag);
+        bool ready=true;
+        if(!boxes([&](auto& b){
+            b.sta.push(mag); b.lta.push(mag); b.cal.push(mag);
+            if(!(ready=b.lta.full())) return;
+            lv_={b.sta.avg(), b.lta.avg(), b.cal.var()};
+        })) {                                          // C8: recursive
+            rec_.push(mag);
+            if(!rec_.ready()) return false;
+            lv_={rec_.sta, rec_.lta, rec_.var};
+        }
+        return ready;
+    }
+
+    // After a ready push(): LTA below min_amplitude_g. Also keeps the STA
+    // a falling-asleep pre-gate later advances recursive windows at (C9).
+    bool low(const Config& cfg) noexcept { quiet_sta_=lv_.sta; return lv_.lta<cfg.min_amplitude_g; }
+    bool unarmed() const noexcept { return false; }
+    WindowLevels levels() const noexcept { return lv_; }
+
+    // C9: n unrecorded quiet samples. Recursive windows decay as if they had
+    // been fed in; boxcar windows already hold only quiet samples
+    // (pregate_hold ≥ LTA).
+    void advance(uint64_t n) noexcept { if(!boxes([](auto&){})) rec_.advance(quiet_sta_,n); }
+
+    // C14 payload parts (SnapshotHeader): recursive windows ahead of the
+    // pre-gate; quiet_sta, ring sums, sizes and history after low.
+    uint32_t history() const noexcept {
+        uint32_t n=per.size();
+        boxes([&n](const auto& b){ n=std::max({n,b.sta.size(),b.lta.size(),b.cal.size()}); });
+        return n;
+    }
+    void save_head(SnapshotOut& o) const noexcept {
+        o.put(rec_.sta); o.put(rec_.lta); o.put(rec_.mean); o.put(rec_.var); o.put(rec_.k);
+    }
+    void load_head(SnapshotIn& in) noexcept {
+        in.get(rec_.sta); in.get(rec_.lta); in.get(rec_.mean); in.get(rec_.var); in.get(rec_.k);
+        rec_.k=std::min(rec_.k,rec_.k_max);
+    }
+    void save_tail(SnapshotOut& o) const noexcept {
+        uint32_t ns=0, nl=0, nc=0, np=per.size();
+        float sums[6]={};
+        boxes([&](const auto& b){
+            ns=b.sta.size(); nl=b.lta.size(); nc=b.cal.size();
+            sums[0]=b.sta.sum(); sums[1]=b.sta.sum_sq(); sums[2]=b.lta.sum();
+            sums[3]=b.lta.sum_sq(); sums[4]=b.cal.sum(); sums[5]=b.cal.sum_sq();
+        });
+        uint32_t nh=history();
+        o.put(quiet_sta_);
+        for(float v : sums) o.put(v);
+        o.put(nh); o.put(ns); o.put(nl); o.put(nc); o.put(np);
+        // C26: each sample from the float window holding it where there is
+        // one; compact rings re-round what they get back to what they held.
+        auto from=[nh](const auto& r, uint32_t i){ return r.at(i+r.size()-nh); };
+        if(!boxes([&](const auto& b){
+            for(uint32_t i=0;i<nh;++i)
+                o.put(i+np>=nh ? per.sample(i+np-nh) : i+ns>=nh ? from(b.sta,i)
+                      : nc>=nl ? from(b.cal,i) : from(b.lta,i));
+        })) for(uint32_t i=0;i<nh;++i) o.put(per.sample(i));
+    }
+    // same_storage: the image was taken with the current C26 storage.
+    void load_tail(SnapshotIn& in, bool same_storage) noexcept {
+        uint32_t nh,ns,nl,nc,np;
+        in.get(quiet_sta_);
+        float sums[6]; for(float& v : sums) in.get(v);
+        in.get(nh); in.get(ns); in.get(nl); in.get(nc); in.get(np);
+        auto fill=[&](uint32_t k, auto&& push){
+            for(uint32_t i=nh-std::min(k,nh);i<nh;++i){ float v; std::memcpy(&v,in.p+size_t(i)*4,4); push(v); }
+        };
+        boxes([&](auto& b){
+            fill(ns,[&b](float v){ b.sta.push(v); });
+            fill(nl,[&b](float v){ b.lta.push(v); });
+            fill(nc,[&b](float v){ b.cal.push(v); });
+            // Stored sums only hold for the window they were taken over, and
+            // for LTA/calibration samples rounded the same way (C26).
+            if(b.sta.size()==ns) b.sta.set_sums(sums[0],sums[1]);
+            if(same_storage&&b.lta.size()==nl) b.lta.set_sums(sums[2],sums[3]);
+            if(same_storage&&b.cal.size()==nc) b.cal.set_sums(sums[4],sums[5]);
+        });
+        fill(np,[this](float v){ per.push(v); });
+    }
+
+private:
+    // C4: pow2 storage. C8: ~41 KB (C26: ~21 KB compact), so heap-allocated
+    // and only in BOXCAR mode; at most one of box_* is set.
+    template<typename S>
+    struct BoxcarWindows {
+        Ring<float,Config::kMaxSta> sta; Ring<float,Config::kMaxLta,float,S> lta; Ring<float,Config::kMaxCalib,float,S> cal;
+    };
+    std::unique_ptr<BoxcarWindows<float>> box_;
+    std::unique_ptr<BoxcarWindows<Half>> box_h_;                // C26: F16
+    std::unique_ptr<BoxcarWindows<UQ14>> box_q_;                // C26: U16
+    RecursiveStaLta rec_;                                       // C8
+    WindowLevels lv_{};                // last ready push()
+    float quiet_sta_=0;                // STA when the gate went to sleep
+
+    // C26: f(windows) on whichever boxcar windows exist; false if none (C8).
+    template<typename F> bool boxes(F&& f) {
+        if(box_) f(*box_); else if(box_h_) f(*box_h_); else if(box_q_) f(*box_q_); else return false;
+        return true;
+    }
+    template<typename F> bool boxes(F&& f) const {
+        if(box_) f(*box_); else if(box_h_) f(*box_h_); else if(box_q_) f(*box_q_); else return false;
+        return true;
+    }
+    // C26: new windows in to's storage, sized for cfg. With keep they are
+    // seeded with the newest samples of the current ones (a storage change
+    // at the same rate), like a C13 resize; otherwise they start cold.
+    template<typename S>
+    void rebox(std::unique_ptr<BoxcarWindows<S>>& to, const Config& cfg, bool keep) {
+        std::unique_ptr<BoxcarWindows<S>> b(new BoxcarWindows<S>);
+        b->sta.set_cap(cfg.sta_window); b->lta.set_cap(cfg.lta_window); b->cal.set_cap(cfg.calib_window);
+        if(keep) boxes([&b](const auto& o){
+            auto copy=[](const auto& src, auto& dst){
+                uint32_t n=src.size(), k=std::min(n,dst.capacity());
+                for(uint32_t i=n-k;i<n;++i) dst.push(src.at(i));
+            };
+            copy(o.sta,b->sta); copy(o.lta,b->lta); copy(o.cal,b->cal);
+        });
+        box_.reset(); box_h_.reset(); box_q_.reset();
+        to=std::move(b);
+    }
+};
+
+struct FloatMath {
+    using Chain = AxisFilterChain;     // C2: B2 gravity + B1 band-pass + HP, x/y/z lanes
+    using Filtered = simd::f4;
+    using Mag = float;
+    using Windows = FloatWindows;
+    static constexpr uint8_t kArith = 0;                        // SnapshotHeader::arith
+    // C14: chain 21×f32, recursive windows 5×4, quiet_sta f32, ring sums 6×f32.
+    static constexpr size_t kSnapshotState = 21*4 + 5*4 + 4 + 6*4;
+
+    static Config supported(const Config& c) noexcept { return c; }
+    static Filtered filter(Chain& c, float x, float y, float z) noexcept { return c.process(x, y, z); }
+    static Mag magnitude(Filtered f) noexcept {
+        float x=simd::lane(f,0), y=simd::lane(f,1), z=simd::lane(f,2);
+        return std::sqrt(x*x+y*y+z*z);
+    }
+    static float g(Mag m) noexcept { return m; }
+    static simd::f4 axes(Filtered f) noexcept { return f; }
+
+    static void save(const Chain& c, SnapshotOut& o) noexcept {
+        auto put3=[&o](simd::f4 v){ for(int i=0;i<3;++i) o.put(simd::lane(v,i)); };
+        put3(c.g); put3(c.hp.w1); put3(c.hp.w2); put3(c.lp.w1); put3(c.lp.w2);
+        put3(c.hp_raw); put3(c.hp_filt);
+    }
+    static void load(Chain& c, SnapshotIn& in) noexcept {
+        auto get3=[&in]{ float x,y,z; in.get(x); in.get(y); in.get(z); return simd::set3(x,y,z); };
+        c.g=get3(); c.hp.w1=get3(); c.hp.w2=get3(); c.lp.w1=get3(); c.lp.w2=get3();
+        c.hp_raw=get3(); c.hp_filt=get3();
     }
 };
+
+// C19: Sink receives events and telemetry; C15: Math is the arithmetic.
+template<class Sink = FunctionSink, class Math = FloatMath>
+class BasicSeismicDetector {
+public:
+    using EventCB = FunctionSink::EventCB;
+    using DebugCB = FunctionSink::DebugCB;
+
+    // Arguments construct the sink, e.g. (on_ev, on_dbg) for FunctionSink.
+    template<class... A, class = std::enable_if_t<std::is_constructible_v<Sink, A&&...>>>
+    explicit BasicSeismicDetector(A&&... a) : sink_(std::forward<A>(a)...) { apply(); }
+
+    Sink& sink() noexcept { return sink_; }
+    const Sink& sink() const noexcept { return sink_; }
+
+    // C13: incremental — see apply(). C15: what Math cannot run is replaced
+    // by what it runs (Math::supported()); config() reports that. C5: a
+    // config that is not valid() is refused (false) and changes nothing.
+    bool update_config(const Config& c) noexcept {
+        if(!c.valid()) return false;
+        Config old=cfg_; cfg_=Math::supported(c); apply(&old);
+        return true;
+    }
+    const Config& config() const noexcept { return cfg_; }
+
+    // C7: optional shared telemetry ring (not owned); written only while
+    // the ring reports a reader via enabled().
+    void set_telemetry_ring(TelemetryRing* r) noexcept { tel_=r; }
+
+    // C16: optional waveform capture (not owned); sees every raw sample,
+    // gated ones included, and every event before the callback does.
+    void set_capture(WaveformCapture* c) noexcept { cap_=c; }
+
+    void process_sample(float ax_r, float ay_r, float az_r, uint64_t ts) noexcept {
+        StageProfile::Tick t0=prof_.now();                             // C20
+        sample(ax_r,ay_r,az_r,ts,t0);
+        prof_.add(Stage::SAMPLE,t0,prof_.now());
+    }
+
+    // C1: xyz holds n interleaved samples [x0,y0,z0,x1,y1,z1,...], ts holds
+    // n timestamps. Identical to n successive process_sample() calls.
+    void process_block(const float* xyz, const uint64_t* ts, size_t n) noexcept {
+        for(size_t i=0;i<n;++i,xyz+=3) process_sample(xyz[0],xyz[1],xyz[2],ts[i]);
+    }
+
+    void reset() noexcept {
+        filt_.reset();
+        win_.reset(); spec_.reset(); spec_on_=false;
+        trg_.reset(cfg_); total_=0;
+        gate_.reset(); asleep_=low_=false; gated_=wakes_=slept_=0;
+        if(cap_) cap_->abort();
+    }
+
+    // C9: pre-gate state and counters since reset().
+    bool asleep() const noexcept { return asleep_; }
+    uint64_t gated_samples() const noexcept { return gated_; }
+    // Samples processed since reset() (gated ones included).
+    uint64_t samples() const noexcept { return total_; }
+    uint64_t wakes() const noexcept { return wakes_; }
+    const TriggerState& trigger() const noexcept { return trg_; }
+    // C22: start the gravity estimate at a known vector instead of face-up.
+    void seed_gravity(float x, float y, float z) noexcept { filt_.seed_gravity(x, y, z); }
+
+    // C20: stage histograms since construction (reset() keeps them).
+    StageProfile& profile() noexcept { return prof_; }
+    const StageProfile& profile() const noexcept { return prof_; }
+
+    // C14: upper bound of snapshot() for any config. Math's state, pre-gate
+    // 5×4, cooldown, samples, low, then the five window sizes.
+    static constexpr size_t kSnapshotFixed = Math::kSnapshotState + 5*4 + 4 + 8 + 1 + 5*4;
+    static constexpr size_t snapshot_capacity() noexcept {
+        return sizeof(SnapshotHeader) + kSnapshotFixed + 8192*4;
+    }
+
+    // C14: writes the current state stamped with saved_ms (the caller's
+    // clock, normally the last sample's timestamp). Returns the image size,
+    // or 0 if cap is too small.
+    size_t snapshot(void* out, size_t cap, uint64_t saved_ms) const noexcept {
+        size_t bytes=sizeof(SnapshotHeader)+kSnapshotFixed+size_t(win_.history())*4;
+        if(!out||cap<bytes) return 0;
+        auto* base=static_cast<uint8_t*>(out);
+        SnapshotOut o{base+sizeof(SnapshotHeader)};
+        Math::save(filt_,o); win_.save_head(o);
+        o.put(gate_.grav.gx); o.put(gate_.grav.gy); o.put(gate_.grav.gz); o.put(gate_.e); o.put(gate_.quiet);
+        o.put(trg_.cd); o.put(total_); o.put(uint8_t(low_));
+        win_.save_tail(o);
+        SnapshotHeader h{SnapshotHeader::kMagic, SnapshotHeader::kVersion, uint32_t(bytes),
+                         fnv1a(base+sizeof(h), bytes-sizeof(h)), saved_ms,
+                         cfg_.sample_rate_hz, uint8_t(cfg_.window_mode), Math::kArith,
+                         uint8_t(cfg_.window_storage), 0};
+        std::memcpy(base,&h,sizeof(h));
+        return bytes;
+    }
+
+    // C14: resumes from an image taken at most max_age_ms before now_ms with
+    // the same arithmetic, sample rate and window mode; windows that have
+    // since changed length keep the newest samples. Returns false (and
+    // changes nothing) if the image is torn, stale or from another
+    // configuration.
+    bool restore(const void* in, size_t n, uint64_t now_ms, uint64_t max_age_ms) noexcept {
+        SnapshotHeader h;
+        if(!in||n<sizeof(h)) return false;
+        auto* base=static_cast<const uint8_t*>(in);
+        std::memcpy(&h,base,sizeof(h));
+        if(h.magic!=SnapshotHeader::kMagic||h.version!=SnapshotHeader::kVersion||h.arith!=Math::kArith) return false;
+        if(h.bytes<sizeof(h)+kSnapshotFixed||h.bytes>n) return false;
+        if(h.sample_rate_hz!=cfg_.sample_rate_hz||h.window_mode!=uint8_t(cfg_.window_mode)) return false;
+        if(now_ms<h.saved_ms||now_ms-h.saved_ms>max_age_ms) return false;
+        if(fnv1a(base+sizeof(h),h.bytes-sizeof(h))!=h.checksum) return false;
+        uint32_t nh; uint8_t low;
+        std::memcpy(&nh,base+sizeof(h)+kSnapshotFixed-5*4,4);
+        if(h.bytes!=sizeof(h)+kSnapshotFixed+size_t(nh)*4) return false;
+
+        reset();
+        SnapshotIn i{base+sizeof(h)};
+        Math::load(filt_,i); win_.load_head(i);
+        i.get(gate_.grav.gx); i.get(gate_.grav.gy); i.get(gate_.grav.gz); i.get(gate_.e); i.get(gate_.quiet);
+        i.get(trg_.cd); i.get(total_); i.get(low); low_=low!=0;
+        win_.load_tail(i, h.storage==uint8_t(cfg_.window_storage));
+        return true;
+    }
+
+private:
+    using Filtered = typename Math::Filtered;
+    using Mag = typename Math::Mag;
+
+    Config cfg_;
+    typename Math::Chain filt_;
+    const FilterDesign* design_=nullptr; // C5: active coefficient set
+    typename Math::Windows win_;
+    SpectralBank spec_;                                         // C11
+    bool spec_on_=false;
+    TriggerState trg_;
+    uint64_t total_=0;
+    EnergyGate gate_;                                           // C9
+    bool asleep_=false, low_=false;    // low_: last LTA below min_amplitude_g
+    uint64_t gated_=0, wakes_=0, slept_=0;
+    Sink sink_;                                                 // C19
+    TelemetryRing* tel_=nullptr;
+    WaveformCapture* cap_=nullptr;                              // C16
+    StageProfile prof_;                                         // C20
+
+    // process_sample() proper; t is the C20 lap clock.
+    void sample(float ax_r, float ay_r, float az_r, uint64_t ts, StageProfile::Tick t) noexcept {
+        ++total_;
+        if(cap_) cap_->push(ax_r,ay_r,az_r,ts);
+        if(cfg_.pregate){                                           // C9
+            bool g=gated(ax_r,ay_r,az_r);
+            prof_.lap(Stage::GATE,t);
+            if(g) return;
+        }
+        if(trg_.cd>0){--trg_.cd;return;}
+
+        // C2: B2 gravity removal → B1 band-pass 1–15 Hz → legacy high-pass
+        // (hp_alpha=0.98 → ~0.16 Hz cutoff, well below band-pass lower edge),
+        // all three axes.
+        Filtered f=Math::filter(filt_, ax_r, ay_r, az_r);
+        Mag mag=Math::magnitude(f);
+        prof_.lap(Stage::FILTER,t);
+
+        bool ready=win_.push(mag);
+        prof_.lap(Stage::WINDOWS,t);
+        if(!ready) return;
+
+        low_=win_.low(cfg_);
+        if(low_||(trg_.st==TriggerState::S::IDLE&&win_.unarmed())){
+            spec_on_=false;                                        // C11: disarmed
+            if(total_%10==0&&dbg_wanted()) emit_dbg(mag,ts);
+            return;
+        }
+        WindowLevels v=win_.levels();
+        float at=adaptive_trigger(cfg_,v.var), r=v.sta/v.lta;
+        if(total_%10==0&&dbg_wanted()) emit(Math::g(mag),v.sta,v.lta,r,v.var,at,ts);
+
+        simd::f4 fv=Math::axes(f);
+        bool on=trg_.wants_spectrum(r,at);                         // C11
+        if(on){ if(!spec_on_) spec_.reset(); spec_.push(fv); prof_.lap(Stage::SPECTRUM,t); }
+        spec_on_=on;
+
+        Stage st=StageProfile::kEnabled&&trg_.confirms(cfg_,r,at) ? Stage::REJECT : Stage::TRIGGER;
+        trg_.step(cfg_, r, at, Math::g(mag),
+            simd::lane(fv,0), simd::lane(fv,1), simd::lane(fv,2), ts,
+            [this](float th){
+                StageProfile::Tick a=prof_.now();
+                win_.per.track(true);                              // no-op while confirming
+                bool p=win_.per.full()&&win_.per.score()>th;
+                prof_.add(Stage::AUTOCORR,a,prof_.now());
+                return p;
+            },
+            [this]{ return spec_.peak(); },
+            [this](const SeismicEvent& e){ fire(e); });
+        win_.per.track(trg_.st==TriggerState::S::CONFIRM);         // C3: candidate open
+        prof_.lap(st,t);
+    }
+
+    // prev is the config being replaced (null at construction). C13: thresholds
+    // and gains need nothing here — they are read per sample. Window lengths
+    // resize in place keeping their newest samples; only a new sample rate
+    // (history no longer matches the windows) or a newly selected window
+    // mode starts the affected windows cold. A sleeping pre-gate is only
+    // woken when the change invalidates its sleep or its pre-roll.
+    void apply(const Config* prev=nullptr) noexcept {
+        bool rate=!prev||prev->sample_rate_hz!=cfg_.sample_rate_hz;
+        bool mode=!prev||prev->window_mode!=cfg_.window_mode;
+        bool store=!prev||prev->window_storage!=cfg_.window_storage;
+        if(asleep_&&(rate||mode||!cfg_.pregate||prev->pregate_warmup!=cfg_.pregate_warmup||
+                     prev->min_amplitude_g!=cfg_.min_amplitude_g))
+            wake();                    // C9: hand over with warm filters first
+        // C5: switch coefficient set only when the rate class changes
+        const FilterDesign& d=filter_design_for(cfg_.sample_rate_hz);
+        if(design_!=&d){ design_=&d; filt_=typename Math::Chain(d); }
+        filt_.set_hp_alpha(cfg_.hp_alpha);
+        win_.apply(cfg_, rate, mode, store);
+        gate_.configure(cfg_.pregate?cfg_.pregate_warmup:0, cfg_.sta_window, d.grav_alpha);
+        if(rate||prev->pwave_freq_min!=cfg_.pwave_freq_min||prev->pwave_freq_max!=cfg_.pwave_freq_max){
+            spec_.configure(cfg_.sample_rate_hz, cfg_.pwave_freq_min, cfg_.pwave_freq_max);
+            spec_on_=false;
+        }
+    }
+
+    // C9: true if the sample was consumed by the gate alone. Sleeps only
+    // after pregate_hold quiet samples with the trigger idle, out of cooldown
+    // and the LTA below min_amplitude_g, i.e. when no trigger was possible.
+    bool gated(float x, float y, float z) noexcept {
+        bool hot=gate_.hot(x,y,z,cfg_.pregate_g*cfg_.pregate_g);
+        if(asleep_){ if(hot) wake(); }
+        else if(gate_.quiet>=cfg_.pregate_hold&&low_&&
+                trg_.st==TriggerState::S::IDLE&&trg_.cd==0){ asleep_=true; slept_=0; }
+        gate_.record(x,y,z);
+        if(asleep_){ ++gated_; ++slept_; }
+        return asleep_;
+    }
+
+    // C9: a short sleep is replayed in full through the live chain (same
+    // result as never sleeping). After a longer one the chain restarts from
+    // the gate's gravity and is warmed on the pre-roll, and the windows are
+    // advanced over the unrecorded part (Windows::advance()); either way the
+    // replayed samples also refresh the windows.
+    // Out of line so the replay loop does not cost the hot path its inlining.
+    __attribute__((noinline, cold)) void wake() noexcept {
+        asleep_=false; ++wakes_;
+        uint32_t pre=uint32_t(std::min<uint64_t>(slept_,gate_.size()));
+        if(slept_>pre){
+            filt_.reset();
+            filt_.seed_gravity(gate_.grav.gx,gate_.grav.gy,gate_.grav.gz);
+            win_.advance(slept_-pre);
+        }
+        gate_.replay(pre,[this](float x,float y,float z){
+            win_.push(Math::magnitude(Math::filter(filt_,x,y,z)));
+        });
+    }
+
+    void fire(const SeismicEvent& e) noexcept {
+        if(cap_) cap_->on_event(e.time_ms,uint8_t(e.level),e.peak_g,e.duration);
+        sink_.event(e);
+    }
+
+    bool dbg_wanted() const noexcept {
+        if constexpr(Sink::kTelemetry) return (tel_&&tel_->enabled())||sink_.wants_debug();
+        else return false;
+    }
+    // Telemetry for a screened-out sample; its levels are read only here.
+    __attribute__((noinline)) void emit_dbg(Mag mag, uint64_t ts) noexcept {
+        WindowLevels v=win_.levels();
+        emit(Math::g(mag),v.sta,v.lta,low_?0:v.sta/v.lta,v.var,adaptive_trigger(cfg_,v.var),ts);
+    }
+    void emit(float m,float s,float l,float r,float bv,float at,uint64_t ts) noexcept {
+        DebugTelemetry t{m,m,s,l,r,bv,at,uint8_t(trg_.st),trg_.lr,ts};
+        if(tel_&&tel_->enabled()) tel_->write(t);
+        if(sink_.wants_debug()) sink_.debug(t);
+    }
+};
+
+using SeismicDetector = BasicSeismicDetector<>;
+
+// Config as a float array, in SeismicConfig.kt order (JNI, dart:ffi and the
+// sinyalist_detector.h C ABI). Missing trailing entries keep the
+// Config::at_rate() defaults for the given rate. C5: a rate without a
+// filter design runs at Config::nearest_rate(); callers that cannot
+// resample to it check Config::rate_supported() on the array first.
+enum ConfigIndex : int32_t {
+    CFG_SAMPLE_RATE, CFG_TRIGGER, CFG_DETRIGGER, CFG_MIN_AMPLITUDE, CFG_COHERENCE,
+    CFG_PERIODICITY, CFG_TRIG_MIN, CFG_TRIG_MAX, CFG_FREQ_MIN, CFG_FREQ_MAX,
+    CFG_WINDOW_MODE, CFG_PREGATE, CFG_WINDOW_STORAGE, CFG_COUNT
+};
+inline Config config_from(const float* v, int32_t n) noexcept {
+    Config c = Config::at_rate(Config::nearest_rate(n>CFG_SAMPLE_RATE ? v[CFG_SAMPLE_RATE] : 0.0f));
+    auto set = [&](int32_t i, float& f){ if(i<n) f=v[i]; };
+    set(CFG_TRIGGER, c.sta_lta_trigger); set(CFG_DETRIGGER, c.sta_lta_detrigger);
+    set(CFG_MIN_AMPLITUDE, c.min_amplitude_g); set(CFG_COHERENCE, c.axis_coherence_min);
+    set(CFG_PERIODICITY, c.periodicity_thresh);
+    set(CFG_TRIG_MIN, c.adaptive_trig_min); set(CFG_TRIG_MAX, c.adaptive_trig_max);
+    set(CFG_FREQ_MIN, c.pwave_freq_min); set(CFG_FREQ_MAX, c.pwave_freq_max);
+    if(CFG_WINDOW_MODE<n) c.window_mode = v[CFG_WINDOW_MODE]!=0 ? WindowMode::RECURSIVE : WindowMode::BOXCAR;
+    if(CFG_PREGATE<n) c.pregate = v[CFG_PREGATE]!=0;
+    if(CFG_WINDOW_STORAGE<n && v[CFG_WINDOW_STORAGE]>=1 && v[CFG_WINDOW_STORAGE]<=2)
+        c.window_storage = WindowStorage(uint8_t(v[CFG_WINDOW_STORAGE]));
+    return c;
+}
 } // namespace sinyalist::seismic
 
 #ifdef __ANDROID__
+#include "resampler.hpp"
+#include "snapshot_file.hpp"
+#include "coincidence_index.hpp"
+#include "latency_trace.hpp"
+#include "native_sensor.hpp"
+#include "sinyalist_ffi.h"
+#if SINYALIST_FIXED_POINT
+#include "fixed_detector.hpp"
+#endif
 #include <jni.h>
 #include <android/log.h>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <semaphore.h>
 #define TAG "SinyalistSeismic"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, TAG, __VA_ARGS__)
 
 namespace {
-    std::unique_ptr<sinyalist::seismic::SeismicDetector> g_det;
-    JavaVM* g_jvm=nullptr; jobject g_cb=nullptr;
-    jmethodID g_ev=nullptr, g_dbg=nullptr;
-}
+// C18: the newest events for the dart:ffi reader. One writer (the dispatcher
+// thread); a reader accepts a record only if its seq matches before and
+// after copying, as with TelemetryRing. Record q carries seq = q+1.
+struct EventLog {
+    static constexpr uint32_t kCapacity = 16;
+    struct Record { std::atomic<uint64_t> seq{0}; sinyalist::seismic::SeismicEvent e{}; uint64_t trace=0; };
+    Record rec[kCapacity];
+    std::atomic<uint64_t> write_seq{0};
+    std::atomic<sinyalist_event_listener> listener{nullptr};
+    std::atomic<uint32_t> calling{0};
 
-extern "C" {
-JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeInit(
-        JNIEnv* env, jobject, jobject cb) {
-    env->GetJavaVM(&g_jvm);
-    g_cb = env->NewGlobalRef(cb);
-    jclass cls = env->GetObjectClass(cb);
-    g_ev = env->GetMethodID(cls, "onSeismicEvent", "(IFFFJI)V");
-    g_dbg = env->GetMethodID(cls, "onDebugTelemetry", "(FFFFFFFIIJ)V");
-
-    g_det = std::make_unique<sinyalist::seismic::SeismicDetector>(
-        [](const sinyalist::seismic::SeismicEvent& e) {
-            JNIEnv* env=nullptr;
-            if(g_jvm->AttachCurrentThread(&env,nullptr)!=JNI_OK)return;
-            env->CallVoidMethod(g_cb, g_ev, (jint)e.level, e.peak_g,
-                e.sta_lta, e.freq_hz, (jlong)e.time_ms, (jint)e.duration);
-        },
-        [](const sinyalist::seismic::DebugTelemetry& t) {
-            if(!g_dbg||!g_cb)return;
-            JNIEnv* env=nullptr;
-            if(g_jvm->AttachCurrentThread(&env,nullptr)!=JNI_OK)return;
-            env->CallVoidMethod(g_cb, g_dbg, t.raw_mag, t.filt_mag,
+    // trace: the event's C24 trace id, handed back by trace_delivered().
+    void write(const sinyalist::seismic::SeismicEvent& e, uint64_t trace) noexcept {
+        uint64_t q=write_seq.load(std::memory_order_relaxed);
+        Record& r=rec[q%kCapacity];
+        r.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        r.e=e; r.trace=trace;
+        r.seq.store(q+1, std::memory_order_release);
+        write_seq.store(q+1, std::memory_order_release);
+    }
+    // seq_cst pairs with set_listener(): once it has seen calling == 0 after
+    // clearing the listener, no call can still pick the old one up.
+    void notify() noexcept {
+        calling.fetch_add(1);
+        if(auto fn=listener.load()) fn(int64_t(write_seq.load(std::memory_order_relaxed)));
+        calling.fetch_sub(1);
+    }
+    void set_listener(sinyalist_event_listener fn) noexcept {
+        listener.store(fn);
+        while(calling.load()) std::this_thread::yield();
+    }
+    // Records after *next (a seq) into out (32 B each, sinyalist_ffi.h).
+    int32_t read(uint64_t& next, uint8_t* out) const noexcept {
+        uint64_t w=write_seq.load(std::memory_order_acquire);
+        uint64_t q=std::max(next, w>kCapacity ? w-kCapacity : 0);
+        int32_t n=0;
+        for(; q<w; ++q) {
+            const Record& r=rec[q%kCapacity];
+            if(r.seq.load(std::memory_order_acquire)!=q+1) continue;
+            sinyalist::seismic::SeismicEvent e=r.e;
+            uint32_t trace=uint32_t(r.trace);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(r.seq.load(std::memory_order_relaxed)!=q+1) continue;
+            uint8_t* o=out+size_t(n++)*SINYALIST_FFI_EVENT_SIZE;
+            std::memset(o, 0, SINYALIST_FFI_EVENT_SIZE);
+            uint8_t lv=uint8_t(e.level);
+            std::memcpy(o, &e.time_ms, 8); std::memcpy(o+8, &e.peak_g, 4); std::memcpy(o+12, &e.sta_lta, 4);
+            std::memcpy(o+16, &e.freq_hz, 4); std::memcpy(o+20, &e.duration, 4); o[24]=lv;
+            std::memcpy(o+28, &trace, 4);
+        }
+        next=w;
+        return n;
+    }
+};
+
+// C6: Detector callbacks only enqueue; this thread attaches to the JVM once
+// and performs every Java upcall. sem_post is a futex wake only when the
+// dispatcher is actually waiting, so the sensor thread never blocks.
+class EventDispatcher {
+public:
+    using Event = sinyalist::seismic::SeismicEvent;
+    using Telemetry = sinyalist::seismic::DebugTelemetry;
+    using Capture = sinyalist::seismic::WaveformCapture;
+
+    // C16: wf (optional) receives each completed capture of cap as a direct
+    // ByteBuffer that is only valid during the call; C17: Steim-2 packed
+    // (WaveformCapture::pack()) into a buffer allocated here.
+    // C18: log (optional) records every event for dart:ffi before the JNI upcall.
+    // C24: trace (optional) gets the DISPATCH and CALLBACK marks of each event.
+    EventDispatcher(JavaVM* jvm, jobject cb, jmethodID ev, jmethodID dbg,
+                    Capture* cap = nullptr, jmethodID wf = nullptr, EventLog* log = nullptr,
+                    sinyalist::seismic::LatencyTrace* trace = nullptr)
+        : jvm_(jvm), cb_(cb), ev_(ev), dbg_(dbg), wf_(wf), cap_(cap), log_(log), trace_(trace) {
+        if(wf_&&cap_&&cap_->configured()){
+            packed_cap_=cap_->packed_bytes();
+            packed_.reset(new uint8_t[packed_cap_]);
+        }
+        sem_init(&wake_, 0, 0);
+        th_ = std::thread([this]{ run(); });
+    }
+    ~EventDispatcher() {
+        stop_.store(true, std::memory_order_release);
+        sem_post(&wake_);
+        if(th_.joinable()) th_.join();
+        sem_destroy(&wake_);
+    }
+    // Sensor thread only. trace: the event's C24 trace id, 0 = untraced.
+    void post(const Event& e, uint64_t trace = 0) noexcept {
+        if(evq_.push(Pending{e, trace})) sem_post(&wake_);
+        else { dropped_ev_.fetch_add(1, std::memory_order_relaxed); dropped_total_.fetch_add(1, std::memory_order_relaxed); }
+    }
+    void post(const Telemetry& t) noexcept {
+        if(!dbg_) return;
+        if(dbgq_.push(t)) sem_post(&wake_);   // telemetry is best-effort
+    }
+    // C16: a capture was published outside an event (slot filled up).
+    void kick() noexcept { sem_post(&wake_); }
+    bool wants_debug() const noexcept { return dbg_!=nullptr; }
+    // C18: totals since construction (any thread).
+    uint64_t delivered() const noexcept { return delivered_.load(std::memory_order_relaxed); }
+    uint32_t dropped() const noexcept { return dropped_total_.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        JNIEnv* env=nullptr;
+        JavaVMAttachArgs args{JNI_VERSION_1_6, "SinyalistDispatch", nullptr};
+        if(jvm_->AttachCurrentThread(&env, &args)!=JNI_OK) return;
+        while(true) {
+            sem_wait(&wake_);
+            drain(env);
+            if(stop_.load(std::memory_order_acquire)) { drain(env); break; }
+        }
+        jvm_->DetachCurrentThread();
+    }
+    void drain(JNIEnv* env) {
+        using sinyalist::seismic::Mark;
+        using sinyalist::seismic::boottime_ns;
+        Pending q; Telemetry t;
+        while(evq_.pop(q)) {
+            const Event& e=q.e;
+            if(trace_) trace_->mark(q.trace, Mark::DISPATCH, boottime_ns());
+            delivered_.fetch_add(1, std::memory_order_relaxed);
+            if(log_){ log_->write(e, q.trace); log_->notify(); }   // C18: Dart first
+            env->CallVoidMethod(cb_, ev_, (jint)e.level, e.peak_g,
+                e.sta_lta, e.freq_hz, (jlong)e.time_ms, (jint)e.duration, (jlong)q.trace);
+            if(env->ExceptionCheck()) env->ExceptionClear();
+            if(trace_) trace_->mark(q.trace, Mark::CALLBACK, boottime_ns());
+        }
+        while(dbgq_.pop(t)) {
+            env->CallVoidMethod(cb_, dbg_, t.raw_mag, t.filt_mag,
                 t.sta, t.lta, t.ratio, t.baseline_var, t.adaptive_trigger,
                 (jint)t.state, (jint)t.reject, (jlong)t.ts);
+            if(env->ExceptionCheck()) env->ExceptionClear();
+        }
+        Capture::View v;
+        while(wf_&&cap_->acquire(v)) {
+            // Floats only if packing failed (an empty capture).
+            size_t n=Capture::pack(v, packed_.get(), packed_cap_);
+            jobject buf=n ? env->NewDirectByteBuffer(packed_.get(), jlong(n))
+                          : env->NewDirectByteBuffer(const_cast<void*>(v.data), jlong(v.bytes));
+            if(buf) {
+                env->CallVoidMethod(cb_, wf_, buf);
+                if(env->ExceptionCheck()) env->ExceptionClear();
+                env->DeleteLocalRef(buf);
+            }
+            cap_->release(v);
         }
-    );
-    LOGI("SeismicDetector v2 — adaptive trigger + periodicity rejection");
+        uint32_t d=dropped_ev_.exchange(0, std::memory_order_relaxed);
+        if(d) LOGW("Dispatcher queue full: %u events dropped", d);
+        if(cap_&&cap_->dropped()!=cap_dropped_){
+            LOGW("Waveform arena full: %u captures dropped", cap_->dropped()-cap_dropped_);
+            cap_dropped_=cap_->dropped();
+        }
+    }
+
+    JavaVM* jvm_; jobject cb_; jmethodID ev_, dbg_, wf_;
+    Capture* cap_; uint32_t cap_dropped_=0;
+    std::unique_ptr<uint8_t[]> packed_; size_t packed_cap_=0;    // C17, dispatcher thread
+    EventLog* log_;
+    sinyalist::seismic::LatencyTrace* trace_;
+    struct Pending { Event e; uint64_t trace; };
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint32_t> dropped_total_{0};
+    sinyalist::seismic::SpscQueue<Pending, 64> evq_;
+    sinyalist::seismic::SpscQueue<Telemetry, 256> dbgq_;
+    std::atomic<uint32_t> dropped_ev_{0};
+    std::atomic<bool> stop_{false};
+    sem_t wake_;
+    std::thread th_;
+};
+
+// C12: one detector per handle. An Instance owns its callback global ref,
+// dispatcher thread, detector and resampler, so instances share nothing but
+// the JavaVM and can be driven from different threads. Samples reach a
+// handle from one thread at a time; config, trigger and reset may come from
+// any thread and are applied by that one before its next batch. No call
+// after nativeDestroy(handle).
+using sinyalist::seismic::Config;
+using sinyalist::seismic::TelemetryRing;
+using sinyalist::seismic::config_from;
+using sinyalist::seismic::CFG_SAMPLE_RATE;
+using sinyalist::seismic::CFG_COUNT;
+
+// C19: detector events and telemetry go straight into the dispatcher
+// queues, inlined into process_sample(). C24: events are traced first
+// (event() is defined after Instance).
+struct Instance;
+struct DispatchSink {
+    static constexpr bool kTelemetry = true;
+    EventDispatcher* d;
+    Instance* in;
+    void event(const sinyalist::seismic::SeismicEvent& e) noexcept;
+    void debug(const sinyalist::seismic::DebugTelemetry& t) noexcept { d->post(t); }
+    bool wants_debug() const noexcept { return d->wants_debug(); }
+};
+#if SINYALIST_FIXED_POINT
+using Detector = sinyalist::seismic::BasicFixedSeismicDetector<DispatchSink>;   // C15
+#else
+using Detector = sinyalist::seismic::BasicSeismicDetector<DispatchSink>;
+#endif
+
+// C7: static lifetime — a Java ByteBuffer view may outlive nativeDestroy().
+// Instances claim a ring at create time so the detector's pointer never
+// changes while its sensor thread runs.
+constexpr int kTelemetryRings = 4;
+TelemetryRing g_tel[kTelemetryRings];
+std::atomic<bool> g_tel_used[kTelemetryRings];
+
+// C18: dart:ffi staging, touched only by the one Dart reader.
+struct FfiStaging {
+    uint64_t ev_next = 0, tel_next = 0;
+    bool tel_started = false;
+    uint8_t ev[EventLog::kCapacity*SINYALIST_FFI_EVENT_SIZE];
+    uint8_t tel[TelemetryRing::kCapacity*SINYALIST_FFI_TELEMETRY_SIZE];
+    float cfg[16];
+    sinyalist_stats stats;
+};
+
+struct Instance {
+    jobject cb = nullptr;
+    std::unique_ptr<EventDispatcher> disp;
+    std::unique_ptr<Detector> det;
+    sinyalist::seismic::Resampler res;       // C10
+    // C25: while set, the only caller of process_raw(); stopped before det goes
+    std::unique_ptr<sinyalist::seismic::NativeSensor> sensor;
+    int tel = -1;                            // g_tel slot, -1 = none
+    sinyalist::seismic::SnapshotFile snap;   // C14
+    uint64_t snap_ms = 0, last_ms = 0;       // last snapshot / last sample
+    sinyalist::seismic::WaveformCapture cap; // C16: outlives disp
+    uint32_t cap_seen = 0;                   // cap.published() at the last kick
+    EventLog log;                            // C18: outlives disp
+    // C18: config posted from other threads (Dart, method channel); the
+    // sensor thread applies it before its next batch.
+    std::mutex cfg_mx;
+    Config cfg_want;
+    std::atomic<bool> cfg_dirty{false};
+    std::atomic<bool> reset_pending{false};  // C12: nativeReset, same handoff
+    // C18: published by the sensor thread after every batch
+    std::atomic<uint64_t> st_samples{0}, st_gated{0}, st_wakes{0};
+    std::atomic<bool> st_asleep{false};
+    // C24: outlives disp. The sensor thread sets ingest_ns per batch and, for
+    // process_raw(), the sensor ns of the block the detector is in.
+    sinyalist::seismic::LatencyTrace trace;
+    uint64_t ingest_ns = 0, blk_first = 0;
+    const uint64_t* blk_ns = nullptr;
+    size_t blk_n = 0;
+    // C18: dart:ffi id and staging (ffi_acquire)
+    int64_t ffi_id = 0;
+    FfiStaging* ffi = nullptr;
+};
+inline Instance* from(jlong h) { return reinterpret_cast<Instance*>(h); }
+
+// C18: Dart holds an ffi id, not the Instance pointer. Ids are never reused,
+// and nativeDestroy() unlists its instance before tearing it down, so a call
+// on a dead id finds nothing and returns 0/null. Every sinyalist_ffi_* call
+// runs under g_live_mx, so none overlaps a teardown. Dart's typed-list views
+// may outlive the instance (C7), so freed stagings are pooled, not deleted.
+std::mutex g_live_mx;
+std::vector<Instance*> g_live;
+std::vector<FfiStaging*> g_ffi_free;
+int64_t g_ffi_next = 0;
+
+void ffi_acquire(Instance* in) {
+    std::lock_guard<std::mutex> g(g_live_mx);
+    if(g_ffi_free.empty()) in->ffi=new FfiStaging;
+    else { in->ffi=g_ffi_free.back(); g_ffi_free.pop_back(); *in->ffi=FfiStaging{}; }
+    in->ffi_id=++g_ffi_next;
+    g_live.push_back(in);
+}
+void ffi_release(Instance* in) {
+    std::lock_guard<std::mutex> g(g_live_mx);
+    g_live.erase(std::remove(g_live.begin(), g_live.end(), in), g_live.end());
+    g_ffi_free.push_back(in->ffi);
+    in->ffi=nullptr;
+}
+// Holds g_live_mx for the duration of one sinyalist_ffi_* call; in is null
+// if id names no live instance.
+struct FfiCall {
+    std::lock_guard<std::mutex> g{g_live_mx};
+    Instance* in=nullptr;
+    explicit FfiCall(int64_t id) {
+        for(Instance* i : g_live) if(i->ffi_id==id){ in=i; break; }
+    }
+};
+
+// C24: the firing sample is the last one the detector counted.
+inline void DispatchSink::event(const sinyalist::seismic::SeismicEvent& e) noexcept {
+    const uint64_t now=sinyalist::seismic::boottime_ns();
+    uint64_t sensor=0;
+    if(in->blk_ns){
+        uint64_t i=in->det->samples()-in->blk_first-1;
+        if(i<in->blk_n) sensor=in->blk_ns[i];
+    }
+    d->post(e, in->trace.begin(sensor, in->ingest_ns, now));
+}
+
+// C14: at most this much warm state is lost when the process dies.
+constexpr uint64_t kSnapshotPeriodMs = 10000;
+void save_snapshot(Instance* in, uint64_t ts) {
+    in->snap.write([&](void* dst, size_t cap) { return in->det->snapshot(dst, cap, ts); });
+    in->snap_ms = ts;
+}
+// C18: sensor thread, before every batch: posted config, then a posted reset.
+inline void apply_pending(Instance* in) {
+    if(in->cfg_dirty.load(std::memory_order_acquire)&&in->cfg_mx.try_lock()){
+        Config c=in->cfg_want;
+        in->cfg_dirty.store(false, std::memory_order_relaxed);
+        in->cfg_mx.unlock();
+        in->det->update_config(c);
+    }
+    if(in->reset_pending.load(std::memory_order_acquire)&&
+       in->reset_pending.exchange(false, std::memory_order_acq_rel)){
+        in->det->reset();
+        in->res.reset();
+    }
+}
+// C15: fixed-point builds run boxcar f32 windows only; a config asking for
+// recursive or compact windows is logged and run as that.
+Config supported(const Config& c) {
+#if SINYALIST_FIXED_POINT
+    Config r=sinyalist::seismic::FixedMath::supported(c);
+    if(r.window_mode!=c.window_mode||r.window_storage!=c.window_storage)
+        LOGW("Fixed-point build: window mode %u, storage %u unsupported, using boxcar f32",
+             unsigned(c.window_mode), unsigned(c.window_storage));
+    return r;
+#else
+    return c;
+#endif
+}
+void post_config(Instance* in, const Config& c) {
+    Config s=supported(c);
+    std::lock_guard<std::mutex> g(in->cfg_mx);
+    in->cfg_want=s;
+    in->cfg_dirty.store(true, std::memory_order_release);
 }
+// Called with the last timestamp and sample count of every batch (sensor thread).
+inline void after_batch(Instance* in, uint64_t ts, size_t n) {
+    in->last_ms = ts;
+    in->st_samples.fetch_add(n, std::memory_order_relaxed);
+    in->st_gated.store(in->det->gated_samples(), std::memory_order_relaxed);
+    in->st_wakes.store(in->det->wakes(), std::memory_order_relaxed);
+    in->st_asleep.store(in->det->asleep(), std::memory_order_relaxed);
+    if(in->cap.published()!=in->cap_seen){ in->cap_seen=in->cap.published(); in->disp->kick(); }
+    if(in->snap.is_open()&&ts-in->snap_ms>=kSnapshotPeriodMs) save_snapshot(in, ts);
+}
+// C18: counters as of the last batch, safe from any thread.
+void read_stats(Instance* in, sinyalist_stats& s) {
+    s={};
+    s.samples=in->st_samples.load(std::memory_order_relaxed);
+    s.gated_samples=in->st_gated.load(std::memory_order_relaxed);
+    s.wakes=in->st_wakes.load(std::memory_order_relaxed);
+    s.events=in->disp->delivered();
+    s.events_dropped=in->disp->dropped();
+    s.captures=in->cap.published();
+    s.captures_dropped=in->cap.dropped();
+    s.asleep=in->st_asleep.load(std::memory_order_relaxed);
+}
+// C10: native-rate samples (elapsedRealtimeNanos), resampled into the
+// detector in blocks of up to 64; offset_ms maps them to wall-clock ms.
+void process_raw(Instance* in, const float* p, const int64_t* t, size_t n, int64_t offset_ms) {
+    in->ingest_ns=sinyalist::seismic::boottime_ns();   // C24
+    apply_pending(in);
+    float bx[64*3]; uint64_t bt[64], bn[64], last=0; size_t m=0, total=0;
+    auto run=[&]{
+        in->blk_ns=bn; in->blk_n=m; in->blk_first=in->det->samples();   // C24
+        in->det->process_block(bx, bt, m);
+        m=0;
+    };
+    in->res.push_block(p, t, n, [&](float x, float y, float z, int64_t tn) {
+        bx[3*m]=x; bx[3*m+1]=y; bx[3*m+2]=z; bt[m]=last=uint64_t(tn/1000000+offset_ms);
+        bn[m]=uint64_t(tn);
+        ++total;
+        if(++m==64) run();
+    });
+    if(m) run();
+    in->blk_ns=nullptr;
+    if(last) after_batch(in, last, total);
+}
+// C25: System.currentTimeMillis() - SystemClock.elapsedRealtime(), natively.
+int64_t wall_offset_ms() {
+    timespec w, b;
+    clock_gettime(CLOCK_REALTIME, &w);
+    clock_gettime(CLOCK_BOOTTIME, &b);
+    return (int64_t(w.tv_sec)-int64_t(b.tv_sec))*1000 + (int64_t(w.tv_nsec)-int64_t(b.tv_nsec))/1000000;
+}
+bool restore_snapshot(JNIEnv* env, Instance* in, jstring path, jlong max_age_ms) {
+    const char* p = path ? env->GetStringUTFChars(path, nullptr) : nullptr;
+    if(!p) return false;
+    bool ok = in->snap.open(p, Detector::snapshot_capacity());
+    env->ReleaseStringUTFChars(path, p);
+    if(!ok){ LOGW("snapshot file unavailable or held by another engine"); return false; }
+    uint64_t now = uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    for(int i=0;i<2;++i){                    // newest, then the one before it
+        size_t n=0; const void* img=in->snap.latest(n, i);
+        if(img&&in->det->restore(img, n, now, uint64_t(std::max<jlong>(max_age_ms, 0)))) return true;
+    }
+    return false;
+}
+
+// C16: arena per instance — ~170 KB at 50 Hz, plus ~44 KB for the C17
+// packing buffer on the dispatcher. A trigger finding all slots
+// still unread by Kotlin is dropped, not queued.
+constexpr uint32_t kCaptureSlots = 4;
+constexpr float kCapturePreS = 10.0f, kCapturePostS = 60.0f;
+
+static_assert(CFG_COUNT<=sizeof(FfiStaging::cfg)/sizeof(float), "dart:ffi config staging too small");
+// C5: the resampler (C10) feeds the detector at the rate config_from()
+// snaps to, so an unsupported rate is logged and run at the nearest.
+Config config_from(JNIEnv* env, jfloatArray a) {
+    float v[CFG_COUNT]; jsize n = a ? std::min<jsize>(env->GetArrayLength(a), CFG_COUNT) : 0;
+    if(n>0) env->GetFloatArrayRegion(a, 0, n, v);
+    if(n>CFG_SAMPLE_RATE&&!Config::rate_supported(v[CFG_SAMPLE_RATE]))
+        LOGW("No filter design for %.1f Hz, detecting at %.0f Hz", v[CFG_SAMPLE_RATE],
+             Config::nearest_rate(v[CFG_SAMPLE_RATE]));
+    return config_from(v, n);
+}
+} // namespace
+
+extern "C" {
+// C14: snapshotPath (nullable) names this instance's snapshot file; a
+// snapshot at most maxSnapshotAgeMs old with a matching config is restored.
+JNIEXPORT jlong JNICALL Java_com_sinyalist_core_SeismicEngine_nativeCreate(
+        JNIEnv* env, jobject, jobject cb, jfloatArray config,
+        jstring snapshotPath, jlong maxSnapshotAgeMs) {
+    JavaVM* jvm=nullptr;
+    if(!cb||env->GetJavaVM(&jvm)!=JNI_OK) return 0;
+    jclass cls = env->GetObjectClass(cb);
+    jmethodID ev = env->GetMethodID(cls, "onSeismicEvent", "(IFFFJIJ)V");   // C24: + trace id
+    if(env->ExceptionCheck()){ env->ExceptionClear(); env->DeleteLocalRef(cls); return 0; }
+    // onDebugTelemetry is optional on the Kotlin side
+    jmethodID dbg = env->GetMethodID(cls, "onDebugTelemetry", "(FFFFFFFIIJ)V");
+    if(env->ExceptionCheck()){ env->ExceptionClear(); dbg=nullptr; }
+    // C16: so is onWaveform; without it no capture arena is allocated
+    jmethodID wf = env->GetMethodID(cls, "onWaveform", "(Ljava/nio/ByteBuffer;)V");
+    if(env->ExceptionCheck()){ env->ExceptionClear(); wf=nullptr; }
+    env->DeleteLocalRef(cls);
 
-JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeProcessSample(
-        JNIEnv*, jobject, jfloat ax, jfloat ay, jfloat az, jlong ts) {
-    if(g_det) g_det->process_sample(ax, ay, az, uint64_t(ts));
+    Config c = supported(config_from(env, config));
+    auto* in = new Instance;
+    in->cb = env->NewGlobalRef(cb);
+    if(wf) in->cap.configure(c.sample_rate_hz, kCaptureSlots,
+                             uint32_t(kCapturePreS*c.sample_rate_hz), uint32_t(kCapturePostS*c.sample_rate_hz));
+    in->disp = std::make_unique<EventDispatcher>(jvm, in->cb, ev, dbg, &in->cap, wf, &in->log, &in->trace);
+    in->cfg_want = c;
+    in->det = std::make_unique<Detector>(DispatchSink{in->disp.get(), in});
+    for(int i=0;i<kTelemetryRings;++i)
+        if(!g_tel_used[i].exchange(true)){ in->tel=i; in->det->set_telemetry_ring(&g_tel[i]); break; }
+    if(wf) in->det->set_capture(&in->cap);
+    in->det->update_config(c);
+    in->res.configure(c.sample_rate_hz);
+    bool warm = restore_snapshot(env, in, snapshotPath, maxSnapshotAgeMs);
+    LOGI("SeismicDetector %p — %.0f Hz, trigger %.2f, %s windows, %s start", (void*)in,
+         c.sample_rate_hz, c.sta_lta_trigger,
+         c.window_mode==sinyalist::seismic::WindowMode::RECURSIVE ? "recursive" : "boxcar",
+         warm ? "warm" : "cold");
+    ffi_acquire(in);
+    return reinterpret_cast<jlong>(in);
 }
-JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeReset(JNIEnv*, jobject) {
-    if(g_det) g_det->reset();
+
+// C1: xyz is a direct FloatBuffer of 3*n floats, ts a direct LongBuffer of n
+// timestamps (ms). Both must be allocated with allocateDirect() in native order.
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeProcessBatch(
+        JNIEnv* env, jobject, jlong h, jobject xyz, jobject ts, jint n) {
+    if(!h||n<=0) return;
+    auto* p=static_cast<const float*>(env->GetDirectBufferAddress(xyz));
+    auto* t=static_cast<const uint64_t*>(env->GetDirectBufferAddress(ts));
+    if(!p||!t) return;
+    if(env->GetDirectBufferCapacity(xyz)<jlong(n)*3||env->GetDirectBufferCapacity(ts)<n) return;
+    from(h)->ingest_ns=sinyalist::seismic::boottime_ns();   // C24
+    apply_pending(from(h));
+    from(h)->det->process_block(p, t, size_t(n));
+    after_batch(from(h), t[n-1], size_t(n));
+}
+// C10: like nativeProcessBatch but at the sensor's native rate: ts holds
+// elapsedRealtimeNanos timestamps, offsetMs maps them to wall-clock ms.
+// Resampled output reaches the detector in blocks of up to 64 samples.
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeProcessRaw(
+        JNIEnv* env, jobject, jlong h, jobject xyz, jobject ts, jint n, jlong offsetMs) {
+    if(!h||n<=0) return;
+    auto* p=static_cast<const float*>(env->GetDirectBufferAddress(xyz));
+    auto* t=static_cast<const int64_t*>(env->GetDirectBufferAddress(ts));
+    if(!p||!t) return;
+    if(env->GetDirectBufferCapacity(xyz)<jlong(n)*3||env->GetDirectBufferCapacity(ts)<n) return;
+    process_raw(from(h), p, t, size_t(n), offsetMs);
+}
+// C25: the library reads the sensor itself on a thread of its own (see
+// native_sensor.hpp); the Kotlin listener must be unregistered meanwhile.
+// cluster: -1 any core, else the index of a CPU cluster, slowest first.
+JNIEXPORT jboolean JNICALL Java_com_sinyalist_core_SeismicEngine_nativeStartSensor(
+        JNIEnv*, jobject, jlong h, jint type, jint samplingUs, jint maxLatencyUs,
+        jint nice, jint cluster, jboolean wakeUp) {
+    if(!h) return JNI_FALSE;
+    Instance* in=from(h);
+    if(in->sensor) return in->sensor->running() ? JNI_TRUE : JNI_FALSE;
+    sinyalist::seismic::NativeSensorConfig c;
+    c.type=type; c.sampling_us=samplingUs; c.max_latency_us=maxLatencyUs;
+    c.nice=nice; c.cluster=cluster; c.wake_up=wakeUp==JNI_TRUE;
+    // The sensor thread is the only sample thread while it runs; process_raw()
+    // picks up config and nativeReset() handoffs there, so neither touches the
+    // detector under it.
+    auto s=std::make_unique<sinyalist::seismic::NativeSensor>(c,
+        [in](const float* xyz, const int64_t* ts, size_t n) { process_raw(in, xyz, ts, n, wall_offset_ms()); });
+    if(!s->start()){
+        LOGW("Native sensor %d unavailable: %s", type, s->error());
+        return JNI_FALSE;
+    }
+    LOGI("Native sensor %d on %s thread: nice %d %s, cluster %d %s", type,
+         s->wake_up() ? "wake-up" : "non-wake-up", nice, s->prioritised() ? "set" : "refused",
+         cluster, cluster<0 ? "unpinned" : s->pinned() ? "pinned" : "not pinned");
+    in->sensor=std::move(s);
+    return JNI_TRUE;
+}
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeStopSensor(
+        JNIEnv*, jobject, jlong h) {
+    if(h) from(h)->sensor.reset();
+}
+// C7: returns this instance's shared telemetry ring and starts writing into
+// it; null if all rings are taken by other instances.
+JNIEXPORT jobject JNICALL Java_com_sinyalist_core_SeismicEngine_nativeAttachTelemetry(
+        JNIEnv* env, jobject, jlong h) {
+    if(!h||from(h)->tel<0) return nullptr;
+    TelemetryRing& r=g_tel[from(h)->tel];
+    r.set_enabled(true);
+    return env->NewDirectByteBuffer(&r, jlong(sizeof(r)));
 }
-JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeDestroy(JNIEnv* env, jobject) {
-    g_det.reset();
-    if(g_cb){env->DeleteGlobalRef(g_cb); g_cb=nullptr;}
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeDetachTelemetry(
+        JNIEnv*, jobject, jlong h) {
+    if(h&&from(h)->tel>=0) g_tel[from(h)->tel].set_enabled(false);
+}
+// Any thread: the sensor thread resets detector and resampler before its
+// next batch, so a reset never runs inside process_*().
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeReset(JNIEnv*, jobject, jlong h) {
+    if(h) from(h)->reset_pending.store(true, std::memory_order_release);
+}
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeDestroy(
+        JNIEnv* env, jobject, jlong h) {
+    if(!h) return;
+    Instance* in=from(h);
+    ffi_release(in);                        // C18: Dart's id is dead past this point
+    in->sensor.reset();                     // C25: no sample arrives past this point
+    if(in->snap.is_open()&&in->last_ms) save_snapshot(in, in->last_ms);   // C14: clean stop
+    in->log.set_listener(nullptr);          // C18: no Dart callback past this point
+    in->det.reset();
+    in->disp.reset();   // C6: joins the dispatcher after draining pending events
+    if(in->tel>=0){ g_tel[in->tel].set_enabled(false); g_tel_used[in->tel].store(false); }
+    env->DeleteGlobalRef(in->cb);
+    delete in;
 }
 JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeSetTrigger(
-        JNIEnv*, jobject, jfloat trig) {
-    if(g_det){auto c=g_det->config();c.sta_lta_trigger=trig;g_det->update_config(c);
-        LOGI("Trigger -> %.2f",trig);}
+        JNIEnv*, jobject, jlong h, jfloat trig) {
+    if(!h) return;
+    Instance* in=from(h);
+    {   // C18: the sensor thread applies it before its next batch
+        std::lock_guard<std::mutex> g(in->cfg_mx);
+        in->cfg_want.sta_lta_trigger=trig;
+        in->cfg_dirty.store(true, std::memory_order_release);
+    }
+    LOGI("SeismicDetector %p trigger -> %.2f", (void*)from(h), trig);
+}
+
+// C20: sinyalist_stats fields as longs (in order), then the stage profile
+// (StageProfile::export_words(), stage count 0 unless SINYALIST_PROFILE).
+// C24: then the latency trace (LatencyTrace::export_words()).
+constexpr size_t kStatsCounters = 8;
+JNIEXPORT jlongArray JNICALL Java_com_sinyalist_core_SeismicEngine_nativeGetStats(
+        JNIEnv* env, jobject, jlong h) {
+    if(!h) return nullptr;
+    Instance* in=from(h);
+    sinyalist_stats s; read_stats(in, s);
+    uint64_t w[kStatsCounters+sinyalist::seismic::kProfileWords+sinyalist::seismic::kLatencyWords] = {
+        s.samples, s.gated_samples, s.wakes, s.events,
+        s.events_dropped, s.captures, s.captures_dropped, s.asleep,
+    };
+    size_t n=kStatsCounters+in->det->profile().export_words(w+kStatsCounters);
+    n+=in->trace.export_words(w+n);
+    jlongArray a=env->NewLongArray(jsize(n));
+    if(a) env->SetLongArrayRegion(a, 0, jsize(n), reinterpret_cast<const jlong*>(w));
+    return a;
+}
+
+// C24: Kotlin handed event traceId to the EventChannel at uiNs
+// (elapsedRealtimeNanos). Main thread only.
+JNIEXPORT void JNICALL Java_com_sinyalist_core_SeismicEngine_nativeTraceDelivered(
+        JNIEnv*, jobject, jlong h, jlong traceId, jlong uiNs) {
+    if(h&&traceId>0&&uiNs>0)
+        from(h)->trace.mark(uint64_t(traceId), sinyalist::seismic::Mark::UI, uint64_t(uiNs));
+}
+
+// --- C18: dart:ffi (sinyalist_ffi.h) -------------------------------------
+// The id Dart passes to sinyalist_ffi_*; method channel "nativeHandle".
+JNIEXPORT jlong JNICALL Java_com_sinyalist_core_SeismicEngine_nativeFfiHandle(
+        JNIEnv*, jobject, jlong h) {
+    return h ? jlong(from(h)->ffi_id) : 0;
+}
+
+void sinyalist_ffi_set_listener(int64_t h, sinyalist_event_listener fn) {
+    FfiCall c(h);
+    if(c.in) c.in->log.set_listener(fn);
+}
+int32_t sinyalist_ffi_read_events(int64_t h) {
+    FfiCall c(h);
+    return c.in ? c.in->log.read(c.in->ffi->ev_next, c.in->ffi->ev) : 0;
+}
+const uint8_t* sinyalist_ffi_event_buffer(int64_t h) {
+    FfiCall c(h);
+    return c.in ? c.in->ffi->ev : nullptr;
+}
+// C24: the same UI mark as nativeTraceDelivered, from the Dart isolate.
+void sinyalist_ffi_trace_delivered(int64_t h, int64_t trace_id, int64_t now_ns) {
+    if(trace_id<=0) return;
+    FfiCall c(h);
+    if(c.in) c.in->trace.mark(uint64_t(trace_id), sinyalist::seismic::Mark::UI,
+                              now_ns>0 ? uint64_t(now_ns) : sinyalist::seismic::boottime_ns());
+}
+
+int32_t sinyalist_ffi_read_telemetry(int64_t h) {
+    FfiCall c(h);
+    if(!c.in||c.in->tel<0) return 0;
+    FfiStaging& f=*c.in->ffi;
+    TelemetryRing& r=g_tel[c.in->tel];
+    uint64_t w=r.hdr.write_seq.load(std::memory_order_acquire);
+    if(!f.tel_started){ r.set_enabled(true); f.tel_started=true; f.tel_next=w; }
+    uint64_t q=std::max(f.tel_next, w>TelemetryRing::kCapacity ? w-TelemetryRing::kCapacity : 0);
+    int32_t n=0;
+    for(; q<w; ++q) {
+        const TelemetryRing::Record& rec=r.rec[q%TelemetryRing::kCapacity];
+        if(rec.seq.load(std::memory_order_acquire)!=q+1) continue;
+        uint8_t* o=f.tel+size_t(n)*SINYALIST_FFI_TELEMETRY_SIZE;
+        std::memcpy(o, reinterpret_cast<const uint8_t*>(&rec)+8, SINYALIST_FFI_TELEMETRY_SIZE);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(rec.seq.load(std::memory_order_relaxed)==q+1) ++n;
+    }
+    f.tel_next=w;
+    return n;
+}
+const uint8_t* sinyalist_ffi_telemetry_buffer(int64_t h) {
+    FfiCall c(h);
+    return c.in ? c.in->ffi->tel : nullptr;
+}
+
+float* sinyalist_ffi_config_buffer(int64_t h) {
+    FfiCall c(h);
+    return c.in ? c.in->ffi->cfg : nullptr;
+}
+int32_t sinyalist_ffi_config_capacity(void) { return CFG_COUNT; }
+void sinyalist_ffi_commit_config(int64_t h, int32_t n) {
+    FfiCall c(h);
+    if(!c.in) return;
+    float* v=c.in->ffi->cfg;
+    n=std::clamp<int32_t>(n, 1, CFG_COUNT);
+    {   // the windows and resampler were sized for the creation rate
+        std::lock_guard<std::mutex> g(c.in->cfg_mx);
+        v[CFG_SAMPLE_RATE]=c.in->cfg_want.sample_rate_hz;
+    }
+    post_config(c.in, config_from(v, n));
+}
+
+const sinyalist_stats* sinyalist_ffi_stats(int64_t h) {
+    FfiCall c(h);
+    if(!c.in) return nullptr;
+    read_stats(c.in, c.in->ffi->stats);
+    return &c.in->ffi->stats;
+}
+
+// --- C23: trigger coincidence (mesh layer, TriggerCoincidence.kt) -----------
+// The Kotlin side serialises calls; radiusKm <= 0 / capacity 0 = defaults.
+JNIEXPORT jlong JNICALL Java_com_sinyalist_mesh_TriggerCoincidence_nativeCreate(
+        JNIEnv*, jobject, jfloat radiusKm, jint capacity) {
+    sinyalist::seismic::CoincidenceConfig c;
+    if(radiusKm>0) c.radius_km=radiusKm;
+    if(capacity>0) c.capacity=uint32_t(capacity);
+    return reinterpret_cast<jlong>(new sinyalist::seismic::CoincidenceIndex(c));
+}
+// out (4 longs): devices, cluster, firstMs, repeat. Returns the cluster
+// confidence, or -1 if the report was not usable.
+JNIEXPORT jfloat JNICALL Java_com_sinyalist_mesh_TriggerCoincidence_nativeInsert(
+        JNIEnv* env, jobject, jlong h, jint latE7, jint lonE7, jlong timeMs, jlong device,
+        jlongArray out) {
+    if(!h||timeMs<0||!out||env->GetArrayLength(out)<4) return -1.f;
+    auto r=reinterpret_cast<sinyalist::seismic::CoincidenceIndex*>(h)->insert(
+        latE7, lonE7, uint64_t(timeMs), uint64_t(device));
+    if(!r.devices) return -1.f;
+    const jlong w[4]={jlong(r.devices), jlong(r.cluster), jlong(r.first_ms), r.repeat ? 1 : 0};
+    env->SetLongArrayRegion(out, 0, 4, w);
+    return r.confidence;
+}
+JNIEXPORT void JNICALL Java_com_sinyalist_mesh_TriggerCoincidence_nativeReset(
+        JNIEnv*, jobject, jlong h) {
+    if(h) reinterpret_cast<sinyalist::seismic::CoincidenceIndex*>(h)->reset();
+}
+JNIEXPORT void JNICALL Java_com_sinyalist_mesh_TriggerCoincidence_nativeDestroy(
+        JNIEnv*, jobject, jlong h) {
+    delete reinterpret_cast<sinyalist::seismic::CoincidenceIndex*>(h);
 }
 } // extern "C"
 #endif
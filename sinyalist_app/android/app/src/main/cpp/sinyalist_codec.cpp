@@ -0,0 +1,67 @@
+// =============================================================================
+// SINYALIST — Waveform codec C ABI (see sinyalist_codec.h)
+// =============================================================================
+
+#include "sinyalist_codec.h"
+#include "steim2.hpp"
+#include <memory>
+#include <new>
+
+using namespace sinyalist::seismic;
+
+struct sinyalist_steim2_stream { Steim2Encoder enc; bool ok; };
+
+extern "C" {
+
+size_t sinyalist_steim2_max_bytes(size_t n) { return steim2_max_bytes(n); }
+
+size_t sinyalist_steim2_encode(const int32_t* in, size_t n, uint8_t* out, size_t cap) {
+    if (!in || !out) return 0;
+    Steim2Encoder enc(out, cap);
+    for (size_t i = 0; i < n; ++i) if (!enc.push(in[i])) return 0;
+    return enc.finish();
+}
+
+size_t sinyalist_steim2_decode(const uint8_t* in, size_t bytes, int32_t* out, size_t n) {
+    return in && out ? steim2_decode(in, bytes, out, n) : 0;
+}
+
+sinyalist_steim2_stream* sinyalist_steim2_stream_new(uint8_t* out, size_t cap) {
+    if (!out) return nullptr;
+    return new (std::nothrow) sinyalist_steim2_stream{Steim2Encoder(out, cap), true};
+}
+
+int sinyalist_steim2_stream_push(sinyalist_steim2_stream* s, const int32_t* in, size_t n) {
+    if (!s || !in) return 0;
+    for (size_t i = 0; i < n && s->ok; ++i) s->ok = s->enc.push(in[i]);
+    return s->ok ? 1 : 0;
+}
+
+size_t sinyalist_steim2_stream_finish(sinyalist_steim2_stream* s) {
+    if (!s) return 0;
+    size_t b = s->ok ? s->enc.finish() : 0;
+    delete s;
+    return b;
+}
+
+size_t sinyalist_waveform_pack(const float* xyz, size_t n, float counts_per_g,
+                               uint8_t* out, size_t cap) {
+    if (!xyz || !out) return 0;
+    return pack_waveform(xyz, n, counts_per_g > 0 ? counts_per_g : kCountsPerG, out, cap);
+}
+
+size_t sinyalist_waveform_samples(const uint8_t* in, size_t bytes) {
+    PackedWaveformHeader h;
+    if (!in || bytes < sizeof(h)) return 0;
+    std::memcpy(&h, in, sizeof(h));
+    return h.magic == PackedWaveformHeader::kMagic ? h.samples : 0;
+}
+
+size_t sinyalist_waveform_unpack(const uint8_t* in, size_t bytes, float* xyz, size_t max_n) {
+    size_t n = sinyalist_waveform_samples(in, bytes);
+    if (!n || n > max_n || !xyz) return 0;
+    std::unique_ptr<int32_t[]> scratch(new (std::nothrow) int32_t[n]);
+    return scratch ? unpack_waveform(in, bytes, xyz, max_n, scratch.get()) : 0;
+}
+
+} // extern "C"
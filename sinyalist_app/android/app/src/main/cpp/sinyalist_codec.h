@@ -0,0 +1,49 @@
+/* =============================================================================
+ * SINYALIST — Waveform codec C ABI (libsinyalist_seismic.so / libsinyalist_codec.a)
+ * =============================================================================
+ * Plain C over steim2.hpp so the Rust backend and other non-C++ callers can
+ * decode what the phone encodes. All calls are thread-safe on distinct
+ * buffers/streams; only sinyalist_steim2_stream_new() and
+ * sinyalist_waveform_unpack() (decode scratch) allocate.
+ * Sizes are in bytes unless named n (samples). 0 means failure throughout.
+ * ========================================================================== */
+#ifndef SINYALIST_CODEC_H
+#define SINYALIST_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Worst-case Steim-2 stream size for n samples. */
+size_t sinyalist_steim2_max_bytes(size_t n);
+
+/* Block encode n samples; returns the stream size (whole 64-byte frames). */
+size_t sinyalist_steim2_encode(const int32_t* in, size_t n, uint8_t* out, size_t cap);
+
+/* Block decode exactly n samples; returns n, or 0 on a damaged stream. */
+size_t sinyalist_steim2_decode(const uint8_t* in, size_t bytes, int32_t* out, size_t n);
+
+/* Streaming encode into out[cap], which must outlive the stream. push
+ * returns 0 once the buffer is full; finish returns the stream size and
+ * frees the stream. */
+typedef struct sinyalist_steim2_stream sinyalist_steim2_stream;
+sinyalist_steim2_stream* sinyalist_steim2_stream_new(uint8_t* out, size_t cap);
+int sinyalist_steim2_stream_push(sinyalist_steim2_stream* s, const int32_t* in, size_t n);
+size_t sinyalist_steim2_stream_finish(sinyalist_steim2_stream* s);
+
+/* Three-axis waveform image (header + x/y/z streams, see steim2.hpp).
+ * counts_per_g <= 0 selects the default 2048. */
+size_t sinyalist_waveform_pack(const float* xyz, size_t n, float counts_per_g,
+                               uint8_t* out, size_t cap);
+/* Samples in an image without decoding it; 0 if it is not one. */
+size_t sinyalist_waveform_samples(const uint8_t* in, size_t bytes);
+/* Decodes into xyz[3*max_n]; returns the sample count. */
+size_t sinyalist_waveform_unpack(const uint8_t* in, size_t bytes, float* xyz, size_t max_n);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SINYALIST_CODEC_H */
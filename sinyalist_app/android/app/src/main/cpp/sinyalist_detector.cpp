@@ -0,0 +1,238 @@
+// =============================================================================
+// SINYALIST — Detector core C ABI (see sinyalist_detector.h)
+// =============================================================================
+
+#include "sinyalist_detector.h"
+#include "seismic_detector.hpp"
+#include "coincidence_index.hpp"
+#include "fixed_detector.hpp"
+#include "resampler.hpp"
+#include "steim2.hpp"
+#include <new>
+#include <optional>
+#include <vector>
+
+using namespace sinyalist::seismic;
+
+static_assert(SINYALIST_DETECTOR_STATS_WORDS == 8 + kProfileWords, "stats layout");
+static_assert(sizeof(sinyalist_event) == 32, "event record layout");
+static_assert(sizeof(sinyalist_cluster) == 24, "cluster record layout");
+
+namespace {
+// C19: one indirect call per event, nothing per sample; no telemetry path.
+struct CallbackSink {
+    static constexpr bool kTelemetry = false;
+    sinyalist_event_fn fn = nullptr;
+    void* ctx = nullptr;
+    uint64_t events = 0;
+    void event(const SeismicEvent& e) noexcept {
+        ++events;
+        if(!fn) return;
+        sinyalist_event r{};
+        r.time_ms = int64_t(e.time_ms); r.peak_g = e.peak_g; r.sta_lta = e.sta_lta;
+        r.freq_hz = e.freq_hz; r.duration = e.duration; r.level = uint8_t(e.level);
+        fn(ctx, &r);
+    }
+    void debug(const DebugTelemetry&) noexcept {}
+    bool wants_debug() const noexcept { return false; }
+};
+
+// C22: verification records, counted past cap so the caller can size a re-run.
+struct Records {
+    sinyalist_event* out; size_t cap, n = 0;
+    void add(const sinyalist_event& r) noexcept { if(n < cap) out[n] = r; ++n; }
+};
+struct VerifySink {
+    static constexpr bool kTelemetry = false;
+    Records* rec = nullptr;
+    void event(const SeismicEvent& e) noexcept {
+        sinyalist_event r{};
+        r.time_ms = int64_t(e.time_ms); r.peak_g = e.peak_g; r.sta_lta = e.sta_lta;
+        r.freq_hz = e.freq_hz; r.duration = e.duration; r.level = uint8_t(e.level);
+        rec->add(r);
+    }
+    void debug(const DebugTelemetry&) noexcept {}
+    bool wants_debug() const noexcept { return false; }
+};
+
+// One cold run; the detector is rebuilt in place so its storage is reused.
+template<class D>
+void verify_run(std::optional<D>& d, const Config& c, const float* xyz, size_t n,
+                uint64_t t0_ms, Records& rec) {
+    d.emplace(VerifySink{&rec});
+    d->update_config(c);
+    size_t m = std::min<size_t>(n, size_t(c.sample_rate_hz));
+    float g[3] = {};
+    for(size_t i = 0; i < m; ++i) for(int a = 0; a < 3; ++a) g[a] += xyz[3*i + a];
+    d->seed_gravity(g[0]/float(m), g[1]/float(m), g[2]/float(m));
+    const double dt_ms = 1000.0 / double(c.sample_rate_hz);
+    uint32_t rejects = d->trigger().rejects;
+    for(size_t i = 0; i < n; ++i, xyz += 3) {
+        d->process_sample(xyz[0], xyz[1], xyz[2], t0_ms + uint64_t(double(i)*dt_ms + 0.5));
+        const TriggerState& t = d->trigger();
+        if(t.rejects == rejects) continue;
+        rejects = t.rejects;
+        sinyalist_event r{};
+        r.time_ms = int64_t(t.t0); r.peak_g = t.pk; r.freq_hz = t.fq;
+        r.duration = t.sc; r.reject = uint8_t(t.lr);
+        rec.add(r);
+    }
+}
+#if SINYALIST_FIXED_POINT
+using Detector = BasicFixedSeismicDetector<CallbackSink>;   // C15
+#else
+using Detector = BasicSeismicDetector<CallbackSink>;
+#endif
+
+// C5: process() and the verifiers take samples at the configured rate, so
+// a rate without a filter design cannot be snapped to another; refused.
+bool rate_ok(const float* config, int32_t n) noexcept {
+    return !config || n <= CFG_SAMPLE_RATE || Config::rate_supported(config[CFG_SAMPLE_RATE]);
+}
+} // namespace
+
+struct sinyalist_verifier {
+    Config cfg;
+    bool fixed;
+    std::optional<BasicSeismicDetector<VerifySink>> det;
+    std::optional<BasicFixedSeismicDetector<VerifySink>> det_q;
+    std::vector<float> xyz;           // verify_waveform() decode
+    std::vector<int32_t> scratch;
+};
+
+struct sinyalist_coincidence {
+    CoincidenceIndex index;
+};
+
+struct sinyalist_detector {
+    Detector det;
+    Resampler res;                           // C10, process_raw() only
+    uint64_t samples = 0;
+    sinyalist_detector(const Config& c, CallbackSink s) : det(s), res(c.sample_rate_hz) {
+        det.update_config(c);
+    }
+};
+
+extern "C" {
+
+sinyalist_detector* sinyalist_detector_new(const float* config, int32_t n,
+                                           sinyalist_event_fn fn, void* ctx) {
+    if(!rate_ok(config, n)) return nullptr;
+    Config c = config_from(config, config ? std::max<int32_t>(n, 0) : 0);
+    return new (std::nothrow) sinyalist_detector(c, CallbackSink{fn, ctx});
+}
+
+void sinyalist_detector_free(sinyalist_detector* d) { delete d; }
+
+int32_t sinyalist_detector_config_count(void) { return CFG_COUNT; }
+
+void sinyalist_detector_set_config(sinyalist_detector* d, const float* config, int32_t n) {
+    if(!d || !config || n <= 0) return;
+    float v[CFG_COUNT];
+    n = std::min<int32_t>(n, CFG_COUNT);
+    std::copy(config, config + n, v);
+    v[CFG_SAMPLE_RATE] = d->det.config().sample_rate_hz;   // windows were sized for it
+    d->det.update_config(config_from(v, n));
+}
+
+void sinyalist_detector_process(sinyalist_detector* d, const float* xyz,
+                                const uint64_t* ts_ms, size_t n) {
+    if(!d || !xyz || !ts_ms || !n) return;
+    d->det.process_block(xyz, ts_ms, n);
+    d->samples += n;
+}
+
+size_t sinyalist_detector_process_raw(sinyalist_detector* d, const float* xyz,
+                                      const int64_t* ts_ns, size_t n, int64_t offset_ms) {
+    if(!d || !xyz || !ts_ns || !n) return 0;
+    float bx[64*3]; uint64_t bt[64]; size_t m = 0, total = 0;
+    d->res.push_block(xyz, ts_ns, n, [&](float x, float y, float z, int64_t tn) {
+        bx[3*m] = x; bx[3*m+1] = y; bx[3*m+2] = z; bt[m] = uint64_t(tn/1000000 + offset_ms);
+        ++total;
+        if(++m == 64){ d->det.process_block(bx, bt, m); m = 0; }
+    });
+    if(m) d->det.process_block(bx, bt, m);
+    d->samples += total;
+    return total;
+}
+
+void sinyalist_detector_reset(sinyalist_detector* d) {
+    if(!d) return;
+    d->det.reset();
+    d->res.reset();
+}
+
+size_t sinyalist_detector_stats(const sinyalist_detector* d, uint64_t* out, size_t cap) {
+    if(!d || !out || cap < 8) return 0;
+    const uint64_t c[8] = {
+        d->samples, d->det.gated_samples(), d->det.wakes(),
+        d->det.sink().events, 0, 0, 0, d->det.asleep(),   // 4-6 reserved
+    };
+    std::copy(c, c + 8, out);
+    if(cap < SINYALIST_DETECTOR_STATS_WORDS) return 8;
+    return 8 + d->det.profile().export_words(out + 8);
+}
+
+// --- C22: verification ----------------------------------------------------
+sinyalist_verifier* sinyalist_verifier_new(const float* config, int32_t n, int32_t fixed_point) {
+    if(!rate_ok(config, n)) return nullptr;
+    auto* v = new (std::nothrow) sinyalist_verifier;
+    if(!v) return nullptr;
+    v->cfg = config_from(config, config ? std::max<int32_t>(n, 0) : 0);
+    v->cfg.pregate = false;
+    v->fixed = fixed_point != 0;
+    return v;
+}
+
+void sinyalist_verifier_free(sinyalist_verifier* v) { delete v; }
+
+int32_t sinyalist_verify(sinyalist_verifier* v, const float* xyz, size_t n, uint64_t t0_ms,
+                         sinyalist_event* out, size_t cap) {
+    if(!v || !xyz || !n || (!out && cap)) return -1;
+    Records rec{out, cap};
+    if(v->fixed) verify_run(v->det_q, v->cfg, xyz, n, t0_ms, rec);
+    else verify_run(v->det, v->cfg, xyz, n, t0_ms, rec);
+    return int32_t(std::min<size_t>(rec.n, INT32_MAX));
+}
+
+int32_t sinyalist_verify_waveform(sinyalist_verifier* v, const uint8_t* image, size_t bytes,
+                                  uint64_t t0_ms, sinyalist_event* out, size_t cap) {
+    PackedWaveformHeader h;
+    if(!v || !image || bytes < sizeof(h)) return -1;
+    std::memcpy(&h, image, sizeof(h));
+    if(h.magic != PackedWaveformHeader::kMagic || !h.samples) return -1;
+    // Untrusted input: a Steim-2 frame holds at most 15 words × 7 samples, so
+    // a header claiming more than the three streams can hold is rejected
+    // before anything is allocated for it.
+    if(uint64_t(h.samples)*3*kSteimFrame > uint64_t(bytes)*105) return -1;
+    v->xyz.resize(size_t(h.samples)*3);
+    v->scratch.resize(h.samples);
+    size_t n = unpack_waveform(image, bytes, v->xyz.data(), h.samples, v->scratch.data());
+    return n ? sinyalist_verify(v, v->xyz.data(), n, t0_ms, out, cap) : -1;
+}
+
+// --- C23: trigger coincidence ---------------------------------------------
+sinyalist_coincidence* sinyalist_coincidence_new(float radius_km, uint32_t capacity) {
+    CoincidenceConfig c;
+    if(radius_km > 0) c.radius_km = radius_km;
+    if(capacity) c.capacity = capacity;
+    return new (std::nothrow) sinyalist_coincidence{CoincidenceIndex(c)};
+}
+
+void sinyalist_coincidence_free(sinyalist_coincidence* c) { delete c; }
+
+uint32_t sinyalist_coincidence_insert(sinyalist_coincidence* c, int32_t lat_e7, int32_t lon_e7,
+                                      int64_t t_ms, uint64_t device, sinyalist_cluster* out) {
+    if(!c || t_ms < 0) return 0;
+    Coincidence r = c->index.insert(lat_e7, lon_e7, uint64_t(t_ms), device);
+    if(out) {
+        *out = sinyalist_cluster{};
+        out->devices = r.devices; out->cluster = r.cluster; out->confidence = r.confidence;
+        out->repeat = r.repeat; out->first_ms = int64_t(r.first_ms);
+    }
+    return r.devices;
+}
+
+void sinyalist_coincidence_reset(sinyalist_coincidence* c) { if(c) c->index.reset(); }
+
+} // extern "C"
@@ -0,0 +1,144 @@
+/* =============================================================================
+ * SINYALIST — Detector core C ABI (libsinyalist_core.a / SinyalistCore.xcframework)
+ * =============================================================================
+ * C21: the same detector the Android .so runs, without JNI, for iOS (Swift
+ * through the bridging header) and other embedders. C22 adds verifiers for
+ * the backend and C23 a trigger coincidence index (below). A detector is driven by
+ * one thread at a time; the event callback runs on that thread, inside the
+ * process call that confirmed or ended the event, and must not call back
+ * into the same detector.
+ *
+ * Config is a float array in SeismicConfig.kt order (sample rate, trigger,
+ * detrigger, min amplitude, coherence, periodicity, adaptive min/max,
+ * P-wave band min/max, window mode, pre-gate, window storage); missing
+ * trailing entries keep the defaults for the given rate. The sample rate
+ * must be 50, 100 or 200 Hz (the rates with a filter design); other sensor
+ * rates go through process_raw() at one of them.
+ * ========================================================================== */
+#ifndef SINYALIST_DETECTOR_H
+#define SINYALIST_DETECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Same fields and layout as the 32-byte dart:ffi event record. reject is
+ * only set in verifier rejection records (RejectCode 1 axis coherence,
+ * 2 frequency, 3 periodicity, 4 energy distribution); detector events
+ * always carry 0. */
+typedef struct {
+    int64_t time_ms;
+    float peak_g, sta_lta, freq_hz;
+    uint32_t duration;          /* detector-rate samples */
+    uint8_t level;              /* AlertLevel 0..4 */
+    uint8_t reject, pad[6];
+} sinyalist_event;
+
+typedef void (*sinyalist_event_fn)(void* ctx, const sinyalist_event* e);
+
+/* Stats words (u64), in nativeGetStats order so one parser reads both:
+ *   0 samples        detector-rate samples processed
+ *   1 gated_samples  C9: consumed by the pre-gate alone
+ *   2 wakes          pre-gate wake-ups
+ *   3 events         events the detector fired
+ *   4-6              reserved, 0: events_dropped, captures, captures_dropped
+ *                    on Android, where a dispatcher queue and a waveform
+ *                    capture exist; this library has neither
+ *   7 asleep         1 while the pre-gate holds the pipeline off
+ * then the stage profile as in nativeGetStats (stage count 0 unless built
+ * with SINYALIST_PROFILE). */
+#define SINYALIST_DETECTOR_STATS_WORDS 227   /* 8 + 3 + 8 stages × (3 + 24) */
+
+typedef struct sinyalist_detector sinyalist_detector;
+
+/* NULL on allocation failure or an unsupported sample rate. fn may be NULL
+ * (events are still counted). */
+sinyalist_detector* sinyalist_detector_new(const float* config, int32_t n,
+                                           sinyalist_event_fn fn, void* ctx);
+void sinyalist_detector_free(sinyalist_detector* d);
+
+/* Entries in the config array this build understands. */
+int32_t sinyalist_detector_config_count(void);
+/* Applied at once, incrementally (C13); the sample rate stays the one the
+ * detector was created with. */
+void sinyalist_detector_set_config(sinyalist_detector* d, const float* config, int32_t n);
+
+/* n samples already at the configured rate: xyz interleaved in g, ts_ms
+ * wall-clock milliseconds. */
+void sinyalist_detector_process(sinyalist_detector* d, const float* xyz,
+                                const uint64_t* ts_ms, size_t n);
+/* n samples at the sensor's own rate: ts_ns monotonic nanoseconds,
+ * offset_ms maps them to wall-clock ms. They are resampled to the configured
+ * rate first (C10); returns the detector-rate samples produced. */
+size_t sinyalist_detector_process_raw(sinyalist_detector* d, const float* xyz,
+                                      const int64_t* ts_ns, size_t n, int64_t offset_ms);
+
+void sinyalist_detector_reset(sinyalist_detector* d);
+
+/* Writes up to cap stats words (layout above); returns the count, 0 if cap
+ * is too small for the 8 counters. */
+size_t sinyalist_detector_stats(const sinyalist_detector* d, uint64_t* out, size_t cap);
+
+/* --- C22: waveform verification (backend) ---------------------------------
+ * A verifier re-runs a reported waveform through a fresh detector with the
+ * phone's math and returns what it decided. Verifiers share no state, so
+ * each worker thread can own one; a single verifier is not thread-safe.
+ * Every run starts cold like a new detector, gravity seeded from the mean of
+ * the first second and the pre-gate off, so a trigger needs a full LTA
+ * window (10 s by default) of samples before it.
+ *
+ * Records come in stream order: an event at the trigger and another at the
+ * detrigger (level > 0, reject 0), or a rejected candidate (level 0,
+ * reject > 0; time_ms its onset, peak_g / freq_hz / duration up to the
+ * rejection, sta_lta 0). */
+typedef struct sinyalist_verifier sinyalist_verifier;
+
+/* fixed_point = 1 runs the armeabi-v7a integer core (C15), 0 the float one.
+ * NULL on allocation failure or an unsupported sample rate. */
+sinyalist_verifier* sinyalist_verifier_new(const float* config, int32_t n, int32_t fixed_point);
+void sinyalist_verifier_free(sinyalist_verifier* v);
+
+/* n samples (xyz interleaved, g) at the configured rate, the first at t0_ms.
+ * Writes up to cap records; returns the total found (may exceed cap, re-run
+ * with more room), or -1 if the input is invalid. */
+int32_t sinyalist_verify(sinyalist_verifier* v, const float* xyz, size_t n, uint64_t t0_ms,
+                         sinyalist_event* out, size_t cap);
+/* The same over a packed waveform image (sinyalist_waveform_pack), decoded
+ * into storage the verifier keeps between calls. -1 for a damaged image. */
+int32_t sinyalist_verify_waveform(sinyalist_verifier* v, const uint8_t* image, size_t bytes,
+                                  uint64_t t0_ms, sinyalist_event* out, size_t cap);
+
+/* --- C23: trigger coincidence (mesh, backend) -----------------------------
+ * Clusters triggers reported by many devices (coincidence_index.hpp): a
+ * trigger is supported by triggers from other devices within radius_km
+ * whose arrival gap one P-wave front allows (6 km/s, 1.5 s clock slack).
+ * Each insert returns the cluster as it stands, kept incrementally; the last
+ * `capacity` triggers are remembered. Not thread-safe. */
+typedef struct {
+    uint32_t devices;           /* consistent neighbourhood, this trigger included */
+    uint32_t cluster;           /* largest neighbourhood it belongs to */
+    float confidence;           /* of cluster, backend GeoCluster scale */
+    uint8_t repeat, pad[3];     /* 1: device already reported, not counted again */
+    int64_t first_ms;           /* earliest consistent arrival */
+} sinyalist_cluster;
+
+typedef struct sinyalist_coincidence sinyalist_coincidence;
+
+/* radius_km <= 0 and capacity 0 select the defaults (20 km, 16384).
+ * NULL on allocation failure. */
+sinyalist_coincidence* sinyalist_coincidence_new(float radius_km, uint32_t capacity);
+void sinyalist_coincidence_free(sinyalist_coincidence* c);
+
+/* device is any stable per-device id (public key hash, user id). Returns
+ * out->devices, or 0 for coordinates outside ±90 / ±180 degrees. */
+uint32_t sinyalist_coincidence_insert(sinyalist_coincidence* c, int32_t lat_e7, int32_t lon_e7,
+                                      int64_t t_ms, uint64_t device, sinyalist_cluster* out);
+void sinyalist_coincidence_reset(sinyalist_coincidence* c);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SINYALIST_DETECTOR_H */
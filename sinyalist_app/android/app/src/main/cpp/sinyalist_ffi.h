@@ -0,0 +1,81 @@
+/* =============================================================================
+ * SINYALIST — Detector C ABI for dart:ffi (libsinyalist_seismic.so)
+ * =============================================================================
+ * C18: Dart reaches a running detector directly instead of through JNI →
+ * Kotlin map → main looper → EventChannel. The handle is an id for the
+ * detector Kotlin's SeismicEngine created (method channel "nativeHandle").
+ * Ids are never reused. SeismicEngine.destroy() first tells Dart (method
+ * "nativeHandleClosing"), then retires the id: from then on every call
+ * returns 0 / NULL and changes nothing, so a stale handle is harmless.
+ *
+ * Nothing here allocates on the Dart side: reads copy into per-instance
+ * staging buffers that Dart views once as typed lists, and each instance
+ * keeps its one Dart reader's cursor. The buffers stay mapped after the
+ * detector is destroyed; they are recycled for later detectors.
+ *
+ *   event record (32 B, little-endian): time_ms i64 | peak_g f32 |
+ *       sta_lta f32 | freq_hz f32 | duration u32 | level u8 | pad[3] |
+ *       trace u32 (C24 trace id, low 32 bits; 0 = untraced)
+ *   telemetry record (40 B): as SeismicTelemetryReader.drain() in Kotlin
+ * ========================================================================== */
+#ifndef SINYALIST_FFI_H
+#define SINYALIST_FFI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SINYALIST_FFI_EVENT_SIZE 32
+#define SINYALIST_FFI_TELEMETRY_SIZE 40
+
+typedef struct {
+    uint64_t samples;          /* detector-rate samples processed */
+    uint64_t gated_samples;    /* C9: consumed by the pre-gate alone */
+    uint64_t wakes;
+    uint64_t events;           /* delivered by the dispatcher */
+    uint32_t events_dropped;   /* dispatcher queue overflow */
+    uint32_t captures;         /* C16: waveforms published */
+    uint32_t captures_dropped;
+    uint8_t asleep, pad[3];
+} sinyalist_stats;
+
+/* Called on the native dispatcher thread with the newest event sequence
+ * number as soon as an event is logged — a NativeCallable.listener posts it
+ * to the Dart isolate's port. NULL removes it; returns once no call is in
+ * flight. */
+typedef void (*sinyalist_event_listener)(int64_t seq);
+void sinyalist_ffi_set_listener(int64_t handle, sinyalist_event_listener fn);
+
+/* Events logged since the previous call (at most the 16 newest) into the
+ * staging buffer, oldest first. Returns the count. */
+int32_t sinyalist_ffi_read_events(int64_t handle);
+const uint8_t* sinyalist_ffi_event_buffer(int64_t handle);
+
+/* C24: Dart handed the event with this trace id to its listeners at now_ns
+ * (CLOCK_BOOTTIME; <= 0 reads the clock here). Records the UI hop that the
+ * EventChannel path marks from Kotlin; call it from one thread only. */
+void sinyalist_ffi_trace_delivered(int64_t handle, int64_t trace_id, int64_t now_ns);
+
+/* New shared-ring telemetry records since the previous call (enables the
+ * ring on first use). Returns the count; lost ones are skipped. */
+int32_t sinyalist_ffi_read_telemetry(int64_t handle);
+const uint8_t* sinyalist_ffi_telemetry_buffer(int64_t handle);
+
+/* Dart writes up to n config floats (SeismicConfig.kt order) into the
+ * staging buffer, then commits; the sensor thread applies them before its
+ * next batch. The sample rate stays the one the instance was created with. */
+float* sinyalist_ffi_config_buffer(int64_t handle);
+int32_t sinyalist_ffi_config_capacity(void);
+void sinyalist_ffi_commit_config(int64_t handle, int32_t n);
+
+/* Counters as of the last processed batch, copied into a staging struct;
+ * NULL for a destroyed detector. */
+const sinyalist_stats* sinyalist_ffi_stats(int64_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SINYALIST_FFI_H */
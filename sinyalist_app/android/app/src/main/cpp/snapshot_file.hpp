@@ -0,0 +1,116 @@
+// =============================================================================
+// SINYALIST — SnapshotFile: crash-safe memory-mapped detector snapshots
+// =============================================================================
+// C14: The foreground service is restarted by BootReceiver or after an
+// OOM-kill, and a cold SeismicDetector is blind for at least the LTA window.
+// SnapshotFile keeps the latest SeismicDetector::snapshot() in a small mmap'd
+// file so the next process can restore() it:
+//
+//   file: slot[2], each kSlotHeader + capacity bytes
+//   slot: seq u64 | bytes u32 | pad u32 | image
+//
+// write() fills the older slot: seq is cleared first, the image copied, then
+// seq set to one past the newest — a process killed half-way leaves the other
+// slot intact. An abandoned write puts the cleared seq back, so the image
+// before the newest stays readable. Stores go to the page cache, so they
+// survive the process without a syscall per write; the image checksum
+// catches anything torn across a power loss.
+//
+// One writer per file: open() takes flock(LOCK_EX) for as long as the file is
+// mapped, so a second SeismicEngine on the same sensor (MainActivity next to
+// SinyalistForegroundService) gets no snapshot rather than a shared slot pair.
+// The lock goes with the process, so a restart after a kill still restores.
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sinyalist::seismic {
+
+class SnapshotFile {
+public:
+    static constexpr size_t kSlotHeader = 16;
+
+    SnapshotFile() = default;
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+    ~SnapshotFile() { close(); }
+
+    // Maps path (created or grown to two slots of `capacity` image bytes).
+    // Existing slots are kept for latest(). False if another SnapshotFile
+    // (in any process) has path open.
+    bool open(const char* path, size_t capacity) noexcept {
+        close();
+        int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+        if (fd < 0) return false;
+        if (flock(fd, LOCK_EX | LOCK_NB) != 0) { ::close(fd); return false; }
+        size_t slot = (kSlotHeader + capacity + 7) & ~size_t(7), len = 2 * slot;
+        struct stat st;
+        bool ok = fstat(fd, &st) == 0 && (size_t(st.st_size) >= len || ftruncate(fd, off_t(len)) == 0);
+        void* m = ok ? mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        if (m == MAP_FAILED) { ::close(fd); return false; }
+        map_ = static_cast<uint8_t*>(m); len_ = len; slot_ = slot; cap_ = capacity; fd_ = fd;
+        return true;
+    }
+
+    void close() noexcept {
+        if (map_) munmap(map_, len_);
+        if (fd_ >= 0) ::close(fd_);            // releases the lock
+        map_ = nullptr; len_ = slot_ = cap_ = 0; fd_ = -1;
+    }
+
+    bool is_open() const noexcept { return map_ != nullptr; }
+    size_t capacity() const noexcept { return cap_; }
+
+    // Newest committed image (i = 0) or the one before it (i = 1); null if
+    // that slot is empty or was being written.
+    const void* latest(size_t& n, int i = 0) const noexcept {
+        if (!map_) return nullptr;
+        int s = newest(); if (i) s ^= 1;
+        if (seq(s) == 0) return nullptr;
+        uint32_t b; std::memcpy(&b, map_ + size_t(s) * slot_ + 8, 4);
+        if (b > cap_) return nullptr;
+        n = b; return map_ + size_t(s) * slot_ + kSlotHeader;
+    }
+
+    // Writes an image in place: fill(dst, capacity) returns its size, or 0
+    // to abandon the write without touching dst (both previous images stay,
+    // as latest(n, 0) and latest(n, 1)). A size over capacity abandons too.
+    template<class Fill>
+    bool write(Fill&& fill) noexcept {
+        if (!map_) return false;
+        int s = newest() ^ 1;
+        uint64_t next = std::max(seq(0), seq(1)) + 1;
+        uint8_t* p = map_ + size_t(s) * slot_;
+        uint64_t old = seq(s);
+        set_seq(s, 0);
+        size_t n = fill(p + kSlotHeader, cap_);
+        if (!n || n > cap_) { set_seq(s, old); return false; }
+        uint32_t b = uint32_t(n); std::memcpy(p + 8, &b, 4);
+        set_seq(s, next);
+        return true;
+    }
+
+private:
+    uint8_t* map_ = nullptr;
+    size_t len_ = 0, slot_ = 0, cap_ = 0;
+    int fd_ = -1;                              // holds the flock
+
+    std::atomic<uint64_t>& seq_ref(int s) const noexcept {
+        return *reinterpret_cast<std::atomic<uint64_t>*>(map_ + size_t(s) * slot_);
+    }
+    uint64_t seq(int s) const noexcept { return seq_ref(s).load(std::memory_order_acquire); }
+    void set_seq(int s, uint64_t v) noexcept { seq_ref(s).store(v, std::memory_order_release); }
+    int newest() const noexcept { return seq(1) > seq(0) ? 1 : 0; }
+};
+
+} // namespace sinyalist::seismic
@@ -0,0 +1,159 @@
+// =============================================================================
+// SINYALIST — StageProfile: per-stage hot-path timing histograms
+// =============================================================================
+// C20: Opt-in (SINYALIST_PROFILE=1, CMake -DSINYALIST_PROFILE=ON). Without the
+// flag StageProfile is an empty class whose clock reads 0 and whose add()
+// does nothing, so the instrumented detector compiles to the same code.
+//
+// With it, the detectors time each stage of process_sample() with
+// CLOCK_MONOTONIC_RAW (the vDSO clock; the ARM PMU cycle counter is not
+// readable from user space on stock Android kernels) into fixed log2
+// histograms: bucket b counts durations in [2^b, 2^(b+1)) ns, bucket 0 also
+// 0 ns, the last one everything longer. Every reading includes about one
+// clock read, reported as overhead_ns() so consumers can subtract it.
+//
+// The sensor thread is the only writer; other threads may export at any
+// time (relaxed atomics, so counters of one stage can be one sample apart).
+//
+// export_words() layout (u64, shared with nativeGetStats / Kotlin / Dart):
+//   stages S (0 = compiled out) | buckets B | overhead_ns |
+//   S × (count | sum_ns | max_ns | B × bucket), in Stage order
+// =============================================================================
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef SINYALIST_PROFILE
+#define SINYALIST_PROFILE 0
+#endif
+#if SINYALIST_PROFILE
+#include <time.h>
+#endif
+
+namespace sinyalist::seismic {
+
+// SAMPLE is the whole process_sample() call; the rest are the parts of it
+// that ran. REJECT is a TriggerState step that ran check_reject() (the
+// confirming sample), AUTOCORR the periodicity score inside it.
+enum class Stage : uint8_t {
+    SAMPLE, GATE, FILTER, WINDOWS, SPECTRUM, TRIGGER, REJECT, AUTOCORR, COUNT
+};
+constexpr size_t kStages = size_t(Stage::COUNT);
+constexpr const char* kStageNames[kStages] = {
+    "sample", "gate", "filter", "windows", "spectrum", "trigger", "reject", "autocorr",
+};
+
+constexpr uint32_t kProfileBuckets = 24;     // last bucket: ≥ 8.4 ms
+constexpr size_t kProfileWords = 3 + kStages * (3 + kProfileBuckets);
+
+// Upper edge (ns) of the bucket holding the q-quantile of counts, 0 if empty.
+inline uint64_t profile_quantile_ns(const uint64_t* buckets, double q,
+                                    uint32_t nb = kProfileBuckets) noexcept {
+    uint64_t n = 0, acc = 0;
+    for (uint32_t b = 0; b < nb; ++b) n += buckets[b];
+    if (!n) return 0;
+    for (uint32_t b = 0; b < nb; ++b)
+        if ((acc += buckets[b]) >= q * double(n)) return uint64_t(2) << b;
+    return uint64_t(2) << (nb - 1);
+}
+
+// B log2 buckets as above. Also used by the C24 latency trace.
+template<uint32_t B>
+struct Log2Histogram {
+    static constexpr uint32_t kBuckets = B;
+    std::atomic<uint64_t> count{0}, sum_ns{0}, max_ns{0};
+    std::atomic<uint32_t> bucket[B]{};
+
+    // Single writer: plain load + store, no read-modify-write.
+    void add(uint64_t ns) noexcept {
+        bump(count, 1); bump(sum_ns, ns);
+        if (ns > max_ns.load(std::memory_order_relaxed)) max_ns.store(ns, std::memory_order_relaxed);
+        uint32_t b = ns ? uint32_t(63 - __builtin_clzll(ns)) : 0;
+        bump(bucket[b < B ? b : B - 1], 1u);
+    }
+    void reset() noexcept {
+        count.store(0, std::memory_order_relaxed); sum_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+        for (auto& b : bucket) b.store(0, std::memory_order_relaxed);
+    }
+
+    // count | sum_ns | max_ns | B × bucket; returns the words written.
+    size_t export_words(uint64_t* out) const noexcept {
+        uint64_t* p = out;
+        *p++ = count.load(std::memory_order_relaxed);
+        *p++ = sum_ns.load(std::memory_order_relaxed);
+        *p++ = max_ns.load(std::memory_order_relaxed);
+        for (const auto& b : bucket) *p++ = b.load(std::memory_order_relaxed);
+        return size_t(p - out);
+    }
+
+private:
+    template<class A, class T> static void bump(A& a, T d) noexcept {
+        a.store(a.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+    }
+};
+using StageHistogram = Log2Histogram<kProfileBuckets>;
+
+#if SINYALIST_PROFILE
+
+class StageProfile {
+public:
+    static constexpr bool kEnabled = true;
+    using Tick = uint64_t;
+
+    static Tick now() noexcept {
+        timespec t;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &t);
+        return uint64_t(t.tv_sec) * 1000000000u + uint64_t(t.tv_nsec);
+    }
+    void add(Stage s, Tick t0, Tick t1) noexcept { h_[size_t(s)].add(t1 - t0); }
+    // Records now - t under s and moves t to now.
+    void lap(Stage s, Tick& t) noexcept { Tick n = now(); add(s, t, n); t = n; }
+
+    const StageHistogram& operator[](Stage s) const noexcept { return h_[size_t(s)]; }
+    void reset() noexcept { for (auto& h : h_) h.reset(); }
+
+    // Cheapest of a few back-to-back clock reads, measured once.
+    static uint64_t overhead_ns() noexcept {
+        static const uint64_t ns = [] {
+            uint64_t best = ~uint64_t(0);
+            for (int i = 0; i < 64; ++i) { Tick a = now(), b = now(); if (b - a < best) best = b - a; }
+            return best;
+        }();
+        return ns;
+    }
+
+    // See the layout above; out holds kProfileWords. Returns the words written.
+    size_t export_words(uint64_t* out) const noexcept {
+        uint64_t* p = out;
+        *p++ = kStages; *p++ = kProfileBuckets; *p++ = overhead_ns();
+        for (const auto& h : h_) p += h.export_words(p);
+        return size_t(p - out);
+    }
+
+private:
+    StageHistogram h_[kStages];
+};
+
+#else
+
+class StageProfile {
+public:
+    static constexpr bool kEnabled = false;
+    using Tick = uint64_t;
+    static Tick now() noexcept { return 0; }
+    void add(Stage, Tick, Tick) noexcept {}
+    void lap(Stage, Tick&) noexcept {}
+    void reset() noexcept {}
+    static uint64_t overhead_ns() noexcept { return 0; }
+    size_t export_words(uint64_t* out) const noexcept {
+        out[0] = 0; out[1] = kProfileBuckets; out[2] = 0;
+        return 3;
+    }
+};
+
+#endif
+
+} // namespace sinyalist::seismic
@@ -0,0 +1,215 @@
+// =============================================================================
+// SINYALIST — Steim-2 waveform codec (SEED Steim-2 frames)
+// =============================================================================
+// C17: Captured waveforms (C16) travel over BLE mesh and SMS, so they are
+// quantised to int16 counts and packed as first differences in Steim-2
+// frames, the miniSEED format every seismology tool reads:
+//
+//   frame (64 B): 16 big-endian u32 words; word 0 holds a 2-bit code per
+//                 word, frame 0 also has X0 (first sample) in word 1 and
+//                 Xn (last sample, integrity check) in word 2
+//   codes: 01 = 4×8-bit | 10 + dnib 01/10/11 = 1×30, 2×15, 3×10-bit |
+//          11 + dnib 00/01/10 = 5×6, 6×5, 7×4-bit
+//
+// Steim2Encoder is streaming: push() one sample at a time while it is
+// captured, into a caller buffer, holding at most 7 pending differences and
+// never allocating. steim2_decode() is a block decoder. At the default
+// 2048 counts/g (below a phone accelerometer's noise floor) ~2 mg of sensor
+// noise packs to about 6 bits per sample, against 32 for the raw capture.
+// The frames are lossless over the int16 counts; the float → counts step
+// is not (±half a count, saturating at ±16 g).
+//
+// pack_waveform() wraps the three axes of a capture into one image:
+//   header (24 B, little-endian): magic u32 | samples u32 | counts_per_g f32 |
+//                                 bytes u32 × 3 (x, y, z Steim-2 streams)
+//   then the three streams back to back
+// The C ABI over both is in sinyalist_codec.h.
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace sinyalist::seismic {
+
+constexpr size_t kSteimFrame = 64;
+
+inline uint32_t load_be32(const uint8_t* p) noexcept {
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+}
+inline void store_be32(uint8_t* p, uint32_t v) noexcept {
+    p[0] = uint8_t(v >> 24); p[1] = uint8_t(v >> 16); p[2] = uint8_t(v >> 8); p[3] = uint8_t(v);
+}
+
+// Upper bound of the stream size for n samples (every difference at 30 bits).
+constexpr size_t steim2_max_bytes(size_t n) noexcept {
+    return (n + 2 + 14) / 15 * kSteimFrame + kSteimFrame;
+}
+
+class Steim2Encoder {
+public:
+    // out must stay valid until finish(); cap is rounded down to whole frames.
+    Steim2Encoder(uint8_t* out, size_t cap) noexcept
+        : out_(out), frames_(cap / kSteimFrame) {}
+
+    // False once the buffer is full; the stream is then unusable.
+    bool push(int32_t x) noexcept {
+        if (ok_ && n_ == 0) { x0_ = x; prev_ = x; }
+        d_[nd_++] = x - prev_;                 // d0 = 0: X0 carries the first sample
+        prev_ = x; ++n_;
+        if (nd_ == 7) emit();
+        return ok_;
+    }
+
+    // Flushes the pending differences and writes Xn; returns the stream size
+    // in bytes (whole frames) or 0 if it did not fit.
+    size_t finish() noexcept {
+        while (ok_ && nd_) emit();
+        if (!ok_ || n_ == 0) return 0;
+        finish_frame();
+        store_be32(out_ + 4, uint32_t(x0_));
+        store_be32(out_ + 8, uint32_t(prev_));
+        return size_t(frame_) * kSteimFrame;
+    }
+
+    size_t samples() const noexcept { return n_; }
+
+private:
+    uint8_t* out_; size_t frames_;
+    size_t frame_ = 0, n_ = 0;
+    uint32_t word_ = 0, ctrl_ = 0;             // next word in the current frame
+    int32_t d_[7] = {}, x0_ = 0, prev_ = 0;
+    uint32_t nd_ = 0;
+    bool ok_ = true;
+
+    static bool fits(const int32_t* d, uint32_t k, int bits) noexcept {
+        const int32_t lo = -(1 << (bits - 1)), hi = (1 << (bits - 1)) - 1;
+        for (uint32_t i = 0; i < k; ++i) if (d[i] < lo || d[i] > hi) return false;
+        return true;
+    }
+
+    // Packs the densest prefix of the pending differences into one word.
+    void emit() noexcept {
+        struct Fmt { uint32_t k; int bits; uint32_t code, dnib; };
+        static constexpr Fmt kFmt[] = {
+            {7, 4, 3, 2}, {6, 5, 3, 1}, {5, 6, 3, 0}, {4, 8, 1, 0},
+            {3, 10, 2, 3}, {2, 15, 2, 2}, {1, 30, 2, 1},
+        };
+        for (const Fmt& f : kFmt) {
+            if (f.k > nd_ || !fits(d_, f.k, f.bits)) continue;
+            uint32_t w = f.code == 1 ? 0 : f.dnib << 30;
+            for (uint32_t i = 0; i < f.k; ++i)
+                w |= (uint32_t(d_[i]) & ((1u << f.bits) - 1)) << (f.bits * (f.k - 1 - i));
+            put(w, f.code);
+            std::memmove(d_, d_ + f.k, (nd_ - f.k) * sizeof(int32_t));
+            nd_ -= f.k;
+            return;
+        }
+        ok_ = false;                           // |difference| ≥ 2^29
+    }
+
+    void put(uint32_t w, uint32_t code) noexcept {
+        if (word_ == 0) {
+            if (frame_ == frames_) { ok_ = false; return; }
+            std::memset(out_ + frame_ * kSteimFrame, 0, kSteimFrame);
+            ctrl_ = 0; word_ = frame_ == 0 ? 3 : 1;
+        }
+        store_be32(out_ + frame_ * kSteimFrame + word_ * 4, w);
+        ctrl_ |= code << (2 * (15 - word_));
+        if (++word_ == 16) finish_frame();
+    }
+
+    void finish_frame() noexcept {
+        if (word_ == 0) return;
+        store_be32(out_ + frame_ * kSteimFrame, ctrl_);
+        ++frame_; word_ = 0;
+    }
+};
+
+// Decodes n samples from a Steim-2 stream. Returns n, or 0 if the stream is
+// short, malformed or its last sample does not match Xn.
+inline size_t steim2_decode(const uint8_t* in, size_t bytes, int32_t* out, size_t n) noexcept {
+    if (n == 0 || bytes < kSteimFrame) return 0;
+    const int32_t x0 = int32_t(load_be32(in + 4)), xn = int32_t(load_be32(in + 8));
+    size_t got = 0, diffs = 0;
+    int32_t x = x0;
+    auto take = [&](uint32_t w, uint32_t k, int bits) {
+        for (uint32_t i = 0; i < k && got < n; ++i) {
+            int sh = bits * int(k - 1 - i);
+            int32_t d = int32_t(w << (32 - sh - bits)) >> (32 - bits);
+            if (diffs++ == 0) x = x0; else x += d;   // d0 is not used
+            out[got++] = x;
+        }
+    };
+    for (size_t f = 0; f < bytes / kSteimFrame && got < n; ++f) {
+        const uint8_t* fp = in + f * kSteimFrame;
+        uint32_t ctrl = load_be32(fp);
+        for (uint32_t i = 1; i < 16 && got < n; ++i) {
+            uint32_t w = load_be32(fp + i * 4), code = (ctrl >> (2 * (15 - i))) & 3, dnib = w >> 30;
+            if (code == 0) continue;
+            if (code == 1) take(w, 4, 8);
+            else if (code == 2) {
+                if (dnib == 1) take(w, 1, 30); else if (dnib == 2) take(w, 2, 15);
+                else if (dnib == 3) take(w, 3, 10); else return 0;
+            } else {
+                if (dnib == 0) take(w, 5, 6); else if (dnib == 1) take(w, 6, 5);
+                else if (dnib == 2) take(w, 7, 4); else return 0;
+            }
+        }
+    }
+    return got == n && x == xn ? n : 0;
+}
+
+// C16 capture samples (g) → int16 counts, saturating.
+constexpr float kCountsPerG = 2048.0f;        // ±16 g, 0.49 mg per count
+inline int32_t to_counts(float g, float counts_per_g) noexcept {
+    return int32_t(std::clamp(std::lrint(g * counts_per_g), -32768L, 32767L));
+}
+
+struct PackedWaveformHeader {
+    static constexpr uint32_t kMagic = 0x315a5753;   // "SWZ1"
+    uint32_t magic, samples; float counts_per_g; uint32_t bytes[3];
+};
+static_assert(sizeof(PackedWaveformHeader) == 24, "packed waveform layout is shared with the backend");
+
+// Quantises n interleaved xyz samples and packs them; returns the image size
+// or 0 if cap is too small.
+inline size_t pack_waveform(const float* xyz, size_t n, float counts_per_g,
+                            uint8_t* out, size_t cap) noexcept {
+    PackedWaveformHeader h{PackedWaveformHeader::kMagic, uint32_t(n), counts_per_g, {}};
+    if (n == 0 || cap < sizeof(h)) return 0;
+    size_t at = sizeof(h);
+    for (int a = 0; a < 3; ++a) {
+        Steim2Encoder enc(out + at, cap - at);
+        for (size_t i = 0; i < n; ++i) if (!enc.push(to_counts(xyz[3*i + a], counts_per_g))) return 0;
+        size_t b = enc.finish();
+        if (!b) return 0;
+        h.bytes[a] = uint32_t(b); at += b;
+    }
+    std::memcpy(out, &h, sizeof(h));
+    return at;
+}
+
+// Inverse of pack_waveform into at most max_n samples (scratch holds max_n
+// int32); returns the sample count or 0 if the image is malformed. Values
+// come back in g, quantised.
+inline size_t unpack_waveform(const uint8_t* in, size_t bytes, float* xyz, size_t max_n,
+                              int32_t* scratch) noexcept {
+    PackedWaveformHeader h;
+    if (bytes < sizeof(h)) return 0;
+    std::memcpy(&h, in, sizeof(h));
+    if (h.magic != PackedWaveformHeader::kMagic || h.samples > max_n || !(h.counts_per_g > 0)) return 0;
+    size_t at = sizeof(h);
+    for (int a = 0; a < 3; ++a) {
+        if (h.bytes[a] > bytes - at) return 0;
+        if (steim2_decode(in + at, h.bytes[a], scratch, h.samples) != h.samples) return 0;
+        for (size_t i = 0; i < h.samples; ++i) xyz[3*i + a] = float(scratch[i]) / h.counts_per_g;
+        at += h.bytes[a];
+    }
+    return h.samples;
+}
+
+} // namespace sinyalist::seismic
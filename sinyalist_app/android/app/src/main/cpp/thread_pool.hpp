@@ -0,0 +1,88 @@
+// =============================================================================
+// SINYALIST — Minimal fixed-size thread pool (host-side tools and banks)
+// =============================================================================
+// parallel_for(n, fn) runs fn(0..n-1) across the workers and the calling
+// thread, handing out indices from a shared atomic counter so uneven items
+// balance themselves, and returns once every index has completed.
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sinyalist {
+
+class ThreadPool {
+public:
+    // threads = total parallelism including the caller; 0 = hardware threads
+    explicit ThreadPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threads; ++i) workers_.emplace_back([this] { worker(); });
+    }
+    ~ThreadPool() {
+        { std::lock_guard<std::mutex> lk(mu_); stop_ = true; }
+        cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const noexcept { return unsigned(workers_.size()) + 1; }
+
+    template<class F>
+    void parallel_for(uint32_t n, F&& fn) {
+        if (n == 0) return;
+        if (workers_.empty() || n == 1) { for (uint32_t i = 0; i < n; ++i) fn(i); return; }
+        std::function<void(uint32_t)> job(std::ref(fn));
+        {
+            std::lock_guard<std::mutex> lk(mu_);
+            job_ = &job; n_ = n; next_.store(0); pending_ = n; ++gen_;
+        }
+        cv_.notify_all();
+        drain();
+        std::unique_lock<std::mutex> lk(mu_);
+        done_cv_.wait(lk, [this] { return pending_ == 0 && active_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    void drain() {
+        uint32_t i, done = 0;
+        while ((i = next_.fetch_add(1)) < n_) { (*job_)(i); ++done; }
+        if (done) {
+            std::lock_guard<std::mutex> lk(mu_);
+            pending_ -= done;
+            if (pending_ == 0) done_cv_.notify_all();
+        }
+    }
+    void worker() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lk(mu_);
+        while (true) {
+            cv_.wait(lk, [&] { return stop_ || (gen_ != seen && job_); });
+            if (stop_) return;
+            seen = gen_; ++active_;
+            lk.unlock();
+            drain();
+            lk.lock();
+            if (--active_ == 0 && pending_ == 0) done_cv_.notify_all();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mu_;
+    std::condition_variable cv_, done_cv_;
+    std::function<void(uint32_t)>* job_ = nullptr;
+    std::atomic<uint32_t> next_{0};
+    uint32_t n_ = 0, pending_ = 0, active_ = 0;
+    uint64_t gen_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace sinyalist
@@ -0,0 +1,445 @@
+// =============================================================================
+// SINYALIST — sinyalist_bench (host tool)
+// =============================================================================
+// Microbenchmarks for every DSP building block of the detector, each in the
+// variants that exist: scalar (per-axis reference), simd (C2 lane-parallel)
+// and fixed (C15 integer). simd is NEON only on ARM; elsewhere it is the
+// portable float[4] fallback (filter_chain: three scalar lanes), so compare
+// simd across releases on an arm64 host (the JSON records "neon").
+// Costs are per 3-axis sample unless the unit says per call, best of five
+// rounds. process_sample/<state> splits the full detector by the trigger
+// state each sample arrives in, so the always-on path (idle, asleep) is
+// tracked apart from the rare confirm/triggered work. detector_bank/<n> is
+// per stream-sample, against seismic_detector for one stream (both without
+// the pre-gate, which DetectorBank does not have).
+//
+//   sinyalist_bench [options]
+//     --json <file|->     also write the results as JSON (schema 1) for
+//                         tracking across releases and architectures
+//     --filter <text>     only benchmarks whose name contains text
+//     --min-ms <ms>       measuring time per benchmark (default 200)
+//     --rate <hz>         detector rate, 50 | 100 | 200 (default 50)
+// =============================================================================
+
+#include "replay_engine.hpp"
+#include <cstdlib>
+
+using namespace sinyalist;
+using namespace sinyalist::seismic;
+
+namespace {
+
+// Escapes the optimiser: v must be materialised in memory.
+template<class T> inline void keep(const T& v) { asm volatile("" : : "r"(&v) : "memory"); }
+
+// One benchmark kernel: step(state, in) for n inputs `stride` apart. Out of
+// line so every kernel is compiled alone, the same way from build to build.
+// Small plain filter state is worked on as a local copy, which the compiler
+// keeps in registers as it does inside the detector; windows (tens of KB,
+// or heap-backed) are updated in place.
+template<class S, class T, class Step>
+__attribute__((noinline)) void block(S& st, const T* in, size_t stride, size_t n, Step step) {
+    if constexpr (std::is_trivially_copyable_v<S> && sizeof(S) <= 1024) {
+        S q = st;
+        for (size_t i = 0; i < n; ++i, in += stride) step(q, in);
+        st = q;
+    } else {
+        for (size_t i = 0; i < n; ++i, in += stride) step(st, in);
+    }
+    keep(st);
+}
+
+struct Result { std::string name, variant, unit; double ns; uint64_t items; };
+
+struct Suite {
+    double min_ms = 200;
+    std::string filter;
+    FILE* out = stdout;                                  // the table; stderr when JSON goes to stdout
+    std::vector<Result> results;
+
+    bool wanted(const std::string& name) const { return filter.empty() || name.find(filter) != std::string::npos; }
+
+    // pass() handles `items` items per call; reports the fastest round.
+    template<class Pass>
+    void run(const std::string& name, const char* variant, size_t items, Pass&& pass,
+             const char* unit = "sample") {
+        if (!wanted(name)) return;
+        pass();                                          // warm caches and branch predictors
+        double best = 1e300; uint64_t total = 0;
+        for (int round = 0; round < 5; ++round) {
+            uint64_t n = 0; auto a = replay::Clock::now(); double ns = 0;
+            do { pass(); n += items; ns = replay::elapsed_ns(a, replay::Clock::now()); }
+            while (ns < min_ms * 2e5);                   // min_ms / 5 per round
+            best = std::min(best, ns / double(n)); total += n;
+        }
+        add(name, variant, unit, best, total);
+    }
+
+    void add(const std::string& name, const char* variant, const char* unit, double ns, uint64_t items) {
+        results.push_back({name, variant, unit, ns, items});
+        std::fprintf(out, "  %-28s %-7s %9.2f ns/%s\n", name.c_str(), variant, ns, unit);
+    }
+};
+
+const char* arch() {
+#if defined(__aarch64__)
+    return "arm64";
+#elif defined(__arm__)
+    return "armv7";
+#elif defined(__x86_64__)
+    return "x86_64";
+#elif defined(__i386__)
+    return "x86";
+#else
+    return "unknown";
+#endif
+}
+
+const char* compiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+std::string json_str(const std::string& s) {
+    std::string o = "\"";
+    for (char c : s) { if (c == '"' || c == '\\') o += '\\'; o += c; }
+    return o + "\"";
+}
+
+bool write_json(const char* path, const Suite& s, float rate) {
+    FILE* f = std::string(path) == "-" ? stdout : std::fopen(path, "w");
+    if (!f) return false;
+#ifdef SINYALIST_NEON
+    const bool neon = true;
+#else
+    const bool neon = false;
+#endif
+    std::fprintf(f, "{\n  \"tool\": \"sinyalist_bench\",\n  \"schema\": 1,\n");
+    std::fprintf(f, "  \"arch\": \"%s\",\n  \"compiler\": %s,\n  \"neon\": %s,\n  \"profile\": %s,\n",
+                 arch(), json_str(compiler()).c_str(), neon ? "true" : "false",
+                 StageProfile::kEnabled ? "true" : "false");
+    std::fprintf(f, "  \"sample_rate_hz\": %.1f,\n  \"benchmarks\": [\n", double(rate));
+    for (size_t i = 0; i < s.results.size(); ++i) {
+        const Result& r = s.results[i];
+        std::fprintf(f, "    {\"name\": %s, \"variant\": %s, \"unit\": \"ns/%s\", \"ns\": %.3f, \"items\": %llu}%s\n",
+                     json_str(r.name).c_str(), json_str(r.variant).c_str(), r.unit.c_str(), r.ns,
+                     (unsigned long long)r.items, i + 1 < s.results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    return f == stdout ? std::fflush(f) == 0 : std::fclose(f) == 0;
+}
+
+// Inputs shared by the block benchmarks: raw g, Q27, filtered magnitudes.
+struct Inputs {
+    static constexpr size_t kN = 4096;
+    std::vector<float> xyz, mag;
+    std::vector<int32_t> xyz_q, mag_q;
+    std::vector<simd::f4> filt;
+};
+
+Inputs make_inputs(const replay::Trace& t, const Config& cfg) {
+    Inputs in;
+    const size_t n = std::min(Inputs::kN, t.size());
+    in.xyz.assign(t.xyz.begin(), t.xyz.begin() + 3 * n);
+    AxisFilterChain fc(filter_design_for(cfg.sample_rate_hz));
+    fx::AxisFilterChainQ fq(filter_design_for(cfg.sample_rate_hz));
+    for (size_t i = 0; i < n; ++i) {
+        const float* p = &in.xyz[3 * i];
+        for (int a = 0; a < 3; ++a) in.xyz_q.push_back(fx::to_q(p[a], fx::kAccQ, fx::kAccMax));
+        simd::f4 f = fc.process(p[0], p[1], p[2]);
+        float x = simd::lane(f, 0), y = simd::lane(f, 1), z = simd::lane(f, 2);
+        in.filt.push_back(f);
+        in.mag.push_back(std::sqrt(x * x + y * y + z * z));
+        int32_t q[3]; fq.process(p[0], p[1], p[2], q);
+        in.mag_q.push_back(fx::magnitude(q));
+    }
+    return in;
+}
+
+void bench_filters(Suite& s, const Inputs& in, const FilterDesign& d, const Config& cfg) {
+    const size_t n = in.mag.size();
+    const float* x = in.xyz.data(); const int32_t* xq = in.xyz_q.data();
+    using F3 = std::array<BandPassFilter, 3>;
+
+    std::array<Biquad, 3> bq = {d.hp, d.hp, d.hp};
+    s.run("biquad", "scalar", n, [&] {
+        block(bq, x, 3, n, [](auto& q, const float* p) { for (int a = 0; a < 3; ++a) q[a].process(p[a]); });
+    });
+    BiquadX3 bx(d.hp);
+    s.run("biquad", "simd", n, [&] {
+        block(bx, x, 3, n, [](auto& q, const float* p) { q.process(simd::set3(p[0], p[1], p[2])); });
+    });
+    fx::BiquadQ bqq(d.hp);
+    s.run("biquad", "fixed", n, [&] {
+        block(bqq, xq, 3, n, [](auto& q, const int32_t* p) { for (int a = 0; a < 3; ++a) q.process(a, p[a]); });
+    });
+
+    F3 bp = {BandPassFilter(d), BandPassFilter(d), BandPassFilter(d)};
+    s.run("bandpass", "scalar", n, [&] {
+        block(bp, x, 3, n, [](auto& q, const float* p) { for (int a = 0; a < 3; ++a) q[a].process(p[a]); });
+    });
+    std::array<BiquadX3, 2> bpx = {BiquadX3(d.hp), BiquadX3(d.lp)};
+    s.run("bandpass", "simd", n, [&] {
+        block(bpx, x, 3, n, [](auto& q, const float* p) { q[1].process(q[0].process(simd::set3(p[0], p[1], p[2]))); });
+    });
+    std::array<fx::BiquadQ, 2> bpq = {fx::BiquadQ(d.hp), fx::BiquadQ(d.lp)};
+    s.run("bandpass", "fixed", n, [&] {
+        block(bpq, xq, 3, n, [](auto& q, const int32_t* p) {
+            for (int a = 0; a < 3; ++a) q[1].process(a, q[0].process(a, p[a]));
+        });
+    });
+
+    // Gravity plus the linear acceleration it yields, accumulated so it is used.
+    struct GravityScalar { GravityEstimator g; float acc = 0; } gs;
+    gs.g.alpha = d.grav_alpha;
+    s.run("gravity", "scalar", n, [&] {
+        block(gs, x, 3, n, [](auto& q, const float* p) {
+            q.g.update(p[0], p[1], p[2]);
+            q.acc += q.g.linX(p[0]) + q.g.linY(p[1]) + q.g.linZ(p[2]);
+        });
+    });
+    struct GravitySimd { simd::f4 g, k, lin; } gv{simd::set3(0, 0, -1.0f), simd::dup(d.grav_alpha), simd::dup(0)};
+    s.run("gravity", "simd", n, [&] {
+        block(gv, x, 3, n, [](auto& q, const float* p) {
+            simd::f4 raw = simd::set3(p[0], p[1], p[2]);
+            q.g = simd::add(q.g, simd::mul(q.k, simd::sub(raw, q.g)));
+            q.lin = simd::add(q.lin, simd::sub(raw, q.g));
+        });
+    });
+
+    // Whole B2 → B1 → HP chain: the pre-C2 per-axis objects against C2/C15.
+    struct ChainScalar { GravityEstimator g; F3 bp; std::array<HighPassState, 3> hp; float a; };
+    ChainScalar cs{GravityEstimator{}, {BandPassFilter(d), BandPassFilter(d), BandPassFilter(d)}, {}, cfg.hp_alpha};
+    cs.g.alpha = d.grav_alpha;
+    s.run("filter_chain", "scalar", n, [&] {
+        block(cs, x, 3, n, [](auto& q, const float* p) {
+            q.g.update(p[0], p[1], p[2]);
+            q.hp[0].process(q.bp[0].process(q.g.linX(p[0])), q.a);
+            q.hp[1].process(q.bp[1].process(q.g.linY(p[1])), q.a);
+            q.hp[2].process(q.bp[2].process(q.g.linZ(p[2])), q.a);
+        });
+    });
+    AxisFilterChain fc(d); fc.set_hp_alpha(cfg.hp_alpha);
+    s.run("filter_chain", "simd", n, [&] {
+        block(fc, x, 3, n, [](auto& q, const float* p) { q.process(p[0], p[1], p[2]); });
+    });
+    fx::AxisFilterChainQ fq(d); fq.set_hp_alpha(cfg.hp_alpha);
+    s.run("filter_chain", "fixed", n, [&] {
+        block(fq, x, 3, n, [](auto& q, const float* p) { int32_t o[3]; q.process(p[0], p[1], p[2], o); });
+    });
+}
+
+void bench_windows(Suite& s, const Inputs& in, const Config& cfg) {
+    const size_t n = in.mag.size();
+
+    struct Boxcar { Ring<float,128> sta; Ring<float,2048> lta; Ring<float,8192> cal; float acc = 0; } bw;
+    bw.sta.set_cap(cfg.sta_window); bw.lta.set_cap(cfg.lta_window); bw.cal.set_cap(cfg.calib_window);
+    s.run("ring_push_avg_var", "scalar", n, [&] {
+        block(bw, in.mag.data(), 1, n, [](auto& q, const float* m) {
+            q.sta.push(*m); q.lta.push(*m); q.cal.push(*m);
+            q.acc += q.sta.avg() + q.lta.avg() + q.cal.var();
+        });
+    });
+    struct BoxcarQ {
+        Ring<int32_t,128,int64_t> sta; Ring<int32_t,2048,int64_t> lta; Ring<int32_t,8192,int64_t> cal; int64_t acc = 0;
+    } bq;
+    bq.sta.set_cap(cfg.sta_window); bq.lta.set_cap(cfg.lta_window); bq.cal.set_cap(cfg.calib_window);
+    s.run("ring_push_avg_var", "fixed", n, [&] {
+        block(bq, in.mag_q.data(), 1, n, [](auto& q, const int32_t* m) {
+            q.sta.push(*m); q.lta.push(*m); q.cal.push(*m);
+            q.acc += q.sta.sum() + q.lta.sum() + q.cal.sum_sq();   // the fixed core reads the sums
+        });
+    });
+
+    struct Recursive { RecursiveStaLta r; float acc = 0; } rw;
+    rw.r.configure(cfg.sta_window, cfg.lta_window, cfg.calib_window);
+    s.run("recursive_sta_lta", "scalar", n, [&] {
+        block(rw, in.mag.data(), 1, n, [](auto& q, const float* m) {
+            q.r.push(*m); q.acc += q.r.sta + q.r.lta + q.r.var;
+        });
+    });
+}
+
+template<class Tracker>
+void configure_periodicity(Tracker& p, const Config& cfg) {
+    p.configure(uint32_t(4.f * cfg.sample_rate_hz), uint32_t(cfg.sample_rate_hz / 2.5f),
+                uint32_t(cfg.sample_rate_hz / 1.5f));
+}
+
+void bench_decision(Suite& s, const Inputs& in, const Config& cfg) {
+    const size_t n = in.mag.size();
+    const float* m = in.mag.data(); const int32_t* mq = in.mag_q.data();
+    constexpr size_t kCalls = 64;
+
+    // Windows and bins start full, so every benchmark below sees steady state
+    // whichever of them --filter selects.
+    PeriodicityTracker<1024,64> per; configure_periodicity(per, cfg);
+    PeriodicityTracker<1024,64,int32_t,int64_t,fx::kMagQ> perq; configure_periodicity(perq, cfg);
+    SpectralBank spec; spec.configure(cfg.sample_rate_hz, cfg.pwave_freq_min, cfg.pwave_freq_max);
+    for (size_t i = 0; i < n; ++i) { per.push(m[i]); perq.push(mq[i]); spec.push(in.filt[i]); }
+
+    // C3: periodicity_push is what every sample pays (idle: the window only),
+    // periodicity_track a sample while a candidate is open, periodicity_seed
+    // the one-off rebuild of the lag sums on IDLE → CONFIRM.
+    s.run("periodicity_push", "scalar", n, [&] {
+        block(per, m, 1, n, [](auto& q, const float* v) { q.push(*v); });
+    });
+    s.run("periodicity_push", "fixed", n, [&] {
+        block(perq, mq, 1, n, [](auto& q, const int32_t* v) { q.push(*v); });
+    });
+    s.run("periodicity_seed", "scalar", 1, [&] { per.track(false); per.track(true); keep(per); }, "call");
+    s.run("periodicity_seed", "fixed", 1, [&] { perq.track(false); perq.track(true); keep(perq); }, "call");
+    per.track(true); perq.track(true);
+    s.run("periodicity_track", "scalar", n, [&] {
+        block(per, m, 1, n, [](auto& q, const float* v) { q.push(*v); });
+    });
+    s.run("periodicity_track", "fixed", n, [&] {
+        block(perq, mq, 1, n, [](auto& q, const int32_t* v) { q.push(*v); });
+    });
+
+    // score() is the autocorr over the lag range.
+    s.run("autocorr", "scalar", kCalls, [&] {
+        float acc = 0; for (size_t k = 0; k < kCalls; ++k) { keep(per); acc += per.score(); } keep(acc);
+    }, "call");
+    s.run("autocorr", "fixed", kCalls, [&] {
+        float acc = 0; for (size_t k = 0; k < kCalls; ++k) { keep(perq); acc += perq.score(); } keep(acc);
+    }, "call");
+
+    s.run("spectral_push", "simd", n, [&] {
+        block(spec, in.filt.data(), 1, n, [](auto& q, const simd::f4* f) { q.push(*f); });
+    });
+    s.run("spectral_peak", "simd", kCalls, [&] {
+        float acc = 0; for (size_t k = 0; k < kCalls; ++k) { keep(spec); acc += spec.peak().freq_hz; } keep(acc);
+    }, "call");
+
+    // Every stage passes, so check_reject() runs to the end (autocorr included).
+    TriggerState trg;
+    Config c = cfg; c.periodicity_thresh = 2.0f;
+    const SpectralPeak sp{0.5f * (cfg.pwave_freq_min + cfg.pwave_freq_max), 0.9f};
+    s.run("check_reject", "scalar", kCalls, [&] {
+        uint32_t acc = 0;
+        for (size_t k = 0; k < kCalls; ++k) {
+            for (int a = 0; a < 3; ++a) { trg.ap[a] = 0.1f + 0.01f * float(a); trg.ae[a] = 0.01f; }
+            keep(trg);
+            acc += uint32_t(trg.check_reject(c, [&](float th) { return per.full() && per.score() > th; }, sp));
+        }
+        keep(acc);
+    }, "call");
+}
+
+// process_sample() cost by the state each sample arrives in; the clock is
+// read only at state changes, so it costs ~nothing inside a run.
+template<class Det>
+void bench_states(Suite& s, const char* variant, const replay::Trace& t, Config cfg, bool pregate) {
+    enum { ASLEEP, COOLDOWN, IDLE, CONFIRM, TRIGGERED, N };
+    static const char* kNames[N] = {"asleep", "cooldown", "idle", "confirm", "triggered"};
+    bool any = false;
+    for (const char* k : kNames) any |= s.wanted(std::string("process_sample/") + k);
+    if (!any) return;
+
+    cfg.pregate = pregate;
+    Det det{NullSink{}};
+    det.update_config(cfg);
+    auto state = [&det] {
+        if (det.asleep()) return int(ASLEEP);
+        const TriggerState& tr = det.trigger();
+        return tr.cd > 0 ? int(COOLDOWN) : IDLE + int(tr.st);
+    };
+    auto pass = [&](double* ns, uint64_t* cnt) {
+        int c = state(); auto a = replay::Clock::now();
+        for (size_t i = 0; i < t.size(); ++i) {
+            int c2 = state();
+            if (c2 != c) { auto b = replay::Clock::now(); if (ns) ns[c] += replay::elapsed_ns(a, b); a = b; c = c2; }
+            det.process_sample(t.xyz[3*i], t.xyz[3*i+1], t.xyz[3*i+2], t.ts[i]);
+            if (cnt) ++cnt[c];
+        }
+        if (ns) ns[c] += replay::elapsed_ns(a, replay::Clock::now());
+    };
+    pass(nullptr, nullptr);                          // warm: windows full from here on
+    double ns[N] = {}; uint64_t cnt[N] = {};
+    auto a = replay::Clock::now();
+    do pass(ns, cnt); while (replay::elapsed_ns(a, replay::Clock::now()) < s.min_ms * 1e6);
+    for (int k = pregate ? ASLEEP : COOLDOWN; k <= (pregate ? ASLEEP : TRIGGERED); ++k) {
+        std::string name = std::string("process_sample/") + kNames[k];
+        if (cnt[k] && s.wanted(name)) s.add(name, variant, "sample", ns[k] / double(cnt[k]), cnt[k]);
+    }
+}
+
+// DetectorBank over n phase-shifted copies of the trace (as sinyalist_replay
+// --bank), fed in blocks of kBlock samples, against one SeismicDetector.
+void bench_bank(Suite& s, const replay::Trace& t, Config cfg) {
+    cfg.pregate = false;
+    const size_t n = t.size();
+    {
+        BasicSeismicDetector<NullSink> det{NullSink{}};
+        det.update_config(cfg);
+        s.run("seismic_detector", "simd", n, [&] {
+            for (size_t i = 0; i < n; ++i) det.process_sample(t.xyz[3*i], t.xyz[3*i+1], t.xyz[3*i+2], t.ts[i]);
+        });
+    }
+    constexpr size_t kBlock = 64;
+    for (uint32_t streams : {8u, 64u}) {
+        std::string name = "detector_bank/" + std::to_string(streams);
+        if (!s.wanted(name)) continue;
+        std::vector<float> xyz(n * streams * 3);
+        std::vector<uint64_t> ts(n * streams);
+        for (size_t i = 0; i < n; ++i)
+            for (uint32_t k = 0; k < streams; ++k) {
+                size_t src = (i + size_t(k) * 97) % n, dst = i * streams + k;
+                std::memcpy(&xyz[dst * 3], &t.xyz[src * 3], 3 * sizeof(float));
+                ts[dst] = t.ts[i];
+            }
+        DetectorBank bank(streams, cfg, nullptr, 1);
+        s.run(name, "simd", n * streams, [&] {
+            for (size_t i = 0; i < n; i += kBlock)
+                bank.run(&xyz[i * streams * 3], &ts[i * streams], std::min(kBlock, n - i));
+        });
+    }
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: sinyalist_bench [--json file|-] [--filter text] [--min-ms ms] [--rate hz]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Suite s; const char* json = nullptr; float rate = 50.0f;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (a == "--json" && v) json = argv[++i];
+        else if (a == "--filter" && v) s.filter = argv[++i];
+        else if (a == "--min-ms" && v) s.min_ms = std::max(1.0, std::atof(argv[++i]));
+        else if (a == "--rate" && v) rate = float(std::atof(argv[++i]));
+        else return usage();
+    }
+    if (!Config::rate_supported(rate)) return usage();
+
+    const Config cfg = Config::at_rate(rate);
+    const FilterDesign& d = filter_design_for(rate);
+    // Desk noise, walking, a knock and a P-wave burst, so every state occurs.
+    const replay::Trace t = replay::synthesize(rate, 300);
+    const Inputs in = make_inputs(t, cfg);
+
+    if (json && std::string(json) == "-") s.out = stderr;
+    std::fprintf(s.out, "sinyalist_bench: %s, %.0f Hz%s\n", arch(), double(rate),
+                StageProfile::kEnabled ? " (SINYALIST_PROFILE build: detector timings include the profile)" : "");
+    bench_filters(s, in, d, cfg);
+    bench_windows(s, in, cfg);
+    bench_decision(s, in, cfg);
+    bench_states<BasicSeismicDetector<NullSink>>(s, "simd", t, cfg, false);
+    bench_states<BasicFixedSeismicDetector<NullSink>>(s, "fixed", t, cfg, false);
+    bench_states<BasicSeismicDetector<NullSink>>(s, "simd", t, cfg, true);
+    bench_states<BasicFixedSeismicDetector<NullSink>>(s, "fixed", t, cfg, true);
+    bench_bank(s, t, cfg);
+
+    if (json && !write_json(json, s, rate)) { std::fprintf(stderr, "error: cannot write %s\n", json); return 1; }
+    return 0;
+}
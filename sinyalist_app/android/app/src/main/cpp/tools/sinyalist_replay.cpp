@@ -0,0 +1,260 @@
+// =============================================================================
+// SINYALIST — sinyalist_replay (host tool)
+// =============================================================================
+// Replays recorded accelerometer traces through SeismicDetector at maximum
+// speed and reports throughput, per-component cost and detected events.
+//
+//   sinyalist_replay [options] <trace.csv|trace.srt>...
+//     --synthetic <seconds>   replay a generated test trace instead
+//     --synthetic-rate <hz>   sample rate of the generated trace (default: --rate
+//                             or 50); traces not at the detector rate are run
+//                             through the C10 resampler first
+//     --rate <hz>             detector rate, 50 | 100 | 200 (default: the one
+//                             nearest the trace rate, Config::nearest_rate)
+//     --repeat <n>            repeat each trace n times for timing (default 1)
+//     --block <n>             samples per process_block() call (default 64)
+//     --convert <out.srt>     write the (single) input trace as binary and exit
+//     --bank <streams>        also run <streams> phase-shifted copies through
+//                             DetectorBank and cross-check against the detector
+//     --threads <n>           DetectorBank worker threads (default: all cores)
+//     --mode <m>              STA/LTA windows: boxcar | recursive | both (default)
+//     --pregate               enable the C9 energy pre-gate (as on the device)
+//     --restart <seconds>     also simulate a service restart at that point via a
+//                             C14 state snapshot and compare warm/cold resumes
+//                             (fails if a second snapshot writer is not refused)
+//     --restart-gap <seconds> samples lost during the restart (default 5)
+//     --simd                  also check the C2 lane-parallel filter chain
+//                             against the per-axis scalar one
+//     --fixed                 also run the C15 fixed-point detector (boxcar) and
+//                             check its trigger decisions against float
+//     --storage <s>           also run boxcar windows with C26 compact LTA/
+//                             calibration storage: f16 | u16 | both, and check
+//                             window statistics (replay::StorageResult bounds)
+//                             and decisions against float
+//     --capture               also capture waveforms around events (C16) and
+//                             check their Steim-2 images (C17) decode to the
+//                             int16 counts of the source samples
+//     --quiet                 do not list individual events
+//
+// Built with -DSINYALIST_PROFILE=ON, the full-pipeline run also prints the
+// C20 per-stage histograms (calls, mean, p50/p99 bucket edge, max).
+// =============================================================================
+
+#include "replay_engine.hpp"
+#include <cstdlib>
+
+using namespace sinyalist;
+
+namespace {
+
+// C2: which AxisFilterChain --simd checks
+#ifdef SINYALIST_NEON
+constexpr const char* kSimdPath = "neon";
+#else
+constexpr const char* kSimdPath = "portable lanes";
+#endif
+
+const char* level_name(seismic::AlertLevel l) {
+    static const char* k[] = {"NONE", "TREMOR", "MODERATE", "SEVERE", "CRITICAL"};
+    return k[std::min<unsigned>(unsigned(l), 4)];
+}
+
+// C20: words as StageProfile::export_words(); nothing if compiled out.
+void print_profile(const uint64_t* w) {
+    if (!w[0]) return;
+    const uint64_t stages = w[0], buckets = w[1];
+    std::printf("   stage profile : clock overhead %llu ns per reading (included below)\n",
+                (unsigned long long)w[2]);
+    const uint64_t* p = w + 3;
+    for (uint64_t s = 0; s < stages; ++s, p += 3 + buckets) {
+        if (!p[0]) continue;
+        std::printf("     %-9s %10llu calls  mean %7.1f ns  p50 <%6llu ns  p99 <%7llu ns  max %8llu ns\n",
+                    seismic::kStageNames[s], (unsigned long long)p[0], double(p[1]) / double(p[0]),
+                    (unsigned long long)seismic::profile_quantile_ns(p + 3, 0.50),
+                    (unsigned long long)seismic::profile_quantile_ns(p + 3, 0.99),
+                    (unsigned long long)p[2]);
+    }
+}
+
+int usage() {
+    std::fprintf(stderr,
+        "usage: sinyalist_replay [--synthetic s] [--synthetic-rate hz] [--rate hz]\n"
+        "                        [--repeat n] [--block n]\n"
+        "                        [--convert out.srt] [--bank streams] [--threads n]\n"
+        "                        [--mode boxcar|recursive|both] [--pregate]\n"
+        "                        [--restart s] [--restart-gap s] [--simd] [--fixed]\n"
+        "                        [--storage f16|u16|both] [--capture]\n"
+        "                        [--quiet] <trace>...\n");
+    return 2;
+}
+
+replay::RunResult report(const char* name, const replay::Trace& t, const seismic::Config& cfg,
+                         size_t block, uint32_t repeat, bool quiet) {
+    replay::RunResult r = replay::run(t, cfg, block, repeat);
+    replay::ComponentTimes c = replay::time_components(t, cfg, repeat);
+    double secs = double(t.size()) / double(t.sample_rate_hz);
+    std::printf("== %s: %zu samples @ %.1f Hz (%.1f s), detector %.0f Hz, %s windows\n",
+                name, t.size(), double(t.sample_rate_hz), secs, double(cfg.sample_rate_hz),
+                cfg.window_mode == seismic::WindowMode::RECURSIVE ? "recursive" : "boxcar");
+    std::printf("   full pipeline : %8.1f ns/sample  %12.0f samples/s  (%.0fx real time)\n",
+                r.ns_per_sample(), r.samples_per_s(), r.samples_per_s() / double(t.sample_rate_hz));
+    std::printf("   filter chain  : %8.1f ns/sample\n", c.filter_ns);
+    std::printf("   windows       : %8.1f ns/sample\n", c.windows_ns);
+    std::printf("   periodicity   : %8.1f ns/sample\n", c.periodicity_ns);
+    if (cfg.pregate)
+        std::printf("   pre-gate      : %5.1f%% of samples gated, %llu wakes\n",
+                    t.size() ? 100.0 * double(r.gated) / double(t.size()) : 0.0,
+                    (unsigned long long)r.wakes);
+    print_profile(r.profile);
+    std::printf("   events        : %zu\n", r.events.size());
+    if (!quiet)
+        for (const auto& e : r.events)
+            std::printf("     t=%.2fs %-8s peak=%.4fg sta/lta=%.2f f=%.2fHz dur=%u\n",
+                        (t.size() ? double(e.time_ms - t.ts[0]) : 0.0) / 1000.0, level_name(e.level),
+                        double(e.peak_g), double(e.sta_lta), double(e.freq_hz), e.duration);
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float rate = 0, synth_rate = 0, restart = 0, restart_gap = 5; uint32_t repeat = 1, synth = 0, bank = 0; unsigned threads = 0; size_t block = 64;
+    const char* convert = nullptr; bool quiet = false, pregate = false, fixed = false, capture = false, simd = false;
+    std::vector<seismic::WindowMode> modes = {seismic::WindowMode::BOXCAR, seismic::WindowMode::RECURSIVE};
+    std::vector<seismic::WindowStorage> storages;
+    std::vector<const char*> inputs;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--quiet") quiet = true;
+        else if (a == "--pregate") pregate = true;
+        else if (a == "--fixed") fixed = true;
+        else if (a == "--simd") simd = true;
+        else if (a == "--capture") capture = true;
+        else if (a == "--synthetic" && (v = next())) synth = uint32_t(std::atoi(v));
+        else if (a == "--rate" && (v = next())) rate = float(std::atof(v));
+        else if (a == "--synthetic-rate" && (v = next())) synth_rate = float(std::atof(v));
+        else if (a == "--restart" && (v = next())) restart = float(std::atof(v));
+        else if (a == "--restart-gap" && (v = next())) restart_gap = std::max(0.0f, float(std::atof(v)));
+        else if (a == "--repeat" && (v = next())) repeat = uint32_t(std::max(1, std::atoi(v)));
+        else if (a == "--block" && (v = next())) block = size_t(std::max(1, std::atoi(v)));
+        else if (a == "--convert" && (v = next())) convert = v;
+        else if (a == "--bank" && (v = next())) bank = uint32_t(std::max(0, std::atoi(v)));
+        else if (a == "--threads" && (v = next())) threads = unsigned(std::max(0, std::atoi(v)));
+        else if (a == "--mode" && (v = next())) {
+            std::string m = v;
+            if (m == "boxcar") modes = {seismic::WindowMode::BOXCAR};
+            else if (m == "recursive") modes = {seismic::WindowMode::RECURSIVE};
+            else if (m != "both") return usage();
+        }
+        else if (a == "--storage" && (v = next())) {
+            std::string m = v;
+            if (m == "f16") storages = {seismic::WindowStorage::F16};
+            else if (m == "u16") storages = {seismic::WindowStorage::U16};
+            else if (m == "both") storages = {seismic::WindowStorage::F16, seismic::WindowStorage::U16};
+            else return usage();
+        }
+        else if (!a.empty() && a[0] != '-') inputs.push_back(argv[i]);
+        else return usage();
+    }
+    if ((inputs.empty() && !synth) || (rate != 0 && !seismic::Config::rate_supported(rate))) return usage();
+
+    std::vector<std::pair<std::string, replay::Trace>> traces;
+    if (synth) traces.emplace_back("synthetic", replay::synthesize(synth_rate > 0 ? synth_rate : rate > 0 ? rate : 50.0f, synth));
+    for (const char* p : inputs) {
+        replay::Trace t; std::string err;
+        if (!replay::load_trace(p, t, err)) { std::fprintf(stderr, "error: %s\n", err.c_str()); return 1; }
+        traces.emplace_back(p, std::move(t));
+    }
+
+    if (convert) {
+        if (traces.size() != 1) { std::fprintf(stderr, "error: --convert takes one trace\n"); return 2; }
+        std::string err;
+        if (!replay::save_binary(convert, traces[0].second, err)) {
+            std::fprintf(stderr, "error: %s\n", err.c_str()); return 1;
+        }
+        std::printf("wrote %s (%zu samples)\n", convert, traces[0].second.size());
+        return 0;
+    }
+
+    for (auto& [name, t] : traces) {
+        float hz = rate > 0 ? rate : seismic::Config::nearest_rate(t.sample_rate_hz);
+        if (std::abs(t.sample_rate_hz / hz - 1.0f) > 0.01f) {
+            double ns = 0; size_t in = t.size();
+            t = replay::resample(t, hz, &ns);
+            std::printf("== %s: resampled %zu samples -> %zu @ %.0f Hz, %.1f ns/input sample\n",
+                        name.c_str(), in, t.size(), double(hz), in ? ns / double(in) : 0.0);
+        }
+    }
+
+    for (const auto& [name, t] : traces) for (seismic::WindowMode mode : modes) {
+        seismic::Config cfg = seismic::Config::at_rate(rate > 0 ? rate : seismic::Config::nearest_rate(t.sample_rate_hz));
+        cfg.window_mode = mode; cfg.pregate = pregate;
+        replay::RunResult ref = report(name.c_str(), t, cfg, block, repeat, quiet);
+        if (simd && mode == modes.front()) {
+            replay::FilterCheck f = replay::compare_filter_chain(t, cfg);
+            std::printf("   simd filter   : %s, %llu/%llu samples identical to scalar, max error %.1e g (limit %.0e)\n",
+                        kSimdPath, (unsigned long long)f.exact, (unsigned long long)f.samples,
+                        f.max_err_g, replay::FilterCheck::kTolG);
+            if (!f.ok()) return 1;
+        }
+        if (fixed && mode == seismic::WindowMode::BOXCAR) {
+            replay::RunResult f = replay::run<seismic::FixedMath>(t, cfg, block, repeat);
+            bool same = replay::same_decisions(ref.events, f.events, cfg.sample_rate_hz);
+            std::printf("   fixed point   : %8.1f ns/sample  %zu events, decisions %s float\n",
+                        f.ns_per_sample(), f.events.size(), same ? "match" : "DIFFER from");
+            if (!same) return 1;
+        }
+        if (mode == seismic::WindowMode::BOXCAR) for (seismic::WindowStorage st : storages) {
+            seismic::Config sc = cfg; sc.window_storage = st;
+            replay::StorageResult x = replay::compare_storage(t, sc, block, repeat);
+            bool same = replay::same_decisions(ref.events, x.run.events, cfg.sample_rate_hz);
+            std::printf("   %s windows   : %8.1f ns/sample (rings), %.0f KB vs %.0f KB float,"
+                        " max error LTA %.1e var %.1e (float %.1e / %.1e),"
+                        " %zu events, decisions %s float\n",
+                        st == seismic::WindowStorage::F16 ? "f16" : "u16", x.windows_ns,
+                        double(x.bytes) / 1024.0, double(x.float_bytes) / 1024.0,
+                        x.lta_err, x.var_err, x.lta_err_f32, x.var_err_f32,
+                        x.run.events.size(), same ? "match" : "DIFFER from");
+            if (!x.quality_ok()) std::printf("   %s windows   : window statistics out of tolerance\n",
+                                             st == seismic::WindowStorage::F16 ? "f16" : "u16");
+            if (!same || !x.quality_ok()) return 1;
+            if (bank) {
+                replay::BankResult b = replay::run_bank(t, sc, bank, threads);
+                std::printf("   bank x%u %s  : %8.2f ns/stream-sample, %.1f MB state, %u/%u streams match detector\n",
+                            bank, st == seismic::WindowStorage::F16 ? "f16" : "u16", b.ns_per_stream_sample(),
+                            double(b.bytes) / 1048576.0, b.verified - b.mismatches, b.verified);
+                if (b.mismatches) return 1;
+            }
+        }
+        if (bank) {
+            replay::BankResult b = replay::run_bank(t, cfg, bank, threads);
+            std::printf("   bank x%u      : %8.2f ns/stream-sample on %u threads, %.1f MB state,"
+                        " %zu events, %u/%u streams match detector\n",
+                        bank, b.ns_per_stream_sample(), b.threads, double(b.bytes) / 1048576.0,
+                        b.events, b.verified - b.mismatches, b.verified);
+            if (b.mismatches) return 1;
+        }
+        if (capture) {
+            replay::CaptureResult x = replay::run_capture(t, cfg);
+            std::printf("   capture       : %u waveforms, %u/%u decode to the source counts,"
+                        " %.1f KB float -> %.1f KB Steim-2 (%.1fx), max error %.2e g (half a count %.2e g)\n",
+                        x.captures, x.verified, x.captures, double(x.float_bytes) / 1024.0,
+                        double(x.packed_bytes) / 1024.0,
+                        x.packed_bytes ? double(x.float_bytes) / double(x.packed_bytes) : 0.0,
+                        x.max_err_g, 0.5 / double(seismic::kCountsPerG));
+            if (x.verified != x.captures) return 1;
+        }
+        if (restart > 0) {
+            replay::RestartResult x = replay::run_restart(t, cfg, restart, restart_gap);
+            std::printf("   restart @%.0fs : %zu-byte snapshot, %s, second writer %s; events after resume: "
+                        "uninterrupted %zu, warm %zu%s, cold %zu\n",
+                        double(restart), x.bytes, x.restored ? "restored" : "NOT restored",
+                        x.exclusive ? "refused" : "NOT refused",
+                        x.full, x.warm, x.match ? " (identical)" : "", x.cold);
+            if (!x.exclusive) return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,370 @@
+// =============================================================================
+// SINYALIST — sinyalist_sweep (host tool)
+// =============================================================================
+// Config tuning over a labelled trace corpus: every Config variant of a grid
+// (or a random sample of it) is replayed over every trace, and the result is
+// a detection / false-alarm curve instead of guesswork.
+//
+// Each trace is decoded once. SRT1 traces at the detector rate are mmap'd
+// read-only; CSV and off-rate traces are converted once (C10 resampler) and
+// shared from memory, or from --cache as SRT1 files for the next run. The
+// (variant, trace) pairs go to the ThreadPool longest trace first, so its
+// shared counter keeps every core busy to the end.
+//
+//   corpus file: one trace per line, '#' comments, paths relative to it
+//     <label> <trace.csv|trace.srt> [onset_s]
+//   label "quake" is a positive: detected if an alarm starts in
+//   [onset - 5 s, onset + 60 s] (anywhere without onset_s; other alarms in
+//   it are false). Every other label (walking, car, elevator, drop, ...) is
+//   a negative class and each of its alarms is false.
+//
+//   sinyalist_sweep [options] <corpus>
+//     --vary <param>=<lo>:<hi>:<step>   grid axis (repeatable), or
+//     --vary <param>=<v1>,<v2>,...      explicit values
+//     --random <n>        n variants drawn uniformly from the --vary axes
+//                         instead of the full grid
+//     --seed <n>          for --random (default 1)
+//     --rate <hz>         detector rate, 50 | 100 | 200 (default 50)
+//     --mode <m>          STA/LTA windows: boxcar (default) | recursive
+//     --fixed             run the C15 fixed-point detector (boxcar)
+//     --storage <s>       C26 LTA/calibration ring storage: f32 (default) |
+//                         f16 | u16, to compare fronts against float
+//     --min-level <n>     ignore alarms below this AlertLevel (default 1)
+//     --threads <n>       worker threads (default: all cores)
+//     --cache <dir>       keep converted traces here as SRT1, reused while
+//                         newer than their source
+//     --csv <file|->      one row per variant: parameters, detections,
+//                         false alarms per class, detection rate, alarms/h
+//
+// params: sta_lta_trigger, sta_lta_detrigger, adaptive_trig_min,
+// adaptive_trig_max, min_sustained (samples), axis_coherence_min,
+// periodicity_thresh, min_amplitude_g. Unvaried ones keep
+// Config::at_rate(rate). Stdout gets the Pareto front: the variants that no
+// other variant beats on both detection rate and false alarms.
+// =============================================================================
+
+#include "replay_engine.hpp"
+#include <cstdlib>
+#include <map>
+
+using namespace sinyalist;
+
+namespace {
+
+struct Param { const char* name; float seismic::Config::* f; uint32_t seismic::Config::* u; };
+const Param kParams[] = {
+    {"sta_lta_trigger",    &seismic::Config::sta_lta_trigger,    nullptr},
+    {"sta_lta_detrigger",  &seismic::Config::sta_lta_detrigger,  nullptr},
+    {"adaptive_trig_min",  &seismic::Config::adaptive_trig_min,  nullptr},
+    {"adaptive_trig_max",  &seismic::Config::adaptive_trig_max,  nullptr},
+    {"min_sustained",      nullptr, &seismic::Config::min_sustained},
+    {"axis_coherence_min", &seismic::Config::axis_coherence_min, nullptr},
+    {"periodicity_thresh", &seismic::Config::periodicity_thresh, nullptr},
+    {"min_amplitude_g",    &seismic::Config::min_amplitude_g,    nullptr},
+};
+
+struct Axis { const Param* p; std::vector<float> values; float lo, hi; bool range; };
+
+void set(seismic::Config& c, const Param& p, float v) {
+    if (p.f) c.*(p.f) = v;
+    else c.*(p.u) = uint32_t(std::max(1.0f, std::round(v)));
+}
+float get(const seismic::Config& c, const Param& p) { return p.f ? c.*(p.f) : float(c.*(p.u)); }
+
+bool parse_axis(const char* spec, Axis& a) {
+    std::string s = spec;
+    size_t eq = s.find('=');
+    if (eq == std::string::npos) return false;
+    a.p = nullptr;
+    for (const Param& p : kParams) if (s.compare(0, eq, p.name) == 0 && std::strlen(p.name) == eq) a.p = &p;
+    if (!a.p) return false;
+    std::string v = s.substr(eq + 1);
+    float lo, hi, step;
+    if (std::sscanf(v.c_str(), "%f:%f:%f", &lo, &hi, &step) == 3) {
+        if (step <= 0 || hi < lo) return false;
+        a.range = true; a.lo = lo; a.hi = hi;
+        for (int k = 0; lo + float(k) * step <= hi + step * 1e-3f; ++k) a.values.push_back(lo + float(k) * step);
+    } else {
+        a.range = false;
+        for (const char* p = v.c_str(); *p; ) {
+            char* end; float x = std::strtof(p, &end);
+            if (end == p) return false;
+            a.values.push_back(x);
+            p = *end == ',' ? end + 1 : end;
+        }
+        if (a.values.empty()) return false;
+        a.lo = *std::min_element(a.values.begin(), a.values.end());
+        a.hi = *std::max_element(a.values.begin(), a.values.end());
+    }
+    return true;
+}
+
+struct Labelled { std::string label, path; float onset_s; replay::TraceImage img; };
+
+// One alarm per onset: the detector reports a trigger and its detrigger
+// with the same onset time.
+struct AlarmSink {
+    static constexpr bool kTelemetry = false;
+    uint8_t min_level = 1;
+    uint64_t last = ~0ull;
+    std::vector<uint64_t>* onsets = nullptr;
+    void event(const seismic::SeismicEvent& e) {
+        if (uint8_t(e.level) < min_level || e.time_ms == last) return;
+        last = e.time_ms; onsets->push_back(e.time_ms);
+    }
+    void debug(const seismic::DebugTelemetry&) noexcept {}
+    bool wants_debug() const noexcept { return false; }
+};
+
+template<class Math>
+void replay_image(const replay::TraceImage& t, const seismic::Config& cfg, uint8_t min_level,
+                  std::vector<uint64_t>& onsets) {
+    constexpr size_t kBlock = 64;
+    seismic::BasicSeismicDetector<AlarmSink, Math> det(AlarmSink{min_level, ~0ull, &onsets});
+    det.update_config(cfg);
+    uint64_t ts[kBlock];
+    for (size_t i = 0; i < t.size(); i += kBlock) {
+        size_t m = std::min(kBlock, t.size() - i);
+        for (size_t k = 0; k < m; ++k) ts[k] = t.t0() + t.dt()[i + k];
+        det.process_block(t.xyz() + 3 * i, ts, m);
+    }
+}
+
+struct Cell { uint32_t false_alarms = 0; bool detected = false; };
+
+bool newer(const char* a, const char* b) {
+    struct stat sa, sb;
+    return stat(a, &sa) == 0 && stat(b, &sb) == 0 && sa.st_mtime >= sb.st_mtime;
+}
+
+// Decodes once: maps SRT1 traces at the detector rate, converts the rest.
+bool load(Labelled& l, float rate, const char* cache, std::string& err) {
+    std::string cached;
+    if (cache) {
+        std::string base = l.path.substr(l.path.find_last_of('/') + 1);
+        cached = std::string(cache) + "/" + base + "." + std::to_string(int(rate)) + "hz.srt";
+        if (newer(cached.c_str(), l.path.c_str()) && l.img.map(cached.c_str(), err)) return true;
+    }
+    if (l.img.map(l.path.c_str(), err) && std::abs(l.img.sample_rate_hz() / rate - 1.0f) <= 0.01f) return true;
+    replay::Trace t;
+    if (!replay::load_trace(l.path.c_str(), t, err)) return false;
+    if (std::abs(t.sample_rate_hz / rate - 1.0f) > 0.01f) t = replay::resample(t, rate);
+    if (cache && replay::save_binary(cached.c_str(), t, err) && l.img.map(cached.c_str(), err)) return true;
+    l.img.adopt(t);
+    return true;
+}
+
+bool read_corpus(const char* path, std::vector<Labelled>& out, std::string& err) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) { err = std::string("cannot open ") + path; return false; }
+    std::string dir = path;
+    dir = dir.find('/') == std::string::npos ? "" : dir.substr(0, dir.find_last_of('/') + 1);
+    char line[1024];
+    while (std::fgets(line, sizeof line, f)) {
+        char label[64], file[900]; float onset = -1;
+        if (line[0] == '#' || std::sscanf(line, "%63s %899s %f", label, file, &onset) < 2) continue;
+        Labelled l;
+        l.label = label; l.onset_s = onset;
+        l.path = file[0] == '/' ? file : dir + file;
+        out.push_back(std::move(l));
+    }
+    std::fclose(f);
+    if (out.empty()) { err = std::string("no traces in ") + path; return false; }
+    return true;
+}
+
+int usage() {
+    std::fprintf(stderr,
+        "usage: sinyalist_sweep [--vary param=lo:hi:step|param=v1,v2,...]... [--random n]\n"
+        "                       [--seed n] [--rate hz] [--mode boxcar|recursive] [--fixed]\n"
+        "                       [--storage f32|f16|u16]\n"
+        "                       [--min-level n] [--threads n] [--cache dir] [--csv file|-]\n"
+        "                       <corpus>\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    float rate = 50; uint32_t random = 0, seed = 1; unsigned threads = 0; uint8_t min_level = 1;
+    bool fixed = false; seismic::WindowMode mode = seismic::WindowMode::BOXCAR;
+    seismic::WindowStorage storage = seismic::WindowStorage::F32;
+    const char* cache = nullptr; const char* csv = nullptr; const char* corpus = nullptr;
+    std::vector<Axis> axes;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--fixed") fixed = true;
+        else if (a == "--vary" && (v = next())) {
+            Axis x;
+            if (!parse_axis(v, x)) { std::fprintf(stderr, "error: bad --vary %s\n", v); return 2; }
+            axes.push_back(std::move(x));
+        }
+        else if (a == "--random" && (v = next())) random = uint32_t(std::max(0, std::atoi(v)));
+        else if (a == "--seed" && (v = next())) seed = uint32_t(std::atoi(v));
+        else if (a == "--rate" && (v = next())) rate = float(std::atof(v));
+        else if (a == "--min-level" && (v = next())) min_level = uint8_t(std::clamp(std::atoi(v), 1, 4));
+        else if (a == "--threads" && (v = next())) threads = unsigned(std::max(0, std::atoi(v)));
+        else if (a == "--cache" && (v = next())) cache = v;
+        else if (a == "--csv" && (v = next())) csv = v;
+        else if (a == "--mode" && (v = next())) {
+            std::string m = v;
+            if (m == "boxcar") mode = seismic::WindowMode::BOXCAR;
+            else if (m == "recursive") mode = seismic::WindowMode::RECURSIVE;
+            else return usage();
+        }
+        else if (a == "--storage" && (v = next())) {
+            std::string m = v;
+            if (m == "f32") storage = seismic::WindowStorage::F32;
+            else if (m == "f16") storage = seismic::WindowStorage::F16;
+            else if (m == "u16") storage = seismic::WindowStorage::U16;
+            else return usage();
+        }
+        else if (!a.empty() && a[0] != '-' && !corpus) corpus = argv[i];
+        else return usage();
+    }
+    if (!corpus || !seismic::Config::rate_supported(rate)) return usage();
+    if (fixed && mode != seismic::WindowMode::BOXCAR) {
+        std::fprintf(stderr, "error: --fixed runs boxcar windows only\n"); return 2;
+    }
+    FILE* table = csv && std::string(csv) == "-" ? stderr : stdout;
+
+    // Variants: the full grid, or `random` draws over the axes
+    seismic::Config base = seismic::Config::at_rate(rate);
+    base.window_mode = mode; base.window_storage = storage;
+    std::vector<seismic::Config> variants;
+    if (random) {
+        std::mt19937 rng(seed);
+        for (uint32_t k = 0; k < random; ++k) {
+            seismic::Config c = base;
+            for (const Axis& x : axes) {
+                float v = x.range ? std::uniform_real_distribution<float>(x.lo, x.hi)(rng)
+                                  : x.values[std::uniform_int_distribution<size_t>(0, x.values.size() - 1)(rng)];
+                set(c, *x.p, v);
+            }
+            variants.push_back(c);
+        }
+    } else {
+        variants.push_back(base);
+        for (const Axis& x : axes) {
+            std::vector<seismic::Config> grown;
+            grown.reserve(variants.size() * x.values.size());
+            for (const seismic::Config& c : variants) for (float v : x.values) { grown.push_back(c); set(grown.back(), *x.p, v); }
+            variants.swap(grown);
+        }
+    }
+
+    std::vector<Labelled> traces;
+    std::string err;
+    if (!read_corpus(corpus, traces, err)) { std::fprintf(stderr, "error: %s\n", err.c_str()); return 1; }
+    auto l0 = replay::Clock::now();
+    double hours = 0; size_t mapped = 0;
+    std::map<std::string, double> class_hours;
+    for (Labelled& l : traces) {
+        if (!load(l, rate, cache, err)) { std::fprintf(stderr, "error: %s\n", err.c_str()); return 1; }
+        hours += l.img.seconds() / 3600.0; class_hours[l.label] += l.img.seconds() / 3600.0;
+        mapped += l.img.mapped();
+    }
+    double load_s = replay::elapsed_ns(l0, replay::Clock::now()) * 1e-9;
+    std::sort(traces.begin(), traces.end(), [](const Labelled& a, const Labelled& b) { return a.img.size() > b.img.size(); });
+
+    uint32_t quakes = 0;
+    std::vector<std::string> classes;
+    for (const Labelled& l : traces) {
+        if (l.label == "quake") ++quakes;
+        if (std::find(classes.begin(), classes.end(), l.label) == classes.end()) classes.push_back(l.label);
+    }
+    std::sort(classes.begin(), classes.end());
+
+    const uint32_t nv = uint32_t(variants.size()), nt = uint32_t(traces.size());
+    if (uint64_t(nv) * nt > UINT32_MAX) { std::fprintf(stderr, "error: too many variant x trace pairs\n"); return 2; }
+    static const char* kStorage[] = {"", " f16", " u16"};
+    std::fprintf(table, "== %u traces (%.1f h, %zu mapped in place, loaded in %.1f s), %u variants, %s%s%s windows @ %.0f Hz\n",
+                 nt, hours, mapped, load_s, nv, fixed ? "fixed-point " : "",
+                 mode == seismic::WindowMode::RECURSIVE ? "recursive" : "boxcar",
+                 fixed || mode == seismic::WindowMode::RECURSIVE ? "" : kStorage[size_t(storage)], double(rate));
+
+    // Trace-major, longest first: a trace's pages stay hot across its variants
+    std::vector<Cell> cells(size_t(nv) * nt);
+    ThreadPool pool(threads);
+    auto s0 = replay::Clock::now();
+    pool.parallel_for(nv * nt, [&](uint32_t i) {
+        const uint32_t ti = i / nv, vi = i % nv;
+        const Labelled& l = traces[ti];
+        std::vector<uint64_t> onsets;
+        if (fixed) replay_image<seismic::FixedMath>(l.img, variants[vi], min_level, onsets);
+        else replay_image<seismic::FloatMath>(l.img, variants[vi], min_level, onsets);
+        Cell& c = cells[size_t(vi) * nt + ti];
+        const bool positive = l.label == "quake";
+        const uint64_t on = l.img.t0() + uint64_t(std::max(0.0f, l.onset_s) * 1000.0f);
+        for (uint64_t t : onsets) {
+            bool hit = positive && (l.onset_s < 0 || (t + 5000 >= on && t <= on + 60000));
+            if (hit) c.detected = true; else ++c.false_alarms;
+        }
+    });
+    double sweep_s = replay::elapsed_ns(s0, replay::Clock::now()) * 1e-9;
+    double replayed_h = hours * nv;
+    std::fprintf(table, "   sweep         : %.1f s on %u threads, %.0f trace-hours (%.0fx real time)\n",
+                 sweep_s, pool.size(), replayed_h, sweep_s > 0 ? replayed_h * 3600.0 / sweep_s : 0.0);
+
+    struct Score { uint32_t detected = 0, false_alarms = 0; std::vector<uint32_t> per_class; };
+    std::vector<Score> scores(nv);
+    for (uint32_t v = 0; v < nv; ++v) {
+        Score& s = scores[v];
+        s.per_class.assign(classes.size(), 0);
+        for (uint32_t t = 0; t < nt; ++t) {
+            const Cell& c = cells[size_t(v) * nt + t];
+            s.detected += c.detected; s.false_alarms += c.false_alarms;
+            s.per_class[size_t(std::find(classes.begin(), classes.end(), traces[t].label) - classes.begin())] += c.false_alarms;
+        }
+    }
+    auto pd = [&](const Score& s) { return quakes ? double(s.detected) / double(quakes) : 0.0; };
+    auto fa_h = [&](const Score& s) { return hours > 0 ? double(s.false_alarms) / hours : 0.0; };
+    auto params = [&](const seismic::Config& c) {
+        std::string o;
+        for (const Axis& x : axes) {
+            char b[64]; std::snprintf(b, sizeof b, "%s%s=%g", o.empty() ? "" : " ", x.p->name, double(get(c, *x.p)));
+            o += b;
+        }
+        return o.empty() ? std::string("(defaults)") : o;
+    };
+
+    // Pareto front, fewest false alarms first
+    std::vector<uint32_t> order(nv);
+    for (uint32_t v = 0; v < nv; ++v) order[v] = v;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        const Score &x = scores[a], &y = scores[b];
+        return x.false_alarms != y.false_alarms ? x.false_alarms < y.false_alarms : x.detected > y.detected;
+    });
+    std::fprintf(table, "   detection / false-alarm front (%u quakes; alarms per class:", quakes);
+    for (const std::string& c : classes) std::fprintf(table, " %s %.1fh", c.c_str(), class_hours[c]);
+    std::fprintf(table, ")\n");
+    int32_t best = -1;
+    for (uint32_t v : order) {
+        const Score& s = scores[v];
+        if (int32_t(s.detected) <= best) continue;
+        best = int32_t(s.detected);
+        std::fprintf(table, "     pd %5.1f%%  %6.2f alarms/h  [", 100.0 * pd(s), fa_h(s));
+        for (size_t k = 0; k < classes.size(); ++k) std::fprintf(table, "%s%u", k ? " " : "", s.per_class[k]);
+        std::fprintf(table, "]  %s\n", params(variants[v]).c_str());
+    }
+
+    if (csv) {
+        FILE* f = std::string(csv) == "-" ? stdout : std::fopen(csv, "w");
+        if (!f) { std::fprintf(stderr, "error: cannot create %s\n", csv); return 1; }
+        for (const Param& p : kParams) std::fprintf(f, "%s,", p.name);
+        std::fprintf(f, "detected,quakes,false_alarms");
+        for (const std::string& c : classes) std::fprintf(f, ",fa_%s", c.c_str());
+        std::fprintf(f, ",pd,alarms_per_h\n");
+        for (uint32_t v = 0; v < nv; ++v) {
+            const Score& s = scores[v];
+            for (const Param& p : kParams) std::fprintf(f, "%g,", double(get(variants[v], p)));
+            std::fprintf(f, "%u,%u,%u", s.detected, quakes, s.false_alarms);
+            for (uint32_t n : s.per_class) std::fprintf(f, ",%u", n);
+            std::fprintf(f, ",%.4f,%.4f\n", pd(s), fa_h(s));
+        }
+        if (f != stdout && std::fclose(f) != 0) { std::fprintf(stderr, "error: write failed: %s\n", csv); return 1; }
+    }
+    return 0;
+}
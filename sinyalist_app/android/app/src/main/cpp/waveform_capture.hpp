@@ -0,0 +1,214 @@
+// =============================================================================
+// SINYALIST — WaveformCapture: pre/post-trigger raw xyz around each event
+// =============================================================================
+// C16: A SeismicEvent only carries scalars. WaveformCapture keeps the last
+// few seconds of raw input in a ring and, when the detector declares a
+// trigger, freezes the pre-trigger seconds plus everything up to the
+// detrigger into a slot of a preallocated arena:
+//
+//   slot:   header (48 B) | samples × (x, y, z f32), raw input in g
+//   header: magic u32 | version u32 | samples u32 | pre u32 (samples before
+//           onset) | first_ms u64 | onset_ms u64 | sample_rate f32 |
+//           level u8 | complete u8 (0 = truncated at slot capacity) | pad[2] |
+//           peak_g f32 | duration u32
+//
+// All memory is allocated by configure(); the sensor thread only copies.
+// Slots move FREE → FILLING (sensor thread) → READY → READING (consumer) →
+// FREE through one atomic each, so one producer and one consumer share the
+// arena without locks; a trigger finding no FREE slot is counted as dropped.
+// A READY slot stays valid and unchanged until the consumer release()s it.
+//
+// C17: the consumer hands a capture on as pack(): the same header with
+// version 2, then the samples as a Steim-2 waveform image (steim2.hpp)
+// instead of floats. The image is exact over int16 counts; from the float
+// input it is quantised to 1/counts_per_g (0.49 mg at 2048 counts/g).
+// =============================================================================
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "steim2.hpp"
+
+namespace sinyalist::seismic {
+
+class WaveformCapture {
+public:
+    static constexpr uint32_t kMagic = 0x31465753;   // "SWF1"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kVersionPacked = 2;   // C17: pack() output
+    struct Header {
+        uint32_t magic, version, samples, pre;
+        uint64_t first_ms, onset_ms;
+        float sample_rate_hz; uint8_t level, complete, pad[2];
+        float peak_g; uint32_t duration;
+    };
+    static_assert(sizeof(Header) == 48, "waveform header layout is shared with Kotlin");
+
+    // A READY slot handed to the consumer: `bytes` of header + samples at data.
+    struct View {
+        const void* data = nullptr; size_t bytes = 0; uint32_t slot = 0;
+        const Header& header() const noexcept { return *static_cast<const Header*>(data); }
+        const float* xyz() const noexcept {
+            return reinterpret_cast<const float*>(static_cast<const uint8_t*>(data) + sizeof(Header));
+        }
+    };
+
+    WaveformCapture() = default;
+    WaveformCapture(const WaveformCapture&) = delete;
+    WaveformCapture& operator=(const WaveformCapture&) = delete;
+
+    // Allocates `slots` slots of pre + post samples at fs. The onset may lie
+    // up to `pre` samples before the trigger is declared (the confirmation
+    // window), so the ring keeps pre + pre. Not concurrent with anything.
+    void configure(float fs, uint32_t slots, uint32_t pre, uint32_t post) {
+        fs_ = fs; nslots_ = std::max(slots, 1u); pre_ = pre; max_ = std::max(pre + post, 1u);
+        cap_ = 1; while (cap_ < 2 * pre_ || cap_ < 2) cap_ <<= 1;
+        rxyz_.reset(new float[size_t(cap_) * 3]);
+        rts_.reset(new uint64_t[cap_]);
+        slot_bytes_ = (sizeof(Header) + size_t(max_) * 12 + 63) & ~size_t(63);
+        arena_.reset(new uint8_t[size_t(nslots_) * slot_bytes_]);
+        state_.reset(new std::atomic<uint32_t>[nslots_]);
+        seq_.reset(new uint64_t[nslots_]);
+        for (uint32_t i = 0; i < nslots_; ++i) { state_[i].store(FREE); seq_[i] = 0; }
+        written_ = 0; next_seq_ = 0; mode_ = IDLE; dropped_.store(0); published_.store(0);
+    }
+
+    bool configured() const noexcept { return arena_ != nullptr; }
+    size_t slot_bytes() const noexcept { return slot_bytes_; }
+    // C17: room pack() needs for the largest capture.
+    size_t packed_bytes() const noexcept {
+        return sizeof(Header) + sizeof(PackedWaveformHeader) + 3 * steim2_max_bytes(max_);
+    }
+
+    // --- Sensor thread ---
+
+    void push(float x, float y, float z, uint64_t ts) noexcept {
+        if (!arena_) return;
+        uint32_t i = uint32_t(written_) & (cap_ - 1);
+        rxyz_[3*i] = x; rxyz_[3*i+1] = y; rxyz_[3*i+2] = z; rts_[i] = ts;
+        ++written_;
+        if (mode_ == RECORDING) {
+            Header& h = hdr(cur_);
+            std::memcpy(samples(cur_) + size_t(h.samples) * 3, &rxyz_[3*i], 12);
+            if (++h.samples == max_) { publish(0); mode_ = SKIPPING; }
+        }
+    }
+
+    // Every detector event: the first for an onset starts a capture, the one
+    // with the same onset after it (detrigger) completes it.
+    void on_event(uint64_t onset_ms, uint8_t level, float peak_g, uint32_t duration) noexcept {
+        if (!arena_) return;
+        if (mode_ != IDLE && onset_ms == onset_) {
+            if (mode_ == RECORDING) {
+                Header& h = hdr(cur_);
+                h.level = level; h.peak_g = peak_g; h.duration = duration;
+                publish(1);
+            }
+            mode_ = IDLE;
+            return;
+        }
+        if (mode_ == RECORDING) publish(0);     // new onset without a detrigger
+        begin(onset_ms, level, peak_g, duration);
+    }
+
+    // Detector reset: a capture in progress is abandoned.
+    void abort() noexcept {
+        if (mode_ == RECORDING) state_[cur_].store(FREE, std::memory_order_relaxed);
+        mode_ = IDLE;
+    }
+
+    // Slots published since configure(); a change means acquire() has work.
+    uint32_t published() const noexcept { return published_.load(std::memory_order_relaxed); }
+    uint32_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    // --- Consumer thread ---
+
+    // Oldest READY slot, if any; it stays valid until release(v).
+    bool acquire(View& v) noexcept {
+        uint32_t best = nslots_;
+        for (uint32_t i = 0; i < nslots_; ++i)
+            if (state_[i].load(std::memory_order_acquire) == READY && (best == nslots_ || seq_[i] < seq_[best]))
+                best = i;
+        if (best == nslots_) return false;
+        state_[best].store(READING, std::memory_order_relaxed);
+        v.data = slot(best); v.slot = best;
+        v.bytes = sizeof(Header) + size_t(hdr(best).samples) * 12;
+        return true;
+    }
+
+    void release(const View& v) noexcept {
+        if (v.slot < nslots_) state_[v.slot].store(FREE, std::memory_order_release);
+    }
+
+    // C17: an acquired capture as header (version 2) + Steim-2 image; returns
+    // the size, or 0 if it does not fit in cap or has no samples.
+    static size_t pack(const View& v, uint8_t* out, size_t cap,
+                       float counts_per_g = kCountsPerG) noexcept {
+        if (!out || cap < sizeof(Header)) return 0;
+        Header h = v.header();
+        h.version = kVersionPacked;
+        size_t b = pack_waveform(v.xyz(), h.samples, counts_per_g, out + sizeof(Header), cap - sizeof(Header));
+        if (!b) return 0;
+        std::memcpy(out, &h, sizeof(h));
+        return sizeof(Header) + b;
+    }
+
+private:
+    enum : uint32_t { FREE, FILLING, READY, READING };
+    enum Mode : uint8_t { IDLE, RECORDING, SKIPPING };   // SKIPPING: wait for the detrigger
+
+    float fs_ = 0;
+    uint32_t nslots_ = 0, pre_ = 0, max_ = 0, cap_ = 0, cur_ = 0;
+    size_t slot_bytes_ = 0;
+    std::unique_ptr<float[]> rxyz_;
+    std::unique_ptr<uint64_t[]> rts_;
+    std::unique_ptr<uint8_t[]> arena_;
+    std::unique_ptr<std::atomic<uint32_t>[]> state_;
+    std::unique_ptr<uint64_t[]> seq_;            // publish order, read after an acquire load
+    uint64_t written_ = 0, next_seq_ = 0, onset_ = 0;
+    Mode mode_ = IDLE;
+    std::atomic<uint32_t> dropped_{0}, published_{0};
+
+    uint8_t* slot(uint32_t s) const noexcept { return arena_.get() + size_t(s) * slot_bytes_; }
+    Header& hdr(uint32_t s) const noexcept { return *reinterpret_cast<Header*>(slot(s)); }
+    float* samples(uint32_t s) const noexcept { return reinterpret_cast<float*>(slot(s) + sizeof(Header)); }
+
+    // Copies the ring from `pre` samples before the onset up to now.
+    void begin(uint64_t onset_ms, uint8_t level, float peak_g, uint32_t duration) noexcept {
+        onset_ = onset_ms; mode_ = SKIPPING;
+        uint32_t s = 0;
+        while (s < nslots_ && state_[s].load(std::memory_order_acquire) != FREE) ++s;
+        if (s == nslots_) { dropped_.fetch_add(1, std::memory_order_relaxed); return; }
+        state_[s].store(FILLING, std::memory_order_relaxed);
+        cur_ = s; mode_ = RECORDING;
+
+        uint32_t have = uint32_t(std::min<uint64_t>(written_, cap_)), lead = 0;
+        while (lead < have && rts_[uint32_t(written_ - 1 - lead) & (cap_ - 1)] >= onset_ms) ++lead;
+        uint32_t n = std::min({lead + std::min(pre_, have - lead), have, max_});
+        uint64_t from = written_ - n;
+        float* dst = samples(s);
+        for (uint32_t k = 0; k < n;) {                 // ≤2 contiguous runs
+            uint32_t i = uint32_t(from + k) & (cap_ - 1), run = std::min(n - k, cap_ - i);
+            std::memcpy(dst + size_t(k) * 3, &rxyz_[3*i], size_t(run) * 12);
+            k += run;
+        }
+        Header& h = hdr(s);
+        h = Header{kMagic, kVersion, n, n > lead ? n - lead : 0,
+                   n ? rts_[uint32_t(from) & (cap_ - 1)] : onset_ms, onset_ms,
+                   fs_, level, 0, {}, peak_g, duration};
+        if (n == max_) { publish(0); mode_ = SKIPPING; }
+    }
+
+    void publish(uint8_t complete) noexcept {
+        hdr(cur_).complete = complete;
+        seq_[cur_] = next_seq_++;
+        state_[cur_].store(READY, std::memory_order_release);
+        published_.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+} // namespace sinyalist::seismic
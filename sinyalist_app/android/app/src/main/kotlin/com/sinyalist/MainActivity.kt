@@ -37,11 +37,16 @@ class MainActivity : FlutterActivity() {
         val messenger = flutterEngine.dartExecutor.binaryMessenger
 
         // --- Seismic MethodChannel ---
-        MethodChannel(messenger, "com.sinyalist/seismic").setMethodCallHandler { call, result ->
+        val seismicChannel = MethodChannel(messenger, "com.sinyalist/seismic")
+        seismicChannel.setMethodCallHandler { call, result ->
             val response = seismicEngine.handleMethodCall(call.method, call.arguments)
             if (response != null) result.success(response)
             else result.notImplemented()
         }
+        // C18: Dart unbinds its dart:ffi handle before the detector goes away
+        seismicEngine.onNativeClosing = { ffiHandle ->
+            seismicChannel.invokeMethod("nativeHandleClosing", ffiHandle)
+        }
 
         // --- Seismic EventChannel (stream of SeismicEvent) ---
         EventChannel(messenger, "com.sinyalist/seismic_events").setStreamHandler(
@@ -0,0 +1,37 @@
+// =============================================================================
+// SINYALIST — SeismicConfig (per-instance detector parameters)
+// =============================================================================
+// Passed to nativeCreate() as a FloatArray; the order of toArray() must match
+// ConfigIndex (CFG_*) in seismic_detector.hpp. Windows, cooldown and filter
+// design are derived natively from sampleRateHz (Config::at_rate).
+// =============================================================================
+
+package com.sinyalist.core
+
+data class SeismicConfig(
+    val sampleRateHz: Float = 50.0f,
+    val staLtaTrigger: Float = 4.5f,
+    val staLtaDetrigger: Float = 1.5f,
+    val minAmplitudeG: Float = 0.012f,
+    val axisCoherenceMin: Float = 0.4f,
+    val periodicityThresh: Float = 0.6f,
+    val adaptiveTrigMin: Float = 3.5f,
+    val adaptiveTrigMax: Float = 8.0f,
+    val pwaveFreqMinHz: Float = 1.0f,
+    val pwaveFreqMaxHz: Float = 15.0f,
+    val recursiveWindows: Boolean = false,
+    val pregate: Boolean = false,          // C9: opt-in energy pre-gate
+    val windowStorage: Int = WINDOW_F32,   // LTA/calibration ring samples (boxcar only)
+) {
+    companion object {
+        const val WINDOW_F32 = 0
+        const val WINDOW_F16 = 1       // half the memory, ~3 digits
+        const val WINDOW_U16 = 2       // half the memory, 6e-5 g steps up to 4 g
+    }
+
+    fun toArray(): FloatArray = floatArrayOf(
+        sampleRateHz, staLtaTrigger, staLtaDetrigger, minAmplitudeG, axisCoherenceMin,
+        periodicityThresh, adaptiveTrigMin, adaptiveTrigMax, pwaveFreqMinHz, pwaveFreqMaxHz,
+        if (recursiveWindows) 1f else 0f, if (pregate) 1f else 0f, windowStorage.toFloat(),
+    )
+}
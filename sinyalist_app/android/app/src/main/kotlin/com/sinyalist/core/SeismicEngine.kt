@@ -2,7 +2,8 @@
 // SINYALIST — SeismicEngine (Kotlin JNI Bridge)
 // =============================================================================
 // Bridges the C++ NDK seismic detector to the Flutter layer via EventChannel.
-// Manages sensor registration, batching, and lifecycle.
+// Manages sensor registration, batching, and lifecycle. Each engine owns one
+// native detector handle, so several engines (e.g. per sensor) can coexist.
 // =============================================================================
 
 package com.sinyalist.core
@@ -14,47 +15,139 @@ import android.hardware.SensorEventListener
 import android.hardware.SensorManager
 import android.os.Handler
 import android.os.HandlerThread
+import android.os.SystemClock
 import android.util.Log
 import io.flutter.plugin.common.EventChannel
 import io.flutter.plugin.common.MethodChannel
+import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
+import java.nio.LongBuffer
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
 
-class SeismicEngine(private val context: Context) : SensorEventListener {
+class SeismicEngine(
+    private val context: Context,
+    private val sensorType: Int = Sensor.TYPE_ACCELEROMETER,
+    private val config: SeismicConfig = SeismicConfig(),
+    private val nativeSensor: NativeSensorOptions? = null,
+) : SensorEventListener {
+
+    /**
+     * C25: the native library reads the sensor on a thread of its own
+     * (ASensorEventQueue) instead of this listener. Falls back to the Java
+     * listener if the NDK sensor path is unavailable.
+     */
+    data class NativeSensorOptions(
+        val nice: Int = -16,              // THREAD_PRIORITY_AUDIO
+        val cluster: Int = CLUSTER_ANY,   // CPU cluster, slowest first; see CLUSTER_*
+        val wakeUp: Boolean = false       // wake-up sensor: a full HAL FIFO wakes the AP
+    )
 
     companion object {
         private const val TAG = "SeismicEngine"
-        private const val SENSOR_DELAY_US = 20_000 // 50Hz = 20ms period
+        // The HAL picks its nearest native rate; the native resampler brings
+        // it down to the detector's 50Hz, so jitter and odd rates are fine.
+        private const val SENSOR_DELAY_US = 10_000 // ask for ~100Hz
+        private const val MAX_REPORT_LATENCY_US = 100_000 // let the HAL FIFO batch up to 100ms
+        private const val BATCH_CAPACITY = 128 // samples per nativeProcessRaw call
+        private const val FLUSH_WAIT_MS = 500L // stop() waits this long for the last batch
+        // Warm-start window after a service restart; older state is discarded.
+        private const val SNAPSHOT_MAX_AGE_MS = 120_000L
+        // Captured waveforms kept until Flutter polls them; oldest dropped first.
+        private const val MAX_WAVEFORMS = 4
+
+        // NativeSensorOptions.cluster: no pinning, slowest or fastest cores
+        const val CLUSTER_ANY = -1
+        const val CLUSTER_LITTLE = 0
+        const val CLUSTER_BIG = Int.MAX_VALUE
 
         init {
             System.loadLibrary("sinyalist_seismic")
         }
     }
 
-    // JNI declarations — implemented in seismic_detector.hpp
-    private external fun nativeInit(callback: SeismicCallback)
-    private external fun nativeProcessSample(ax: Float, ay: Float, az: Float, timestampMs: Long)
-    private external fun nativeReset()
-    private external fun nativeDestroy()
+    // JNI declarations — implemented in seismic_detector.hpp. Every call but
+    // nativeCreate takes the handle it returned; 0 is ignored natively.
+    private external fun nativeCreate(
+        callback: SeismicCallback, config: FloatArray,
+        snapshotPath: String?, maxSnapshotAgeMs: Long
+    ): Long
+    private external fun nativeProcessBatch(handle: Long, xyz: FloatBuffer, timestampsMs: LongBuffer, count: Int)
+    private external fun nativeProcessRaw(handle: Long, xyz: FloatBuffer, timestampsNs: LongBuffer, count: Int, offsetMs: Long)
+    private external fun nativeAttachTelemetry(handle: Long): ByteBuffer?
+    private external fun nativeDetachTelemetry(handle: Long)
+    private external fun nativeReset(handle: Long)
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeSetTrigger(handle: Long, trigger: Float)
+    private external fun nativeGetStats(handle: Long): LongArray?
+    private external fun nativeTraceDelivered(handle: Long, traceId: Long, uiNs: Long)
+    private external fun nativeFfiHandle(handle: Long): Long
+    private external fun nativeStartSensor(
+        handle: Long, sensorType: Int, samplingUs: Int, maxLatencyUs: Int,
+        nice: Int, cluster: Int, wakeUp: Boolean
+    ): Boolean
+    private external fun nativeStopSensor(handle: Long)
+
+    // Native detector instance; 0 until initialize() and after destroy().
+    private var handle = 0L
+
+    /**
+     * C18: called on the main thread with the dart:ffi handle ("nativeHandle")
+     * just before destroy() frees the detector, so Dart can drop its binding.
+     */
+    var onNativeClosing: ((Long) -> Unit)? = null
 
     private var sensorManager: SensorManager? = null
     private var accelerometer: Sensor? = null
     private var sensorThread: HandlerThread? = null
     private var sensorHandler: Handler? = null
-    private var eventSink: EventChannel.EventSink? = null
+    // Set on the main thread, read on the dispatcher thread per event.
+    @Volatile private var eventSink: EventChannel.EventSink? = null
     private var isRunning = false
+    private var nativeSensorActive = false
+    private var telemetryReader: SeismicTelemetryReader? = null
+    private val waveforms = ArrayDeque<ByteArray>()
+
+    // Batch staging — direct buffers so JNI reads them without copying.
+    // Filled on the sensor thread only; flushed once the current HAL burst
+    // has been dispatched (the flush runnable queues behind it on the looper).
+    private val batchXyz: FloatBuffer = ByteBuffer.allocateDirect(BATCH_CAPACITY * 3 * 4)
+        .order(ByteOrder.nativeOrder()).asFloatBuffer()
+    private val batchTs: LongBuffer = ByteBuffer.allocateDirect(BATCH_CAPACITY * 8)
+        .order(ByteOrder.nativeOrder()).asLongBuffer()
+    private var batchCount = 0
+    private var flushPending = false
+    private val flushRunnable = Runnable { flushBatch() }
 
     // Callback interface invoked by C++ via JNI
     interface SeismicCallback {
+        /** traceId: the event's native latency trace id (C24), 0 if untraced. */
         fun onSeismicEvent(
             level: Int, peakG: Float, staLtaRatio: Float,
-            dominantFreq: Float, detectionTimeMs: Long, durationSamples: Int
+            dominantFreq: Float, detectionTimeMs: Long, durationSamples: Int, traceId: Long
         )
+
+        /**
+         * A completed pre/post-trigger capture (WaveformCapture layout in
+         * waveform_capture.hpp), Steim-2 packed: header version 2, then the
+         * steim2.hpp waveform image. The buffer views native memory and is
+         * only valid during the call.
+         */
+        fun onWaveform(capture: ByteBuffer) {}
     }
 
     private val callback = object : SeismicCallback {
         override fun onSeismicEvent(
             level: Int, peakG: Float, staLtaRatio: Float,
-            dominantFreq: Float, detectionTimeMs: Long, durationSamples: Int
+            dominantFreq: Float, detectionTimeMs: Long, durationSamples: Int, traceId: Long
         ) {
+            Log.w(TAG, "SEISMIC EVENT: level=$level, peakG=$peakG, freq=$dominantFreq")
+            // With the dart:ffi path bound nothing listens on the EventChannel;
+            // Dart then marks the UI hop itself (sinyalist_ffi_trace_delivered).
+            if (eventSink == null) return
+
             val eventData = mapOf(
                 "level" to level,
                 "peakG" to peakG,
@@ -64,20 +157,31 @@ class SeismicEngine(private val context: Context) : SensorEventListener {
                 "durationSamples" to durationSamples
             )
 
+            // The native handle is destroyed on the main thread too, so it is
+            // still valid here unless destroy() already ran.
             Handler(context.mainLooper).post {
-                eventSink?.success(eventData)
+                val sink = eventSink ?: return@post
+                sink.success(eventData)
+                if (handle != 0L) nativeTraceDelivered(handle, traceId, SystemClock.elapsedRealtimeNanos())
             }
+        }
 
-            Log.w(TAG, "SEISMIC EVENT: level=$level, peakG=$peakG, freq=$dominantFreq")
+        override fun onWaveform(capture: ByteBuffer) {
+            val bytes = ByteArray(capture.remaining())
+            capture.get(bytes)
+            synchronized(waveforms) {
+                if (waveforms.size == MAX_WAVEFORMS) waveforms.removeFirst()
+                waveforms.addLast(bytes)
+            }
         }
     }
 
     fun initialize() {
         sensorManager = context.getSystemService(Context.SENSOR_SERVICE) as SensorManager
-        accelerometer = sensorManager?.getDefaultSensor(Sensor.TYPE_ACCELEROMETER)
+        accelerometer = sensorManager?.getDefaultSensor(sensorType)
 
         if (accelerometer == null) {
-            Log.e(TAG, "No accelerometer available on this device")
+            Log.e(TAG, "No sensor of type $sensorType available on this device")
             return
         }
 
@@ -87,35 +191,126 @@ class SeismicEngine(private val context: Context) : SensorEventListener {
             sensorHandler = Handler(looper)
         }
 
-        nativeInit(callback)
+        // Detector state is snapshotted natively every few seconds and restored
+        // here, so a restart by BootReceiver or after an OOM-kill starts warm.
+        val snapshot = File(context.noBackupFilesDir, "seismic_state_$sensorType.bin")
+        if (handle == 0L) {
+            handle = nativeCreate(callback, config.toArray(), snapshot.absolutePath, SNAPSHOT_MAX_AGE_MS)
+        }
+        if (handle == 0L) Log.e(TAG, "Native detector creation failed")
         Log.i(TAG, "SeismicEngine initialized")
     }
 
     fun start() {
         if (isRunning || accelerometer == null) return
+        val native = nativeSensor
+        if (native != null) {
+            if (nativeStartSensor(handle, sensorType, SENSOR_DELAY_US, MAX_REPORT_LATENCY_US,
+                    native.nice, native.cluster, native.wakeUp)) {
+                nativeSensorActive = true
+                isRunning = true
+                Log.i(TAG, "Native sensor thread started (requested ${1_000_000 / SENSOR_DELAY_US}Hz)")
+                return
+            }
+            Log.w(TAG, "Native sensor thread unavailable, using the Java listener")
+        }
         sensorManager?.registerListener(
-            this, accelerometer, SENSOR_DELAY_US, sensorHandler
+            this, accelerometer, SENSOR_DELAY_US, MAX_REPORT_LATENCY_US, sensorHandler
         )
         isRunning = true
-        Log.i(TAG, "Sensor listening started at ${1_000_000 / SENSOR_DELAY_US}Hz")
+        Log.i(TAG, "Sensor listening started (requested ${1_000_000 / SENSOR_DELAY_US}Hz)")
     }
 
     fun stop() {
         if (!isRunning) return
-        sensorManager?.unregisterListener(this)
+        if (nativeSensorActive) {
+            nativeStopSensor(handle)
+            nativeSensorActive = false
+        } else {
+            sensorManager?.unregisterListener(this)
+            // Flush before returning: a native sensor started right after
+            // must be the only thread feeding the detector.
+            val handler = sensorHandler
+            if (handler == null || handler.looper.isCurrentThread) {
+                flushBatch()
+            } else {
+                val flushed = CountDownLatch(1)
+                if (handler.post { flushBatch(); flushed.countDown() }) {
+                    flushed.await(FLUSH_WAIT_MS, TimeUnit.MILLISECONDS)
+                }
+            }
+        }
         isRunning = false
         Log.i(TAG, "Sensor listening stopped")
     }
 
+    /**
+     * C1: feeds a block already at the detector's rate in one JNI call, e.g.
+     * samples from an external accelerometer or a recorded trace. xyz holds
+     * 3 * count interleaved g values and timestampsMs count wall-clock
+     * times; both must be direct buffers in native order.
+     *
+     * C12: a handle takes samples from one thread at a time, so this is
+     * refused (false) while start() has a sensor feeding it.
+     */
+    fun processBatch(xyz: FloatBuffer, timestampsMs: LongBuffer, count: Int): Boolean {
+        if (isRunning || handle == 0L) return false
+        nativeProcessBatch(handle, xyz, timestampsMs, count)
+        return true
+    }
+
     fun destroy() {
+        if (handle != 0L) onNativeClosing?.invoke(nativeFfiHandle(handle))
         stop()
-        nativeDestroy()
+        detachTelemetry()
+        // stop() has flushed the last Java batch; quit the idle handler thread.
         sensorThread?.quitSafely()
+        sensorThread?.join()
+        nativeDestroy(handle)
+        handle = 0L
         sensorThread = null
         sensorHandler = null
         Log.i(TAG, "SeismicEngine destroyed")
     }
 
+    // --- Debug telemetry (shared-memory ring) ---
+
+    fun attachTelemetry() {
+        if (telemetryReader != null) return
+        val ring = nativeAttachTelemetry(handle)
+        if (ring == null) {
+            Log.w(TAG, "No free telemetry ring for this detector")
+            return
+        }
+        telemetryReader = SeismicTelemetryReader(ring)
+    }
+
+    fun detachTelemetry() {
+        if (telemetryReader == null) return
+        nativeDetachTelemetry(handle)
+        telemetryReader = null
+    }
+
+    /** Changes the base STA/LTA trigger without resetting the detector. */
+    fun setTrigger(trigger: Float) {
+        nativeSetTrigger(handle, trigger)
+    }
+
+    /** Packed records since the last poll (see SeismicTelemetryReader.drain). */
+    fun pollTelemetry(): ByteArray = telemetryReader?.drain() ?: ByteArray(0)
+
+    /** Captured waveforms since the last poll, oldest first. */
+    fun pollWaveforms(): List<ByteArray> = synchronized(waveforms) {
+        waveforms.toList().also { waveforms.clear() }
+    }
+
+    /**
+     * Detector counters followed by the per-stage timing histograms, which
+     * are present only in SINYALIST_PROFILE builds (layout in stage_profile.hpp),
+     * then the per-hop event latency histograms (latency_trace.hpp).
+     */
+    fun getStats(): LongArray = nativeGetStats(handle) ?: LongArray(0)
+
     fun setEventSink(sink: EventChannel.EventSink?) {
         eventSink = sink
     }
@@ -123,13 +318,32 @@ class SeismicEngine(private val context: Context) : SensorEventListener {
     // --- SensorEventListener ---
 
     override fun onSensorChanged(event: SensorEvent) {
-        if (event.sensor.type != Sensor.TYPE_ACCELEROMETER) return
+        if (event.sensor.type != sensorType) return
         // Convert to g-force (Android provides m/s^2, divide by 9.81)
         val ax = event.values[0] / 9.81f
         val ay = event.values[1] / 9.81f
         val az = event.values[2] / 9.81f
-        val timestampMs = System.currentTimeMillis()
-        nativeProcessSample(ax, ay, az, timestampMs)
+        // event.timestamp is elapsedRealtimeNanos-based and kept in ns for the
+        // resampler; the wall-clock offset is passed once per batch.
+        val base = batchCount * 3
+        batchXyz.put(base, ax).put(base + 1, ay).put(base + 2, az)
+        batchTs.put(batchCount, event.timestamp)
+        batchCount++
+        if (batchCount == BATCH_CAPACITY) {
+            flushBatch()
+        } else if (!flushPending) {
+            flushPending = true
+            sensorHandler?.post(flushRunnable)
+        }
+    }
+
+    private fun flushBatch() {
+        flushPending = false
+        sensorHandler?.removeCallbacks(flushRunnable)
+        if (batchCount == 0) return
+        val offsetMs = System.currentTimeMillis() - SystemClock.elapsedRealtime()
+        nativeProcessRaw(handle, batchXyz, batchTs, batchCount, offsetMs)
+        batchCount = 0
     }
 
     override fun onAccuracyChanged(sensor: Sensor?, accuracy: Int) {
@@ -143,9 +357,16 @@ class SeismicEngine(private val context: Context) : SensorEventListener {
             "initialize" -> { initialize(); "ok" }
             "start"      -> { start(); "ok" }
             "stop"       -> { stop(); "ok" }
-            "reset"      -> { nativeReset(); "ok" }
+            "reset"      -> { nativeReset(handle); "ok" }
             "destroy"    -> { destroy(); "ok" }
             "isRunning"  -> isRunning
+            "attachTelemetry" -> { attachTelemetry(); "ok" }
+            "detachTelemetry" -> { detachTelemetry(); "ok" }
+            "pollTelemetry"   -> pollTelemetry()
+            "pollWaveforms"   -> pollWaveforms()
+            "getStats"        -> getStats()
+            // dart:ffi fast path (sinyalist_ffi.h) drives the same instance
+            "nativeHandle"    -> nativeFfiHandle(handle)
             else -> null
         }
     }
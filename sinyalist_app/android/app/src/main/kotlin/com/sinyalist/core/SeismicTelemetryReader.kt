@@ -0,0 +1,69 @@
+// =============================================================================
+// SINYALIST — Seismic Telemetry Reader (shared-memory ring)
+// =============================================================================
+// Reads DebugTelemetry records straight out of the native TelemetryRing
+// (seismic_detector.hpp, C7) through a direct ByteBuffer mapped once.
+// Polled at the UI frame rate; no JNI upcalls, no per-record boxing.
+// =============================================================================
+
+package com.sinyalist.core
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+class SeismicTelemetryReader(buffer: ByteBuffer) {
+
+    companion object {
+        private const val MAGIC = 0x31544453 // "SDT1"
+        private const val HEADER_SIZE = 64
+        private const val OFF_CAPACITY = 8
+        private const val OFF_RECORD_SIZE = 12
+        private const val OFF_WRITE_SEQ = 24
+        // Record payload copied out per sample, without the leading seq field
+        const val PAYLOAD_SIZE = 40
+    }
+
+    private val buf: ByteBuffer = buffer.order(ByteOrder.nativeOrder())
+    private val view: ByteBuffer = buf.duplicate()
+    private val capacity = buf.getInt(OFF_CAPACITY)
+    private val recordSize = buf.getInt(OFF_RECORD_SIZE)
+    private var nextSeq = buf.getLong(OFF_WRITE_SEQ)
+
+    /** Records overwritten before they could be read. */
+    var lost = 0L
+        private set
+
+    init {
+        require(buf.getInt(0) == MAGIC) { "Not a seismic telemetry ring" }
+    }
+
+    /**
+     * Copies every record written since the last call into one packed array of
+     * PAYLOAD_SIZE-byte entries (native byte order):
+     * ts i64 | rawMag, filtMag, sta, lta, ratio, baselineVar, adaptiveTrigger f32 |
+     * state u8 | reject u8 | pad[2].
+     */
+    fun drain(): ByteArray {
+        val written = buf.getLong(OFF_WRITE_SEQ)
+        if (written - nextSeq > capacity) {
+            lost += written - capacity - nextSeq
+            nextSeq = written - capacity
+        }
+        val count = (written - nextSeq).toInt().coerceAtLeast(0)
+        val out = ByteArray(count * PAYLOAD_SIZE)
+        var n = 0
+        while (nextSeq < written) {
+            val base = HEADER_SIZE + (nextSeq % capacity).toInt() * recordSize
+            val expect = nextSeq + 1
+            if (buf.getLong(base) == expect) {
+                view.position(base + 8)
+                view.get(out, n * PAYLOAD_SIZE, PAYLOAD_SIZE)
+                if (buf.getLong(base) == expect) n++ else lost++
+            } else {
+                lost++
+            }
+            nextSeq++
+        }
+        return if (n == count) out else out.copyOf(n * PAYLOAD_SIZE)
+    }
+}
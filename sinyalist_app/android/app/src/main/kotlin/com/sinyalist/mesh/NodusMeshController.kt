@@ -7,6 +7,8 @@
 //       TTL + hop_count enforcement, strict max packet size, drop malformed
 //   B3. SQLite persistence for store-carry-forward (survives restarts)
 //   B4. Watchdog via ForegroundService (see SinyalistForegroundService)
+//   C23. Seismic reports clustered natively (TriggerCoincidence) by distance
+//        and P-wave-consistent arrival times
 // =============================================================================
 
 package com.sinyalist.mesh
@@ -291,7 +293,7 @@ data class MeshPacket(
             return false
         }
 
-        private fun readVarint(data: ByteArray, startPos: Int): Pair<Long, Int> {
+        internal fun readVarint(data: ByteArray, startPos: Int): Pair<Long, Int> {
             var result = 0L
             var shift = 0
             var pos = startPos
@@ -430,6 +432,8 @@ class NodusMeshController(private val context: Context) {
     private var meshNodeId: Int = 0
     private var dedupEvictTimer: Timer? = null
     private var packetStore: MeshPacketStore? = null // B3: SQLite persistence
+    private var coincidence: TriggerCoincidence? = null // C23: trigger clustering
+    @Volatile private var lastCluster: TriggerCoincidence.Cluster? = null
 
     // Counters for observability
     private val stormDropCount = AtomicInteger(0)
@@ -460,7 +464,9 @@ class NodusMeshController(private val context: Context) {
         val stormDrops: Int = 0,
         val dedupDrops: Int = 0,
         val ttlDrops: Int = 0,
-        val malformedDrops: Int = 0
+        val malformedDrops: Int = 0,
+        val clusterDevices: Int = 0,
+        val clusterConfidence: Float = 0f
     )
 
     private var discoveredPeers = mutableSetOf<String>()
@@ -487,6 +493,7 @@ class NodusMeshController(private val context: Context) {
         // B3: Initialize SQLite persistence for store-carry-forward
         packetStore = MeshPacketStore(context)
         Log.i(TAG, "SQLite packet store initialized")
+        if (coincidence == null) coincidence = TriggerCoincidence()
 
         Log.i(TAG, "Nodus mesh initialized — nodeId=$meshNodeId")
         logTransition("uninitialized", "initialized")
@@ -511,6 +518,7 @@ class NodusMeshController(private val context: Context) {
                         bloomFilter.add(dedupKey)
                         lruDedup.add(dedupKey)
                         if (priorityQueue.enqueue(packet)) loaded++
+                        recordTrigger(packet.payload) // C23: persisted reports still count
                     }
                 }
                 Log.i(TAG, "B3: Restored $loaded/${restored.size} packets from SQLite")
@@ -611,6 +619,8 @@ class NodusMeshController(private val context: Context) {
             }
         }
 
+        recordTrigger(protobufBytes)
+
         // Update GATT characteristic
         updateGattCharacteristic(protobufBytes)
 
@@ -692,6 +702,7 @@ class NodusMeshController(private val context: Context) {
             return false
         }
 
+        recordTrigger(payload)
         onPacketReceived?.invoke(packet)
         Log.i(TAG, "Received mesh packet: ${payload.size}B from $sourceAddress, priority=${packet.priority}")
         emitStats()
@@ -963,6 +974,17 @@ class NodusMeshController(private val context: Context) {
     // Stats emission
     // -----------------------------------------------------------------------
 
+    // -----------------------------------------------------------------------
+    // C23: Seismic reports → coincidence index (repeats are not re-counted)
+    // -----------------------------------------------------------------------
+
+    private fun recordTrigger(payload: ByteArray) {
+        val c = coincidence?.insert(payload) ?: return
+        if (c.repeat) return
+        lastCluster = c
+        Log.i(TAG, "C23: report clusters with ${c.devices - 1} other device(s), cluster=${c.cluster} confidence=${"%.2f".format(c.confidence)}")
+    }
+
     private fun emitStats() {
         onMeshStatsUpdate?.invoke(MeshStats(
             activeNodes = discoveredPeers.size,
@@ -973,7 +995,9 @@ class NodusMeshController(private val context: Context) {
             stormDrops = stormDropCount.get(),
             dedupDrops = dedupDropCount.get(),
             ttlDrops = ttlDropCount.get(),
-            malformedDrops = malformedDropCount.get()
+            malformedDrops = malformedDropCount.get(),
+            clusterDevices = lastCluster?.cluster ?: 0,
+            clusterConfidence = lastCluster?.confidence ?: 0f
         ))
     }
 
@@ -1024,7 +1048,9 @@ class NodusMeshController(private val context: Context) {
                 "stormDrops" to stormDropCount.get(),
                 "dedupDrops" to dedupDropCount.get(),
                 "ttlDrops" to ttlDropCount.get(),
-                "malformedDrops" to malformedDropCount.get()
+                "malformedDrops" to malformedDropCount.get(),
+                "clusterDevices" to (lastCluster?.cluster ?: 0),
+                "clusterConfidence" to (lastCluster?.confidence ?: 0f)
             )
             "isHealthy" -> isHealthy()
             else -> null
@@ -0,0 +1,113 @@
+// =============================================================================
+// SINYALIST — TriggerCoincidence (C23: native geo-temporal trigger clustering)
+// =============================================================================
+// Seismic reports carried by the mesh are clustered in the native coincidence
+// index (coincidence_index.hpp): a report is supported by reports from other
+// devices nearby whose arrival times one P-wave front allows. A single
+// dropped phone stays a cluster of one however often it is relayed.
+// Thread-safe: calls are serialised on the instance.
+// =============================================================================
+
+package com.sinyalist.mesh
+
+class TriggerCoincidence(radiusKm: Float = 0f, capacity: Int = 0) {
+
+    data class Cluster(
+        val devices: Int,       // consistent neighbourhood, this report included
+        val cluster: Int,       // largest neighbourhood it belongs to
+        val confidence: Float,  // backend GeoCluster scale
+        val firstMs: Long,      // earliest consistent arrival
+        val repeat: Boolean     // device already reported; not counted again
+    )
+
+    companion object {
+        init {
+            System.loadLibrary("sinyalist_seismic")
+        }
+
+        /** Fields of a SinyalistPacket the index needs; null unless it is a seismic report. */
+        fun reportOf(payload: ByteArray): LongArray? {
+            var lat = 0L; var lon = 0L; var timeMs = 0L; var userId = 0L; var key = 0L
+            var level = 0L
+            var pos = 0
+            while (pos < payload.size) {
+                val tag = MeshPacket.readVarint(payload, pos)
+                pos = tag.second
+                val fieldNumber = (tag.first shr 3).toInt()
+                when ((tag.first and 0x07).toInt()) {
+                    0 -> {
+                        val v = MeshPacket.readVarint(payload, pos)
+                        pos = v.second
+                        val zigzag = (v.first ushr 1) xor -(v.first and 1)
+                        when (fieldNumber) {
+                            3 -> lat = zigzag          // latitude_e7, sint32
+                            4 -> lon = zigzag          // longitude_e7, sint32
+                            15 -> level = v.first      // alert_level
+                        }
+                    }
+                    1 -> {
+                        if (pos + 8 > payload.size) return null
+                        when (fieldNumber) {
+                            1 -> userId = readFixed64(payload, pos)
+                            16 -> timeMs = readFixed64(payload, pos)
+                        }
+                        pos += 8
+                    }
+                    2 -> {
+                        val lenResult = MeshPacket.readVarint(payload, pos)
+                        val len = lenResult.first.toInt()
+                        pos = lenResult.second
+                        // ed25519_public_key: the device id signed reports can't forge
+                        if (fieldNumber == 29 && len == 32 && pos + 8 <= payload.size) key = readFixed64(payload, pos)
+                        pos += len
+                    }
+                    5 -> pos += 4
+                    else -> return null
+                }
+                if (pos < 0 || pos > payload.size) return null
+            }
+            val device = if (key != 0L) key else userId
+            if (level <= 0 || timeMs <= 0 || device == 0L) return null
+            return longArrayOf(lat, lon, timeMs, device)
+        }
+
+        private fun readFixed64(data: ByteArray, pos: Int): Long {
+            var v = 0L
+            for (i in 7 downTo 0) v = (v shl 8) or (data[pos + i].toLong() and 0xFF)
+            return v
+        }
+    }
+
+    private external fun nativeCreate(radiusKm: Float, capacity: Int): Long
+    private external fun nativeInsert(handle: Long, latE7: Int, lonE7: Int, timeMs: Long, device: Long, out: LongArray): Float
+    private external fun nativeReset(handle: Long)
+    private external fun nativeDestroy(handle: Long)
+
+    private val lock = Object()
+    private val out = LongArray(4)
+    private var handle = nativeCreate(radiusKm, capacity)
+
+    /** Adds a report; null for a packet that is not a seismic report. */
+    fun insert(payload: ByteArray): Cluster? {
+        val r = reportOf(payload) ?: return null
+        return insert(r[0].toInt(), r[1].toInt(), r[2], r[3])
+    }
+
+    fun insert(latE7: Int, lonE7: Int, timeMs: Long, device: Long): Cluster? {
+        synchronized(lock) {
+            if (handle == 0L) return null
+            val confidence = nativeInsert(handle, latE7, lonE7, timeMs, device, out)
+            if (confidence < 0f) return null
+            return Cluster(out[0].toInt(), out[1].toInt(), confidence, out[2], out[3] != 0L)
+        }
+    }
+
+    fun reset() = synchronized(lock) { nativeReset(handle) }
+
+    fun close() {
+        synchronized(lock) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+}
@@ -20,6 +20,7 @@ import android.os.PowerManager
 import android.provider.Settings
 import android.util.Log
 import androidx.core.app.NotificationCompat
+import com.sinyalist.core.SeismicConfig
 import com.sinyalist.core.SeismicEngine
 import com.sinyalist.mesh.NodusMeshController
 
@@ -31,6 +32,8 @@ class SinyalistForegroundService : Service() {
         private const val CHANNEL_ID = "sinyalist_emergency"
         private const val CHANNEL_NAME = "Sinyalist Emergency Monitor"
         private const val WATCHDOG_INTERVAL_MS = 30_000L // Check every 30 seconds
+        // C9: the energy pre-gate is opt-in; the always-on service is what it is for
+        private val SEISMIC_CONFIG = SeismicConfig(pregate = true)
 
         const val ACTION_START = "com.sinyalist.action.START"
         const val ACTION_STOP = "com.sinyalist.action.STOP"
@@ -118,7 +121,7 @@ class SinyalistForegroundService : Service() {
         logState("wakelock_acquired", "1h partial wake lock (renewable)")
 
         // Initialize seismic engine
-        seismicEngine = SeismicEngine(this).apply {
+        seismicEngine = SeismicEngine(this, config = SEISMIC_CONFIG).apply {
             initialize()
             start()
         }
@@ -247,7 +250,7 @@ class SinyalistForegroundService : Service() {
             Log.w(TAG, "WATCHDOG: SeismicEngine is null — restarting")
             logState("watchdog_restart_seismic", "SeismicEngine was null")
             try {
-                seismicEngine = SeismicEngine(this).apply {
+                seismicEngine = SeismicEngine(this, config = SEISMIC_CONFIG).apply {
                     initialize()
                     start()
                 }
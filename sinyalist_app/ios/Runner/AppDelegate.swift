@@ -8,7 +8,7 @@
 // platforms without modification.
 //
 // Bridges registered:
-//   com.sinyalist/seismic        → SinyalistSeismicEngine (CoreMotion)
+//   com.sinyalist/seismic        → SinyalistSeismicEngine (CoreMotion → C++ core)
 //   com.sinyalist/seismic_events → SinyalistSeismicEngine stream
 //   com.sinyalist/mesh           → SinyalistMeshController (CoreBluetooth)
 //   com.sinyalist/mesh_events    → SinyalistMeshController stream
@@ -83,6 +83,10 @@ import UIKit
             case "reset":      engine.reset();      result("ok")
             case "destroy":    engine.stop();       result("ok")
             case "isRunning":  result(engine.isRunning)
+            case "getStats":
+                let words = engine.stats()
+                result(FlutterStandardTypedData(int64: words.withUnsafeBufferPointer { Data(buffer: $0) }))
+            case "nativeHandle": result(0)   // dart:ffi fast path is Android-only
             default:           result(FlutterMethodNotImplemented)
             }
         }
@@ -1 +1,2 @@
 #import "GeneratedPluginRegistrant.h"
+#import "sinyalist_detector.h"
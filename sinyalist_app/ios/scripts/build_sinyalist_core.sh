@@ -0,0 +1,43 @@
+#!/bin/sh
+# =============================================================================
+# SINYALIST — builds ios/Native/SinyalistCore.xcframework from the NDK sources
+# =============================================================================
+# C21: the detector core (sinyalist_detector.h) and waveform codec as a
+# static library per SDK: iphoneos arm64, iphonesimulator arm64 + x86_64.
+# Runner links it through Flutter/Debug.xcconfig and Release.xcconfig; run
+# this once after checkout and again whenever the C++ core changes.
+#
+#   ios/scripts/build_sinyalist_core.sh [Release|Debug]
+# =============================================================================
+set -eu
+
+CONFIG="${1:-Release}"
+HERE="$(cd "$(dirname "$0")" && pwd)"
+SRC="$HERE/../../android/app/src/main/cpp"
+OUT="$HERE/../Native"
+WORK="$OUT/build"
+MIN_IOS=13.0
+
+slice() {   # <name> <sdk> <archs>
+    cmake -S "$SRC" -B "$WORK/$1" \
+        -DCMAKE_SYSTEM_NAME=iOS \
+        -DCMAKE_OSX_SYSROOT="$2" \
+        -DCMAKE_OSX_ARCHITECTURES="$3" \
+        -DCMAKE_OSX_DEPLOYMENT_TARGET="$MIN_IOS" \
+        -DCMAKE_BUILD_TYPE="$CONFIG" >/dev/null
+    cmake --build "$WORK/$1" --target sinyalist_core --config "$CONFIG"
+}
+
+slice device iphoneos arm64
+slice simulator iphonesimulator "arm64;x86_64"
+
+rm -rf "$WORK/include" "$OUT/SinyalistCore.xcframework"
+mkdir -p "$WORK/include"
+cp "$SRC/sinyalist_detector.h" "$SRC/sinyalist_codec.h" "$WORK/include/"
+
+xcodebuild -create-xcframework \
+    -library "$WORK/device/libsinyalist_core.a" -headers "$WORK/include" \
+    -library "$WORK/simulator/libsinyalist_core.a" -headers "$WORK/include" \
+    -output "$OUT/SinyalistCore.xcframework"
+
+echo "SinyalistCore.xcframework ($CONFIG) → $OUT"
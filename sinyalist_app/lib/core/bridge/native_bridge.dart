@@ -3,7 +3,11 @@
 // =============================================================================
 
 import 'dart:async';
+import 'dart:typed_data';
 import 'package:flutter/services.dart';
+import 'package:sinyalist/core/codec/steim2_codec.dart';
+
+import 'seismic_ffi.dart';
 
 // ---------------------------------------------------------------------------
 // Seismic Event from C++ engine
@@ -39,6 +43,130 @@ class SeismicEvent {
   bool get isCritical => level >= 3;
 }
 
+// ---------------------------------------------------------------------------
+// Debug telemetry record from the native shared-memory ring
+// ---------------------------------------------------------------------------
+class SeismicTelemetry {
+  // Packed layout written by SeismicTelemetryReader.drain() (little-endian)
+  static const int recordSize = 40;
+
+  final int timestampMs;
+  final double rawMag;
+  final double filtMag;
+  final double sta;
+  final double lta;
+  final double ratio;
+  final double baselineVar;
+  final double adaptiveTrigger;
+  final int state;
+  final int reject;
+
+  const SeismicTelemetry({
+    required this.timestampMs,
+    required this.rawMag,
+    required this.filtMag,
+    required this.sta,
+    required this.lta,
+    required this.ratio,
+    required this.baselineVar,
+    required this.adaptiveTrigger,
+    required this.state,
+    required this.reject,
+  });
+
+  factory SeismicTelemetry.fromBytes(ByteData d, int o) => SeismicTelemetry(
+    timestampMs: d.getInt64(o, Endian.little),
+    rawMag: d.getFloat32(o + 8, Endian.little),
+    filtMag: d.getFloat32(o + 12, Endian.little),
+    sta: d.getFloat32(o + 16, Endian.little),
+    lta: d.getFloat32(o + 20, Endian.little),
+    ratio: d.getFloat32(o + 24, Endian.little),
+    baselineVar: d.getFloat32(o + 28, Endian.little),
+    adaptiveTrigger: d.getFloat32(o + 32, Endian.little),
+    state: d.getUint8(o + 36),
+    reject: d.getUint8(o + 37),
+  );
+
+  static List<SeismicTelemetry> listFromBytes(Uint8List bytes) {
+    final d = ByteData.sublistView(bytes);
+    return [
+      for (var o = 0; o + recordSize <= bytes.length; o += recordSize)
+        SeismicTelemetry.fromBytes(d, o),
+    ];
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Raw pre/post-trigger waveform captured natively around an event
+// ---------------------------------------------------------------------------
+class SeismicWaveform {
+  // Header written by WaveformCapture (waveform_capture.hpp, little-endian);
+  // version 1 is followed by float samples, version 2 by a Steim-2 image.
+  static const int headerSize = 48;
+  static const int magic = 0x31465753; // "SWF1"
+  static const int versionPacked = 2;
+
+  final int firstMs;
+  final int onsetMs;
+  final int preSamples;
+  final double sampleRateHz;
+  final int level;
+  final bool complete;
+  final double peakG;
+  final int durationSamples;
+  final Float32List xyz; // interleaved x, y, z in g
+  final Uint8List? packed; // Steim-2 image as captured, for uplink (version 2)
+
+  const SeismicWaveform({
+    required this.firstMs,
+    required this.onsetMs,
+    required this.preSamples,
+    required this.sampleRateHz,
+    required this.level,
+    required this.complete,
+    required this.peakG,
+    required this.durationSamples,
+    required this.xyz,
+    this.packed,
+  });
+
+  int get samples => xyz.length ~/ 3;
+
+  /// Null if the bytes are not a complete capture.
+  static SeismicWaveform? fromBytes(Uint8List bytes) {
+    if (bytes.length < headerSize) return null;
+    final d = ByteData.sublistView(bytes);
+    if (d.getUint32(0, Endian.little) != magic) return null;
+    final n = d.getUint32(8, Endian.little);
+    Uint8List? packed;
+    Float32List xyz;
+    if (d.getUint32(4, Endian.little) == versionPacked) {
+      packed = Uint8List.sublistView(bytes, headerSize);
+      final unpacked = PackedWaveform.unpack(packed);
+      if (unpacked == null || unpacked.length != n * 3) return null;
+      xyz = unpacked;
+    } else {
+      if (bytes.length < headerSize + n * 12) return null;
+      xyz = Float32List(n * 3);
+      for (var i = 0; i < n * 3; i++) {
+        xyz[i] = d.getFloat32(headerSize + i * 4, Endian.little);
+      }
+    }
+    return SeismicWaveform(
+      preSamples: d.getUint32(12, Endian.little),
+      firstMs: d.getInt64(16, Endian.little),
+      onsetMs: d.getInt64(24, Endian.little),
+      sampleRateHz: d.getFloat32(32, Endian.little),
+      level: d.getUint8(36),
+      complete: d.getUint8(37) != 0,
+      peakG: d.getFloat32(40, Endian.little),
+      durationSamples: d.getUint32(44, Endian.little),
+      xyz: xyz,
+      packed: packed,
+    );
+  }
+}
+
 // ---------------------------------------------------------------------------
 // Mesh stats from Nodus BLE layer
 // ---------------------------------------------------------------------------
@@ -72,11 +200,37 @@ class SeismicBridge {
   static final EventChannel _events = EventChannel('com.sinyalist/seismic_events');
 
   static Stream<SeismicEvent>? _eventStream;
+  static SeismicFfi? _ffi;
 
   static Future<void> initialize() async {
+    _method.setMethodCallHandler(_onNativeCall);
     await _method.invokeMethod('initialize');
+    final handle = await _method.invokeMethod<int>('nativeHandle') ?? 0;
+    if (_ffi?.handle != handle) {
+      _unbindFfi();
+      _ffi = SeismicFfi.open(handle);
+    }
+  }
+
+  // Kotlin calls in before SeismicEngine.destroy() frees the detector.
+  static Future<Object?> _onNativeCall(MethodCall call) async {
+    if (call.method == 'nativeHandleClosing' && call.arguments == _ffi?.handle) _unbindFfi();
+    return null;
+  }
+
+  // Listeners of the ffi event stream see it close; events picks its source
+  // again on next use.
+  static void _unbindFfi() {
+    final ffi = _ffi;
+    if (ffi == null) return;
+    ffi.close();
+    _ffi = null;
+    _eventStream = null;
   }
 
+  /// dart:ffi fast path to the native detector, if available (Android).
+  static SeismicFfi? get ffi => _ffi;
+
   static Future<void> start() async {
     await _method.invokeMethod('start');
   }
@@ -93,8 +247,43 @@ class SeismicBridge {
     return await _method.invokeMethod<bool>('isRunning') ?? false;
   }
 
+  // Debug telemetry: attach once, then poll at the UI frame rate.
+  static Future<void> attachTelemetry() async {
+    await _method.invokeMethod('attachTelemetry');
+  }
+
+  static Future<void> detachTelemetry() async {
+    await _method.invokeMethod('detachTelemetry');
+  }
+
+  static Future<List<SeismicTelemetry>> pollTelemetry() async {
+    final ffi = _ffi;
+    if (ffi != null) return ffi.pollTelemetry();
+    final bytes = await _method.invokeMethod<Uint8List>('pollTelemetry');
+    return bytes != null ? SeismicTelemetry.listFromBytes(bytes) : const [];
+  }
+
+  // Waveforms captured around events since the last poll, oldest first.
+  static Future<List<SeismicWaveform>> pollWaveforms() async {
+    final list = await _method.invokeMethod<List<Object?>>('pollWaveforms');
+    return (list ?? const [])
+        .whereType<Uint8List>()
+        .map(SeismicWaveform.fromBytes)
+        .whereType<SeismicWaveform>()
+        .toList();
+  }
+
+  // Counters plus, in SINYALIST_PROFILE builds, per-stage timing histograms,
+  // then per-hop event latency (SeismicStats.latency).
+  static Future<SeismicStats> getStats() async {
+    final words = await _method.invokeMethod<Int64List>('getStats');
+    return words != null ? SeismicStats.fromWords(words) : const SeismicStats();
+  }
+
+  // Straight from the native dispatcher when the ffi path is bound, else
+  // through Kotlin and the EventChannel.
   static Stream<SeismicEvent> get events {
-    _eventStream ??= _events.receiveBroadcastStream().map(
+    _eventStream ??= _ffi?.events ?? _events.receiveBroadcastStream().map(
       (event) => SeismicEvent.fromMap(event as Map<dynamic, dynamic>),
     );
     return _eventStream!;
@@ -0,0 +1,300 @@
+// =============================================================================
+// SINYALIST — Seismic dart:ffi fast path (Dart ↔ NDK, no JNI hop)
+// =============================================================================
+// Binds the C ABI in sinyalist_ffi.h. Events arrive through a
+// NativeCallable.listener the native dispatcher thread calls per event, so
+// Dart sees them without the JNI upcall, Kotlin map, main-looper post and
+// EventChannel codec. Nothing is allocated per read: the native side copies
+// into per-instance staging buffers viewed here once as typed lists.
+// =============================================================================
+
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:io' show Platform;
+import 'dart:typed_data';
+
+import 'native_bridge.dart';
+
+// sinyalist_stats (sinyalist_ffi.h)
+final class _Stats extends Struct {
+  @Uint64()
+  external int samples;
+  @Uint64()
+  external int gatedSamples;
+  @Uint64()
+  external int wakes;
+  @Uint64()
+  external int events;
+  @Uint32()
+  external int eventsDropped;
+  @Uint32()
+  external int captures;
+  @Uint32()
+  external int capturesDropped;
+  @Uint8()
+  external int asleep;
+}
+
+// One process_sample() stage from a SINYALIST_PROFILE build, or one hop of
+// the event latency trace: log2 buckets, bucket b counts durations in
+// [2^b, 2^(b+1)) ns (stage_profile.hpp, latency_trace.hpp).
+class SeismicStageTiming {
+  // Stage order in stage_profile.hpp
+  static const names = [
+    'sample', 'gate', 'filter', 'windows', 'spectrum', 'trigger', 'reject', 'autocorr',
+  ];
+
+  final String name;
+  final int calls;
+  final int totalNs;
+  final int maxNs;
+  final List<int> buckets;
+
+  const SeismicStageTiming({
+    required this.name,
+    required this.calls,
+    required this.totalNs,
+    required this.maxNs,
+    required this.buckets,
+  });
+
+  double get meanNs => calls > 0 ? totalNs / calls : 0.0;
+
+  /// Upper edge of the bucket holding the q-quantile, 0 if empty.
+  int quantileNs(double q) {
+    final n = buckets.fold<int>(0, (a, b) => a + b);
+    if (n == 0) return 0;
+    var acc = 0;
+    for (var b = 0; b < buckets.length; b++) {
+      acc += buckets[b];
+      if (acc >= q * n) return 2 << b;
+    }
+    return 2 << (buckets.length - 1);
+  }
+}
+
+class SeismicStats {
+  final int samples;
+  final int gatedSamples;
+  final int wakes;
+  final int events;
+  final int eventsDropped;
+  final int captures;
+  final int capturesDropped;
+  final bool asleep;
+  // Empty unless the native library was built with SINYALIST_PROFILE.
+  final List<SeismicStageTiming> stages;
+  final int clockOverheadNs;
+  // Sensor timestamp → Flutter delivery, per hop (latency_trace.hpp).
+  final List<SeismicStageTiming> latency;
+
+  const SeismicStats({
+    this.samples = 0,
+    this.gatedSamples = 0,
+    this.wakes = 0,
+    this.events = 0,
+    this.eventsDropped = 0,
+    this.captures = 0,
+    this.capturesDropped = 0,
+    this.asleep = false,
+    this.stages = const [],
+    this.clockOverheadNs = 0,
+    this.latency = const [],
+  });
+
+  static const _counters = 8;
+
+  // Hop order in latency_trace.hpp
+  static const latencyHops = [
+    'sensor_ingest', 'ingest_decision', 'decision_dispatch', 'dispatch_callback', 'callback_ui',
+  ];
+
+  /// Parses nativeGetStats(): the sinyalist_stats fields in order, then
+  /// stages | buckets | overhead_ns | per stage count, sum, max, buckets,
+  /// then hops | buckets | per hop count, sum, max, buckets.
+  factory SeismicStats.fromWords(List<int> w) {
+    if (w.length < _counters) return const SeismicStats();
+    final stages = <SeismicStageTiming>[];
+    final latency = <SeismicStageTiming>[];
+    var overhead = 0;
+    // n histograms of nb buckets at o; returns the offset past them, or -1
+    // if the words ran out.
+    int histograms(int o, int n, int nb, List<String> names, List<SeismicStageTiming> out) {
+      for (var s = 0; s < n; s++, o += 3 + nb) {
+        if (o + 3 + nb > w.length) return -1;
+        out.add(SeismicStageTiming(
+          name: s < names.length ? names[s] : 'stage$s',
+          calls: w[o],
+          totalNs: w[o + 1],
+          maxNs: w[o + 2],
+          buckets: List.unmodifiable(w.sublist(o + 3, o + 3 + nb)),
+        ));
+      }
+      return o;
+    }
+    if (w.length >= _counters + 3) {
+      overhead = w[_counters + 2];
+      final o = histograms(_counters + 3, w[_counters], w[_counters + 1],
+          SeismicStageTiming.names, stages);
+      if (o >= 0 && o + 2 <= w.length) histograms(o + 2, w[o], w[o + 1], latencyHops, latency);
+    }
+    return SeismicStats(
+      samples: w[0],
+      gatedSamples: w[1],
+      wakes: w[2],
+      events: w[3],
+      eventsDropped: w[4],
+      captures: w[5],
+      capturesDropped: w[6],
+      asleep: w[7] != 0,
+      stages: stages,
+      clockOverheadNs: overhead,
+      latency: latency,
+    );
+  }
+}
+
+typedef _ListenerFn = Void Function(Int64);
+
+class SeismicFfi {
+  static const int eventSize = 32;
+  static const int eventCapacity = 16;
+  static const int telemetryCapacity = 256;
+
+  final int _handle;
+  final void Function(int, Pointer<NativeFunction<_ListenerFn>>) _setListener;
+  final int Function(int) _readEvents;
+  final int Function(int) _readTelemetry;
+  final void Function(int, int) _commitConfig;
+  final void Function(int, int, int) _traceDelivered;
+  final Pointer<_Stats> Function(int) _stats;
+  final ByteData _events;
+  final Uint8List _telemetry;
+  final Float32List _config;
+  final _controller = StreamController<SeismicEvent>.broadcast();
+  NativeCallable<_ListenerFn>? _listener;
+  bool _closed = false;
+
+  SeismicFfi._(DynamicLibrary lib, this._handle)
+      : _setListener = lib.lookupFunction<
+            Void Function(Int64, Pointer<NativeFunction<_ListenerFn>>),
+            void Function(int, Pointer<NativeFunction<_ListenerFn>>)>('sinyalist_ffi_set_listener'),
+        _readEvents = lib.lookupFunction<Int32 Function(Int64), int Function(int)>(
+            'sinyalist_ffi_read_events'),
+        _readTelemetry = lib.lookupFunction<Int32 Function(Int64), int Function(int)>(
+            'sinyalist_ffi_read_telemetry'),
+        _commitConfig = lib.lookupFunction<Void Function(Int64, Int32), void Function(int, int)>(
+            'sinyalist_ffi_commit_config'),
+        _traceDelivered = lib.lookupFunction<Void Function(Int64, Int64, Int64),
+            void Function(int, int, int)>('sinyalist_ffi_trace_delivered'),
+        _stats = lib.lookupFunction<Pointer<_Stats> Function(Int64), Pointer<_Stats> Function(int)>(
+            'sinyalist_ffi_stats'),
+        _events = ByteData.sublistView(lib
+            .lookupFunction<Pointer<Uint8> Function(Int64), Pointer<Uint8> Function(int)>(
+                'sinyalist_ffi_event_buffer')(_handle)
+            .asTypedList(eventCapacity * eventSize)),
+        _telemetry = lib
+            .lookupFunction<Pointer<Uint8> Function(Int64), Pointer<Uint8> Function(int)>(
+                'sinyalist_ffi_telemetry_buffer')(_handle)
+            .asTypedList(telemetryCapacity * SeismicTelemetry.recordSize),
+        _config = lib
+            .lookupFunction<Pointer<Float> Function(Int64), Pointer<Float> Function(int)>(
+                'sinyalist_ffi_config_buffer')(_handle)
+            .asTypedList(lib.lookupFunction<Int32 Function(), int Function()>(
+                'sinyalist_ffi_config_capacity')());
+
+  /// Binds to the native detector behind [handle]; null off Android, for a
+  /// zero or destroyed handle, or if the library lacks the C ABI.
+  static SeismicFfi? open(int handle) {
+    if (!Platform.isAndroid || handle == 0) return null;
+    try {
+      final lib = DynamicLibrary.open('libsinyalist_seismic.so');
+      final events = lib.lookupFunction<Pointer<Uint8> Function(Int64),
+          Pointer<Uint8> Function(int)>('sinyalist_ffi_event_buffer');
+      if (events(handle) == nullptr) return null;
+      return SeismicFfi._(lib, handle);
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  /// The native handle ("nativeHandle" on the method channel).
+  int get handle => _handle;
+
+  /// Events as the native dispatcher logs them.
+  Stream<SeismicEvent> get events {
+    if (_listener == null) {
+      final l = NativeCallable<_ListenerFn>.listener(_onNotify);
+      _setListener(_handle, l.nativeFunction);
+      _listener = l;
+    }
+    return _controller.stream;
+  }
+
+  void _onNotify(int seq) {
+    if (_closed) return;
+    final n = _readEvents(_handle);
+    for (var i = 0; i < n; i++) {
+      final o = i * eventSize;
+      _controller.add(SeismicEvent(
+        detectionTimeMs: _events.getInt64(o, Endian.little),
+        peakG: _events.getFloat32(o + 8, Endian.little),
+        staLtaRatio: _events.getFloat32(o + 12, Endian.little),
+        dominantFreq: _events.getFloat32(o + 16, Endian.little),
+        durationSamples: _events.getUint32(o + 20, Endian.little),
+        level: _events.getUint8(o + 24),
+      ));
+      // The UI hop of the latency trace (the EventChannel path marks it in
+      // Kotlin); 0 lets the native side read CLOCK_BOOTTIME.
+      final trace = _events.getUint32(o + 28, Endian.little);
+      if (trace != 0) _traceDelivered(_handle, trace, 0);
+    }
+  }
+
+  /// Telemetry written since the previous poll.
+  List<SeismicTelemetry> pollTelemetry() {
+    if (_closed) return const [];
+    final n = _readTelemetry(_handle);
+    return SeismicTelemetry.listFromBytes(
+        Uint8List.sublistView(_telemetry, 0, n * SeismicTelemetry.recordSize));
+  }
+
+  /// Posts a config in SeismicConfig.kt order; applied before the next
+  /// sensor batch (the sample rate is fixed per detector).
+  void setConfig(List<double> values) {
+    if (_closed) return;
+    final n = values.length < _config.length ? values.length : _config.length;
+    _config.setRange(0, n, values);
+    _commitConfig(_handle, n);
+  }
+
+  SeismicStats get stats {
+    final p = _closed ? nullptr : _stats(_handle);
+    if (p == nullptr) return const SeismicStats();
+    final s = p.ref;
+    return SeismicStats(
+      samples: s.samples,
+      gatedSamples: s.gatedSamples,
+      wakes: s.wakes,
+      events: s.events,
+      eventsDropped: s.eventsDropped,
+      captures: s.captures,
+      capturesDropped: s.capturesDropped,
+      asleep: s.asleep != 0,
+    );
+  }
+
+  /// Detaches the listener and stops using the handle. Safe after the
+  /// native detector is gone: calls on a destroyed handle are no-ops.
+  void close() {
+    if (_closed) return;
+    _closed = true;
+    final l = _listener;
+    if (l != null) {
+      _setListener(_handle, nullptr);
+      l.close();
+      _listener = null;
+    }
+    _controller.close();
+  }
+}
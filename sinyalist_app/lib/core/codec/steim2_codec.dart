@@ -0,0 +1,102 @@
+// =============================================================================
+// SINYALIST — Steim-2 waveform decoder
+// =============================================================================
+// Dart side of steim2.hpp: captured waveforms arrive from the native
+// dispatcher as a Steim-2 waveform image (magic "SWZ1"):
+//   header (24 B, little-endian): magic u32 | samples u32 | counts_per_g f32 |
+//                                 bytes u32 × 3 (x, y, z Steim-2 streams)
+//   then the three streams back to back, each in 64-byte big-endian frames
+//
+// The streams are lossless over the int16 counts the phone quantised to;
+// values decoded back to g are within half a count of the sensor reading.
+// =============================================================================
+
+import 'dart:typed_data';
+
+/// SEED Steim-2 block decoder (first differences, frame 0 holds X0/Xn).
+class Steim2 {
+  static const int frameBytes = 64;
+
+  /// Decodes exactly [n] samples from the stream at [offset]..[offset]+[bytes]
+  /// of [d]. Null if the stream is short, malformed or its last sample does
+  /// not match Xn.
+  static Int32List? decode(ByteData d, int offset, int bytes, int n) {
+    if (n <= 0 || bytes < frameBytes || offset + bytes > d.lengthInBytes) return null;
+    final x0 = d.getInt32(offset + 4, Endian.big);
+    final xn = d.getInt32(offset + 8, Endian.big);
+    final out = Int32List(n);
+    var got = 0;
+    var x = x0;
+
+    void take(int w, int k, int bits) {
+      for (var i = 0; i < k && got < n; i++) {
+        var v = (w >> (bits * (k - 1 - i))) & ((1 << bits) - 1);
+        if (v >= 1 << (bits - 1)) v -= 1 << bits;
+        if (got > 0) x += v; // the first difference is not used
+        out[got++] = x;
+      }
+    }
+
+    for (var f = offset; f + frameBytes <= offset + bytes && got < n; f += frameBytes) {
+      final ctrl = d.getUint32(f, Endian.big);
+      for (var i = 1; i < 16 && got < n; i++) {
+        final w = d.getUint32(f + i * 4, Endian.big);
+        final code = (ctrl >> (2 * (15 - i))) & 3;
+        final dnib = w >> 30;
+        if (code == 0) continue;
+        if (code == 1) {
+          take(w, 4, 8);
+        } else if (code == 2) {
+          if (dnib == 1) {
+            take(w, 1, 30);
+          } else if (dnib == 2) {
+            take(w, 2, 15);
+          } else if (dnib == 3) {
+            take(w, 3, 10);
+          } else {
+            return null;
+          }
+        } else {
+          if (dnib == 0) {
+            take(w, 5, 6);
+          } else if (dnib == 1) {
+            take(w, 6, 5);
+          } else if (dnib == 2) {
+            take(w, 7, 4);
+          } else {
+            return null;
+          }
+        }
+      }
+    }
+    return got == n && x == xn ? out : null;
+  }
+}
+
+/// Three-axis waveform image written by pack_waveform() (steim2.hpp).
+class PackedWaveform {
+  static const int headerSize = 24;
+  static const int magic = 0x315a5753; // "SWZ1"
+
+  /// Interleaved x, y, z in g; null if [image] is not a complete image.
+  static Float32List? unpack(Uint8List image) {
+    if (image.length < headerSize) return null;
+    final d = ByteData.sublistView(image);
+    if (d.getUint32(0, Endian.little) != magic) return null;
+    final n = d.getUint32(4, Endian.little);
+    final countsPerG = d.getFloat32(8, Endian.little);
+    if (n == 0 || !(countsPerG > 0)) return null;
+    final xyz = Float32List(n * 3);
+    var at = headerSize;
+    for (var a = 0; a < 3; a++) {
+      final bytes = d.getUint32(12 + a * 4, Endian.little);
+      final counts = Steim2.decode(d, at, bytes, n);
+      if (counts == null) return null;
+      for (var i = 0; i < n; i++) {
+        xyz[i * 3 + a] = counts[i] / countsPerG;
+      }
+      at += bytes;
+    }
+    return xyz;
+  }
+}
@@ -0,0 +1,70 @@
+// =============================================================================
+// SINYALIST — Seismic Stats / Stage Profile Decoding Unit Tests
+// =============================================================================
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sinyalist/core/bridge/seismic_ffi.dart';
+
+const _counters = [1000, 400, 3, 2, 0, 1, 0, 1];
+
+List<int> _stage(int calls, int sum, int max, Map<int, int> buckets) =>
+    [calls, sum, max, for (var b = 0; b < 24; b++) buckets[b] ?? 0];
+
+void main() {
+  group('SeismicStats.fromWords', () {
+    test('decodes counters without a profile', () {
+      final s = SeismicStats.fromWords([..._counters, 0, 24, 0]);
+      expect(s.samples, equals(1000));
+      expect(s.gatedSamples, equals(400));
+      expect(s.wakes, equals(3));
+      expect(s.events, equals(2));
+      expect(s.captures, equals(1));
+      expect(s.asleep, isTrue);
+      expect(s.stages, isEmpty);
+    });
+
+    test('decodes stage histograms in stage order', () {
+      final s = SeismicStats.fromWords([
+        ..._counters, 2, 24, 38,
+        ..._stage(4, 800, 300, {7: 3, 8: 1}),
+        ..._stage(2, 100, 60, {5: 2}),
+      ]);
+      expect(s.clockOverheadNs, equals(38));
+      expect(s.stages, hasLength(2));
+      expect(s.stages[0].name, equals('sample'));
+      expect(s.stages[1].name, equals('gate'));
+      expect(s.stages[0].meanNs, equals(200.0));
+      expect(s.stages[0].maxNs, equals(300));
+      expect(s.stages[0].quantileNs(0.5), equals(256));
+      expect(s.stages[0].quantileNs(0.99), equals(512));
+    });
+
+    test('decodes latency hops after the profile', () {
+      List<int> hop(int n, int sum, int max, Map<int, int> buckets) =>
+          [n, sum, max, for (var b = 0; b < 32; b++) buckets[b] ?? 0];
+      final s = SeismicStats.fromWords([
+        ..._counters, 0, 24, 0,
+        5, 32,
+        ...hop(2, 9000000, 5000000, {22: 2}),
+        ...hop(2, 40000, 20000, {14: 2}),
+        ...hop(2, 200000, 120000, {16: 1, 17: 1}),
+        ...hop(2, 500000, 300000, {18: 2}),
+        ...hop(1, 8000000, 8000000, {22: 1}),
+      ]);
+      expect(s.stages, isEmpty);
+      expect(s.latency, hasLength(5));
+      expect(s.latency[0].name, equals('sensor_ingest'));
+      expect(s.latency[4].name, equals('callback_ui'));
+      expect(s.latency[2].quantileNs(0.5), equals(131072));
+      expect(s.latency[2].quantileNs(0.99), equals(262144));
+      expect(s.latency[4].calls, equals(1));
+    });
+
+    test('ignores a truncated profile', () {
+      final s = SeismicStats.fromWords([..._counters, 2, 24, 38, ..._stage(1, 10, 10, {})]);
+      expect(s.stages, hasLength(1));
+      expect(s.latency, isEmpty);
+      expect(SeismicStats.fromWords(const [1, 2]).samples, equals(0));
+    });
+  });
+}
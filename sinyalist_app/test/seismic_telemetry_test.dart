@@ -0,0 +1,50 @@
+// =============================================================================
+// SINYALIST — Seismic Telemetry Decoding Unit Tests
+// =============================================================================
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sinyalist/core/bridge/native_bridge.dart';
+
+Uint8List _record(int ts, List<double> f, int state, int reject) {
+  final d = ByteData(SeismicTelemetry.recordSize);
+  d.setInt64(0, ts, Endian.little);
+  for (var i = 0; i < 7; i++) {
+    d.setFloat32(8 + i * 4, f[i], Endian.little);
+  }
+  d.setUint8(36, state);
+  d.setUint8(37, reject);
+  return d.buffer.asUint8List();
+}
+
+void main() {
+  group('SeismicTelemetry', () {
+    test('decodes packed records in order', () {
+      final bytes = Uint8List.fromList([
+        ..._record(1000, [0.5, 0.25, 0.125, 0.0625, 2.0, 0.001, 4.5], 1, 0),
+        ..._record(1200, [1, 1, 1, 1, 1, 1, 1], 2, 3),
+      ]);
+      final list = SeismicTelemetry.listFromBytes(bytes);
+      expect(list.length, equals(2));
+      expect(list[0].timestampMs, equals(1000));
+      expect(list[0].rawMag, equals(0.5));
+      expect(list[0].lta, equals(0.0625));
+      expect(list[0].adaptiveTrigger, equals(4.5));
+      expect(list[0].state, equals(1));
+      expect(list[1].timestampMs, equals(1200));
+      expect(list[1].reject, equals(3));
+    });
+
+    test('ignores a trailing partial record', () {
+      final bytes = Uint8List.fromList([
+        ..._record(1, [0, 0, 0, 0, 0, 0, 0], 0, 0),
+        1, 2, 3,
+      ]);
+      expect(SeismicTelemetry.listFromBytes(bytes).length, equals(1));
+    });
+
+    test('empty input yields no records', () {
+      expect(SeismicTelemetry.listFromBytes(Uint8List(0)), isEmpty);
+    });
+  });
+}
@@ -0,0 +1,101 @@
+// =============================================================================
+// SINYALIST — Seismic Waveform Decoding Unit Tests
+// =============================================================================
+
+import 'dart:typed_data';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:sinyalist/core/bridge/native_bridge.dart';
+
+// pack_waveform() (steim2.hpp) of 10 samples at 2048 counts/g:
+//   x = 0, 0.001, -0.002, 0.5, -1, 0.25, 0.0005, 0, -0.25, 16.5 (saturates)
+//   y = -0.01 * i, z = -1
+const _packedHex =
+    '53575a310a0000000000004540000000400000004000000002aa000000000000'
+    '00007fffc0000bfa8202740085007e01bffffe00400081ff0000000000000000'
+    '00000000000000000000000000000000000000000000000003c0000000000000'
+    'ffffff4800b2bb2b2caecaec0000000000000000000000000000000000000000'
+    '00000000000000000000000000000000000000000000000003800000fffff800'
+    'fffff80080000000c00000000000000000000000000000000000000000000000'
+    '000000000000000000000000000000000000000000000000';
+
+Uint8List _hex(String s) => Uint8List.fromList(
+    List.generate(s.length ~/ 2, (i) => int.parse(s.substring(2 * i, 2 * i + 2), radix: 16)));
+
+Uint8List _packedCapture(Uint8List image) {
+  final d = ByteData(SeismicWaveform.headerSize + image.length);
+  d.setUint32(0, SeismicWaveform.magic, Endian.little);
+  d.setUint32(4, SeismicWaveform.versionPacked, Endian.little);
+  d.setUint32(8, 10, Endian.little);
+  d.setFloat32(32, 50.0, Endian.little);
+  final bytes = d.buffer.asUint8List();
+  bytes.setRange(SeismicWaveform.headerSize, bytes.length, image);
+  return bytes;
+}
+
+Uint8List _capture(List<double> xyz, {int magic = SeismicWaveform.magic}) {
+  final n = xyz.length ~/ 3;
+  final d = ByteData(SeismicWaveform.headerSize + n * 12);
+  d.setUint32(0, magic, Endian.little);
+  d.setUint32(4, 1, Endian.little);
+  d.setUint32(8, n, Endian.little);
+  d.setUint32(12, 1, Endian.little);
+  d.setInt64(16, 10000, Endian.little);
+  d.setInt64(24, 10020, Endian.little);
+  d.setFloat32(32, 50.0, Endian.little);
+  d.setUint8(36, 3);
+  d.setUint8(37, 1);
+  d.setFloat32(40, 0.25, Endian.little);
+  d.setUint32(44, 172, Endian.little);
+  for (var i = 0; i < xyz.length; i++) {
+    d.setFloat32(SeismicWaveform.headerSize + i * 4, xyz[i], Endian.little);
+  }
+  return d.buffer.asUint8List();
+}
+
+void main() {
+  group('SeismicWaveform', () {
+    test('decodes header and interleaved samples', () {
+      final w = SeismicWaveform.fromBytes(_capture([0.5, -0.25, -1.0, 0.125, 0, -1.0]))!;
+      expect(w.samples, equals(2));
+      expect(w.preSamples, equals(1));
+      expect(w.firstMs, equals(10000));
+      expect(w.onsetMs, equals(10020));
+      expect(w.sampleRateHz, equals(50.0));
+      expect(w.level, equals(3));
+      expect(w.complete, isTrue);
+      expect(w.peakG, equals(0.25));
+      expect(w.durationSamples, equals(172));
+      expect(w.xyz[1], equals(-0.25));
+      expect(w.xyz[3], equals(0.125));
+    });
+
+    test('rejects a wrong magic', () {
+      expect(SeismicWaveform.fromBytes(_capture([0, 0, 0], magic: 0)), isNull);
+    });
+
+    test('rejects a truncated capture', () {
+      final bytes = _capture([0, 0, 0, 1, 1, 1]);
+      expect(SeismicWaveform.fromBytes(bytes.sublist(0, bytes.length - 4)), isNull);
+    });
+
+    test('decodes a Steim-2 packed capture to the encoded counts', () {
+      final image = _hex(_packedHex);
+      final w = SeismicWaveform.fromBytes(_packedCapture(image))!;
+      expect(w.samples, equals(10));
+      expect(w.packed, equals(image));
+      const x = [0, 2, -4, 1024, -2048, 512, 1, 0, -512, 32767];
+      for (var i = 0; i < 10; i++) {
+        expect(w.xyz[i * 3], equals(x[i] / 2048));
+        expect(w.xyz[i * 3 + 2], equals(-1.0));
+      }
+      expect(w.xyz[9 * 3 + 1], equals(-184 / 2048));
+    });
+
+    test('rejects a damaged Steim-2 capture', () {
+      final image = _hex(_packedHex);
+      image[24 + 8] ^= 1; // x stream Xn
+      expect(SeismicWaveform.fromBytes(_packedCapture(image)), isNull);
+      expect(SeismicWaveform.fromBytes(_packedCapture(image.sublist(0, 100))), isNull);
+    });
+  });
+}